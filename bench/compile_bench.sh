@@ -0,0 +1,107 @@
+#!/bin/bash
+# Benchmark de tiempo de compilación: genera programas de cada forma y
+# tamaño con gen-tds, los compila con --time-report=json y muestra el
+# throughput de cada etapa y el pico de memoria.
+#
+#   ./bench/compile_bench.sh                 todas las formas, tamaños por defecto
+#   SHAPES="globals exprs" SIZES="1000 8000" OPT=all ./bench/compile_bench.sh
+#
+# La columna 'esc' es el exponente de escalado del tiempo total respecto al
+# tamaño anterior: ~1 es lineal, ~2 cuadrático.
+SHAPES=${SHAPES:-"globals nested exprs methods args mixed"}
+SIZES=${SIZES:-"1000 4000 16000"}
+OPT=${OPT:-}
+OPT_FLAGS=""
+if [ -n "$OPT" ]; then
+    OPT_FLAGS="-opt $OPT"
+fi
+
+COMPILER=./bin/c-tds
+GEN=./bin/gen-tds
+OUT_DIR=resultados/bench
+CSV=$OUT_DIR/compile.csv
+
+# Colores
+GREEN="\033[0;32m"
+RED="\033[0;31m"
+YELLOW="\033[1;33m"
+BLUE="\033[1;34m"
+NC="\033[0m"
+
+for bin in $COMPILER $GEN; do
+    if [ ! -x $bin ]; then
+        echo -e "${RED}Falta $bin (make compile y make bench lo construyen)${NC}"
+        exit 1
+    fi
+done
+mkdir -p $OUT_DIR
+
+# Primer número después de "clave": en el JSON del reporte, que va en una línea
+json_num() {
+    grep -o "\"$2\": {\"wall_ms\": [0-9.]*\|\"$2\": [0-9.]*" <<< "$1" | head -1 | grep -o '[0-9.]*$'
+}
+
+# a / b por 1000 (ms a segundos), o '-' si no hubo tiempo medido
+per_sec() {
+    awk -v n="$1" -v ms="$2" 'BEGIN { if (ms > 0) printf "%.0f", n / ms * 1000; else printf "-" }'
+}
+
+echo "forma,tamano,bytes,tokens,nodos,ir,lineas_asm,lex_ms,parse_ms,gen_code_ms,total_ms,tokens_s,nodos_s,ir_s,max_rss_kb" > $CSV
+
+echo -e "${BLUE}==============================================${NC}"
+echo -e "${BLUE}⏱  Benchmark de compilación${OPT:+ (-opt $OPT)}${NC}"
+echo -e "${BLUE}==============================================${NC}"
+
+failed=0
+for shape in $SHAPES; do
+    echo -e "${YELLOW}--- $shape ---${NC}"
+    printf "  %8s %10s %12s %12s %12s %10s %10s %6s\n" \
+        "tamaño" "tokens" "tokens/s" "nodos/s" "IR/s" "total ms" "RSS KiB" "esc"
+
+    prev_size=""
+    prev_ms=""
+    for size in $SIZES; do
+        src=$OUT_DIR/${shape}_$size.ctds
+        $GEN $shape $size > $src
+
+        json=$($COMPILER -t assembly $OPT_FLAGS --time-report=json -o $OUT_DIR/${shape}_$size.s $src 2>&1 >/dev/null)
+        if [ $? -ne 0 ]; then
+            echo -e "  ${RED}❌ $src no compiló${NC}"
+            failed=$((failed+1))
+            continue
+        fi
+
+        tokens=$(json_num "$json" tokens)
+        nodes=$(json_num "$json" ast_nodes)
+        ir=$(json_num "$json" ir_instructions)
+        lines=$(json_num "$json" asm_lines)
+        lex_ms=$(json_num "$json" yylex)
+        parse_ms=$(json_num "$json" yyparse)
+        gen_ms=$(json_num "$json" gen_code)
+        total_ms=$(json_num "$json" total)
+        rss=$(json_num "$json" max_rss_kb)
+
+        tokens_s=$(per_sec $tokens $lex_ms)
+        nodes_s=$(per_sec $nodes $parse_ms)
+        ir_s=$(per_sec $ir $gen_ms)
+        scale="-"
+        if [ -n "$prev_size" ]; then
+            scale=$(awk -v s0=$prev_size -v s1=$size -v t0=$prev_ms -v t1=$total_ms \
+                'BEGIN { if (t0 > 0 && s1 != s0) printf "%.2f", log(t1 / t0) / log(s1 / s0); else printf "-" }')
+        fi
+        prev_size=$size
+        prev_ms=$total_ms
+
+        printf "  %8s %10s %12s %12s %12s %10s %10s %6s\n" \
+            $size $tokens $tokens_s $nodes_s $ir_s $total_ms $rss $scale
+        echo "$shape,$size,$(wc -c < $src),$tokens,$nodes,$ir,$lines,$lex_ms,$parse_ms,$gen_ms,$total_ms,$tokens_s,$nodes_s,$ir_s,$rss" >> $CSV
+    done
+done
+
+echo -e "${BLUE}==============================================${NC}"
+if [ $failed -eq 0 ]; then
+    echo -e "${GREEN}✅ Resultados en $CSV${NC}"
+else
+    echo -e "${RED}❌ $failed programas no compilaron (resultados en $CSV)${NC}"
+    exit 1
+fi
@@ -0,0 +1,150 @@
+/*
+ * Generador de programas TDS25 sintéticos para medir el compilador.
+ *
+ *   gen-tds <forma> <n> > programa.ctds
+ *
+ * Cada forma hace crecer una dimensión distinta del programa con 'n':
+ *   globals   n variables globales, todas leídas desde main
+ *   nested    n bloques if/while anidados en un método, cada uno con su variable local
+ *   exprs     expresiones encadenadas de n términos en total
+ *   methods   n métodos chicos, cada uno llama al anterior
+ *   args      métodos con n parámetros en total y sus llamadas
+ *   mixed     un poco de cada una (n / 5 de cada forma)
+ * Los programas son válidos: pasan el chequeo semántico y se pueden
+ * ensamblar y ejecutar con el runtime de externs/.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+// Cortes para que ninguna sentencia ni anidamiento pase los límites del compilador
+// ni del programa generado
+#define EXPR_CHUNK   500
+#define ARGS_CHUNK   256
+#define CALL_CHUNK   1000   // profundidad de recursión del programa generado
+
+#define NEST_INDENT  32     // niveles de nested que se indentan; los más profundos quedan alineados
+
+static void gen_header(void) {
+    printf("Program {\n");
+    printf("    void print_int(integer x) extern;\n\n");
+}
+
+/* Globales: se declaran y main las suma todas (cada uso se busca en la tabla) */
+static void gen_globals(int n) {
+    for (int i = 0; i < n; i++) printf("    integer g%d = %d;\n", i, i % 97);
+    printf("\n    integer globals() {\n        integer s = 0;\n");
+    for (int i = 0; i < n; i++) printf("        s = s + g%d;\n", i);
+    printf("        return s;\n    }\n\n");
+}
+
+/* Indentación de cada nivel, acotada para que el archivo no crezca con n² */
+static int nest_pad(int d) {
+    return 8 + 2 * (d < NEST_INDENT ? d : NEST_INDENT);
+}
+
+/* n bloques anidados en un solo método: sin cortes, la pila de scopes tiene que crecer */
+static void gen_nested(int n) {
+    printf("    integer nested(integer x) {\n        integer s = 0;\n");
+    for (int d = 0; d < n; d++) {
+        int pad = nest_pad(d);
+        if (d % 2 == 0)
+            printf("%*sif (x > %d) then {\n", pad, "", d);
+        else
+            printf("%*swhile s < %d {\n", pad, "", d);
+        printf("%*s    integer v%d = x + %d;\n", pad, "", d, d);
+        printf("%*s    s = s + v%d;\n", pad, "", d);
+    }
+    for (int d = n - 1; d >= 0; d--) printf("%*s}\n", nest_pad(d), "");
+    printf("        return s;\n    }\n\n");
+}
+
+/* Cadenas de operaciones; los divisores nunca son cero */
+static void gen_exprs(int n) {
+    static const char *ops[] = { "+", "-", "*", "+", "%", "-", "/" };
+    printf("    integer exprs(integer a, integer b) {\n        integer s = 1;\n");
+    int term = 0;
+    while (term < n) {
+        int len = n - term < EXPR_CHUNK ? n - term : EXPR_CHUNK;
+        printf("        s = s");
+        for (int k = 0; k < len; k++, term++) {
+            const char *op = ops[term % 7];
+            if (op[0] == '%' || op[0] == '/') printf(" %s %d", op, term % 13 + 1);
+            else if (term % 3 == 0) printf(" %s a", op);
+            else if (term % 3 == 1) printf(" %s (b - %d)", op, term % 11);
+            else printf(" %s %d", op, term % 100);
+        }
+        printf(";\n");
+        printf("        if (s > 1000000 || s < -1000000) then { s = s %% 1000; }\n");
+    }
+    printf("        return s;\n    }\n\n");
+}
+
+/* Métodos encadenados: m_i llama a m_{i-1}, en cadenas de CALL_CHUNK métodos */
+static void gen_methods(int n) {
+    for (int i = 0; i < n; i++) {
+        printf("    integer m%d(integer a, integer b) {\n", i);
+        printf("        integer s = a * %d + b;\n", i % 7 + 1);
+        printf("        if (s > %d) then { s = s - b; } else { s = s + %d; }\n", i % 50, i % 5);
+        if (i % CALL_CHUNK) printf("        s = s + m%d(a - 1, b) %% 100;\n", i - 1);
+        printf("        return s;\n    }\n\n");
+    }
+}
+
+/* Métodos de hasta ARGS_CHUNK parámetros (n en total), cada uno con su llamada */
+static void gen_args(int n) {
+    int methods = (n + ARGS_CHUNK - 1) / ARGS_CHUNK;
+    for (int m = 0; m < methods; m++) {
+        int width = (m == methods - 1) ? n - m * ARGS_CHUNK : ARGS_CHUNK;
+        printf("    integer wide%d(", m);
+        for (int i = 0; i < width; i++) printf("%sinteger p%d", i ? ", " : "", i);
+        printf(") {\n        integer s = 0;\n");
+        for (int i = 0; i < width; i++) printf("        s = s + p%d;\n", i);
+        printf("        return s;\n    }\n\n");
+
+        printf("    integer call_wide%d(integer x) {\n        return wide%d(", m, m);
+        for (int i = 0; i < width; i++) printf("%sx + %d", i ? ", " : "", i);
+        printf(");\n    }\n\n");
+    }
+}
+
+static void gen_main(const char *shape, int size) {
+    bool all = strcmp(shape, "mixed") == 0;
+    printf("    void main() {\n        integer r = 0;\n");
+    if (all || strcmp(shape, "globals") == 0) printf("        r = r + globals();\n");
+    if (all || strcmp(shape, "nested") == 0) printf("        r = r + nested(%d);\n", size);
+    if (all || strcmp(shape, "exprs") == 0) printf("        r = r + exprs(3, 20);\n");
+    if (all || strcmp(shape, "methods") == 0) printf("        r = r + m%d(5, 3);\n", size - 1);
+    if (all || strcmp(shape, "args") == 0) {
+        for (int m = 0; m < (size + ARGS_CHUNK - 1) / ARGS_CHUNK; m++)
+            printf("        r = r + call_wide%d(1);\n", m);
+    }
+    printf("        print_int(r);\n        return;\n    }\n}\n");
+}
+
+int main(int argc, char **argv) {
+    static const char *shapes[] = { "globals", "nested", "exprs", "methods", "args", "mixed", NULL };
+    int valid = 0;
+    if (argc == 3) {
+        for (int i = 0; shapes[i]; i++) valid |= strcmp(argv[1], shapes[i]) == 0;
+    }
+    if (!valid) {
+        fprintf(stderr, "Uso: gen-tds <globals|nested|exprs|methods|args|mixed> <n>\n");
+        return 1;
+    }
+    const char *shape = argv[1];
+    int n = atoi(argv[2]);
+    if (n < 1) n = 1;
+    bool all = strcmp(shape, "mixed") == 0;
+    int part = all ? (n / 5 > 0 ? n / 5 : 1) : n;
+
+    gen_header();
+    if (all || strcmp(shape, "globals") == 0) gen_globals(part);
+    if (all || strcmp(shape, "nested") == 0) gen_nested(part);
+    if (all || strcmp(shape, "exprs") == 0) gen_exprs(part);
+    if (all || strcmp(shape, "methods") == 0) gen_methods(part);
+    if (all || strcmp(shape, "args") == 0) gen_args(part);
+    gen_main(shape, part);
+    return 0;
+}
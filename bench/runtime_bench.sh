@@ -0,0 +1,110 @@
+#!/bin/bash
+# Benchmark del código generado: compila cada kernel de bench/kernels con
+# cada nivel de optimización, lo ensambla con gcc junto a
+# externs/bench_runtime.c y lo corre REPS veces. Muestra el mejor tiempo,
+# los ciclos y las instrucciones retiradas (si perf_event_open está
+# disponible) y el tamaño de .text del kernel.
+#
+#   ./bench/runtime_bench.sh
+#   KERNELS="fib gcd" LEVELS="none fold,dce all" REPS=5 ./bench/runtime_bench.sh
+#
+# 'none' compila sin -opt. Todos los niveles tienen que imprimir lo mismo
+# que el primero; si no, el kernel cuenta como fallido.
+KERNELS=${KERNELS:-"fib loops gcd primes calls"}
+LEVELS=${LEVELS:-"none regalloc all"}
+REPS=${REPS:-3}
+
+COMPILER=./bin/c-tds
+RUNTIME=externs/bench_runtime.c
+OUT_DIR=resultados/bench/runtime
+CSV=resultados/bench/runtime.csv
+
+# Entrada de cada kernel (la lee get_int de TDS_INPUT)
+declare -A INPUT=([fib]=32 [loops]=200000 [gcd]=700 [primes]=300000 [calls]=20000)
+
+# Colores
+GREEN="\033[0;32m"
+RED="\033[0;31m"
+YELLOW="\033[1;33m"
+BLUE="\033[1;34m"
+NC="\033[0m"
+
+if [ ! -x $COMPILER ]; then
+    echo -e "${RED}Falta $COMPILER (make compile)${NC}"
+    exit 1
+fi
+mkdir -p $OUT_DIR
+
+# Valor de 'clave=' en la línea que escribe el runtime al salir
+field() {
+    grep -o "$2=[-0-9]*" <<< "$1" | cut -d= -f2
+}
+
+echo "kernel,nivel,entrada,wall_ns,cycles,instructions,text_bytes" > $CSV
+
+echo -e "${BLUE}==============================================${NC}"
+echo -e "${BLUE}🏁 Benchmark del código generado (${REPS} corridas, la mejor)${NC}"
+echo -e "${BLUE}==============================================${NC}"
+
+failed=0
+for kernel in $KERNELS; do
+    src=bench/kernels/$kernel.ctds
+    input=${INPUT[$kernel]:-10}
+    echo -e "${YELLOW}--- $kernel (entrada $input) ---${NC}"
+    printf "  %-20s %10s %14s %14s %6s %8s %8s\n" \
+        "nivel" "ms" "ciclos" "instrucciones" "IPC" ".text" "speedup"
+
+    expected=""
+    base_ns=""
+    for level in $LEVELS; do
+        name=${kernel}_${level//,/-}
+        opt_flags=""
+        if [ "$level" != "none" ]; then
+            opt_flags="-opt $level"
+        fi
+
+        if ! $COMPILER -t assembly $opt_flags -o $OUT_DIR/$name.s $src > $OUT_DIR/$name.log 2>&1 \
+            || ! gcc -c -o $OUT_DIR/$name.o $OUT_DIR/$name.s 2>> $OUT_DIR/$name.log \
+            || ! gcc -no-pie -O2 -o $OUT_DIR/$name $OUT_DIR/$name.o $RUNTIME 2>> $OUT_DIR/$name.log; then
+            echo -e "  ${RED}❌ $level: no compiló (ver $OUT_DIR/$name.log)${NC}"
+            failed=$((failed+1))
+            continue
+        fi
+        text=$(size -A $OUT_DIR/$name.o | awk '$1 == ".text" { print $2 }')
+
+        best=""
+        for ((r = 0; r < REPS; r++)); do
+            stats=$(TDS_INPUT=$input $OUT_DIR/$name 2>&1 >$OUT_DIR/$name.out)
+            wall=$(field "$stats" wall_ns)
+            if [ -z "$best" ] || [ "$wall" -lt "$(field "$best" wall_ns)" ]; then
+                best=$stats
+            fi
+        done
+        output=$(cat $OUT_DIR/$name.out)
+        if [ -z "$expected" ]; then
+            expected=$output
+        elif [ "$output" != "$expected" ]; then
+            echo -e "  ${RED}❌ $level: imprimió '$output', se esperaba '$expected'${NC}"
+            failed=$((failed+1))
+            continue
+        fi
+
+        wall=$(field "$best" wall_ns)
+        cycles=$(field "$best" cycles)
+        instructions=$(field "$best" instructions)
+        [ -z "$base_ns" ] && base_ns=$wall
+        awk -v level=$level -v w=$wall -v c=$cycles -v i=$instructions -v t=$text -v b=$base_ns 'BEGIN {
+            ipc = (c > 0 && i >= 0) ? sprintf("%.2f", i / c) : "-"
+            printf "  %-20s %10.3f %14s %14s %6s %8s %7.2fx\n", level, w / 1e6,
+                   (c >= 0 ? c : "-"), (i >= 0 ? i : "-"), ipc, t, b / w }'
+        echo "$kernel,$level,$input,$wall,$cycles,$instructions,$text" >> $CSV
+    done
+done
+
+echo -e "${BLUE}==============================================${NC}"
+if [ $failed -eq 0 ]; then
+    echo -e "${GREEN}✅ Resultados en $CSV${NC}"
+else
+    echo -e "${RED}❌ $failed combinaciones fallaron (resultados en $CSV)${NC}"
+    exit 1
+fi
@@ -0,0 +1,84 @@
+/*
+ * Runtime con medición para los kernels de bench/kernels.
+ *
+ * Define print_int y get_int como get_int.c, pero get_int devuelve el valor
+ * de la variable de entorno TDS_INPUT (así el compilador no puede plegar el
+ * tamaño del problema) y el programa se mide desde que arranca main hasta
+ * que termina: tiempo de pared y, si perf_event_open está disponible, ciclos
+ * e instrucciones retiradas en modo usuario. Al salir escribe en stderr:
+ *
+ *   bench wall_ns=123456 cycles=98765 instructions=43210
+ *
+ * Sin perf_event_open (kernel sin soporte, contenedor, perf_event_paranoid
+ * alto) los contadores salen como -1.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+static struct timespec start;
+static int cycles_fd = -1;
+static int instructions_fd = -1;
+
+#ifdef __linux__
+static int open_counter(uint64_t config, int group) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = group == -1;    // el líder arranca apagado y prende a todo el grupo
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+}
+#endif
+
+static long long read_counter(int fd) {
+    long long value;
+    if (fd < 0 || read(fd, &value, sizeof(value)) != sizeof(value)) return -1;
+    return value;
+}
+
+__attribute__((constructor))
+static void bench_start(void) {
+#ifdef __linux__
+    cycles_fd = open_counter(PERF_COUNT_HW_CPU_CYCLES, -1);
+    if (cycles_fd >= 0) {
+        instructions_fd = open_counter(PERF_COUNT_HW_INSTRUCTIONS, cycles_fd);
+        ioctl(cycles_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(cycles_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+    clock_gettime(CLOCK_MONOTONIC, &start);
+}
+
+__attribute__((destructor))
+static void bench_stop(void) {
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+#ifdef __linux__
+    if (cycles_fd >= 0) ioctl(cycles_fd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    long long wall_ns = (end.tv_sec - start.tv_sec) * 1000000000LL + (end.tv_nsec - start.tv_nsec);
+    fprintf(stderr, "bench wall_ns=%lld cycles=%lld instructions=%lld\n",
+            wall_ns, read_counter(cycles_fd), read_counter(instructions_fd));
+}
+
+int get_int() {
+    const char *input = getenv("TDS_INPUT");
+    return input ? atoi(input) : 4;
+}
+
+void print_int(int x) {
+    printf("result %d\n", x);
+}
@@ -0,0 +1,19 @@
+/*
+ * Runtime de los tests con salida esperada (scriptTest.sh).
+ *
+ * print_int y get_int se comportan como los internos de -t run, -t vm y
+ * -t jit (src/interpreter/runtime.c): el valor y un salto de línea, y un
+ * entero leído de la entrada estándar (0 si no hay). Así un mismo .expected
+ * sirve para el ejecutable de -t assembly / -t object y para los targets
+ * que ejecutan el programa dentro del compilador.
+ */
+#include <stdio.h>
+
+int get_int() {
+    int value;
+    return scanf("%d", &value) == 1 ? value : 0;
+}
+
+void print_int(int x) {
+    printf("%d\n", x);
+}
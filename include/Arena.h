@@ -0,0 +1,44 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+/*
+ * Arena de la compilación: los nodos del AST y los símbolos se piden con un
+ * bump allocator en bloques grandes y se liberan todos juntos con
+ * arena_destroy() al terminar el archivo.
+ * Cada tipo de objeto tiene su propia sub-arena para poder medirlos por
+ * separado (con -d se imprimen las estadísticas).
+ *
+ * Cada compilación tiene su propia arena (CompilerContext) y la asocia a su
+ * hilo con arena_bind; ARENA_NEW y arena_strdup piden memoria a la arena
+ * asociada al hilo actual, o a la del proceso si no hay ninguna.
+ */
+typedef enum {
+    ARENA_AST,          // nodos Tree
+    ARENA_SYMBOLS,      // símbolos del programa fuente (declaraciones, llamadas, literales)
+    ARENA_KINDS
+} ArenaKind;
+
+typedef struct Arena Arena;
+
+Arena *arena_create(void);
+/* Libera todos los bloques de todas las sub-arenas */
+void arena_destroy(Arena *arena);
+/* La arena que usa el hilo actual pasa a ser 'arena' (NULL: la del proceso); devuelve la anterior */
+Arena *arena_bind(Arena *arena);
+
+/* Memoria en cero, alineada para cualquier tipo; vive hasta arena_destroy() */
+void *arena_alloc(ArenaKind kind, size_t size);
+char *arena_strdup(ArenaKind kind, const char *s);
+
+#define ARENA_NEW(kind, T) ((T *)arena_alloc((kind), sizeof(T)))
+
+/* Objetos pedidos a la sub-arena 'kind' de la arena del hilo actual */
+size_t arena_objects(ArenaKind kind);
+
+/* Estadísticas de la arena del hilo actual */
+void arena_print_stats(FILE *out);
+
+#endif /* ARENA_H */
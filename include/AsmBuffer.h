@@ -0,0 +1,69 @@
+#ifndef ASMBUFFER_H
+#define ASMBUFFER_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "OutBuffer.h"
+
+/*
+ * Buffer en memoria del assembly generado, una entrada por línea.
+ * Las instrucciones se guardan separadas en mnemónico y operandos para que
+ * el optimizador peephole pueda reconocer y reescribir patrones antes de
+ * escribir la salida.
+ *
+ * El texto de las líneas se copia en bloques grandes del propio buffer
+ * (AsmChunk), no en un malloc por campo: se libera todo junto en asm_free.
+ */
+
+typedef enum {
+    ASM_INSTR,      // instrucción: op [src][, dst]
+    ASM_LABEL,      // "nombre:"
+    ASM_TEXT        // comentarios, directivas y líneas en blanco (se copian tal cual)
+} AsmKind;
+
+typedef struct {
+    AsmKind kind;
+    const char *text;   // ASM_TEXT: la línea; ASM_LABEL: nombre sin ':'
+    const char *op;     // mnemónico (solo ASM_INSTR)
+    const char *src;    // primer operando, o NULL
+    const char *dst;    // segundo operando, o NULL
+    bool deleted;
+} AsmLine;
+
+typedef struct AsmChunk AsmChunk;
+
+typedef struct {
+    AsmLine *lines;
+    int size;
+    int capacity;
+    AsmChunk *chunks;   // texto de las líneas
+    char *partial;      // texto emitido que todavía no terminó en '\n'
+} AsmBuffer;
+
+void asm_init(AsmBuffer *buf);
+void asm_free(AsmBuffer *buf);
+
+/* Como printf: el texto puede tener varias líneas o una línea incompleta */
+void asm_emit(AsmBuffer *buf, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+/*
+ * Instrucción ya separada, sin formatear ni volver a partir el texto.
+ * 'op' se guarda sin copiar (un literal o algo que viva tanto como el
+ * buffer); src y dst se copian y pueden ser NULL.
+ */
+void asm_instr(AsmBuffer *buf, const char *op, const char *src, const char *dst);
+/* Etiqueta "name:" */
+void asm_label(AsmBuffer *buf, const char *name);
+
+/* Reemplaza un operando (o el mnemónico) de una instrucción; copia el texto */
+void asm_set_operand(AsmBuffer *buf, const char **operand, const char *text);
+
+/* Cantidad de instrucciones vivas */
+int asm_instruction_count(AsmBuffer *buf);
+/* Cantidad de líneas vivas (instrucciones, etiquetas, directivas y comentarios) */
+int asm_line_count(AsmBuffer *buf);
+
+/* Vuelca las líneas vivas como texto al final de 'out' */
+void asm_write(AsmBuffer *buf, OutBuffer *out);
+
+#endif /* ASMBUFFER_H */
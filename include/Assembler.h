@@ -4,6 +4,7 @@
 #include "Tree.h"
 #include "Symbol.h"
 #include "Intermediate.h"
+#include "Units.h"
 #include "Globals.h"
 
 /**
@@ -23,35 +24,46 @@ void mark_globals(Tree *node);
 void assign_block_locals(Tree *node, int *offset);
 
 /**
- * Genera el código assembly completo a partir del AST.
+ * Traduce las instrucciones de una unidad (Units.h) al buffer ctx->asm_out
+ * de su contexto y le aplica las reglas PEEP_* (Peephole.h) seleccionadas.
  */
-void generateAssembly(IRList *list);
-
-// Nombres de registros para los primeros 6 parámetros
-static const char* PARAM_REGISTERS[] = {
-    "%rdi",  // Parámetro 1
-    "%rsi",  // Parámetro 2
-    "%rdx",  // Parámetro 3
-    "%rcx",  // Parámetro 4
-    "%r8",   // Parámetro 5
-    "%r9"    // Parámetro 6
-};
+void generateUnitAssembly(CompilerContext *ctx, IRList *list, unsigned peephole_rules);
+
+/**
+ * Como generateUnitAssembly, pero codifica las instrucciones (X86.h) en
+ * ctx->mc_out. Sin peephole: sus reglas reescriben el texto.
+ */
+void generateUnitMachineCode(CompilerContext *ctx, IRList *list);
+
+/**
+ * Escribe en 'out' (el archivo de -o), con un único fwrite, las secciones
+ * de las globales y el assembly de cada unidad en el orden del fuente.
+ * Devuelve 0 si pudo escribir la salida.
+ */
+int generateAssembly(CompilerContext *ctx, IRUnits *units, FILE *out);
+
+// Registros de los primeros 6 parámetros (definidos en Assembler.c)
+#define PARAM_REGISTER_COUNT 6
+extern const char *const PARAM_REGISTERS[PARAM_REGISTER_COUNT];
 
 // Prototipos de helpers
-void collect_globals(IRList *irlist);
-void print_global_sections(SymbolNode *decl_vars);
-void generateLoad(IRCode *inst);
-void generateStorage(IRCode *inst);
-void generateUminus(IRCode *inst);
-void generateCall(IRCode *inst);
-void generateCompare(IRCode *inst, const char *set_op);
-void generateLogicalOp(IRCode *inst, const char *op);
-void generateEnter(IRCode *inst);
-void generateInstruction(IRCode *inst, Symbol *current_method);
-void generateBinaryOp(IRCode *inst, const char *op);
-void generateAssign(IRCode *inst);
-void generateLabel(IRCode *inst);
-void generateGoto(IRCode *inst);
-void generateReturn(IRCode *inst, Symbol *current_method);
+void collect_globals(CompilerContext *ctx, IRList *irlist);
+void print_global_sections(SymbolNode *decl_vars, OutBuffer *out);
+void generateLoad(CompilerContext *ctx, IRCode *inst);
+void generateStorage(CompilerContext *ctx, IRCode *inst);
+void generateUminus(CompilerContext *ctx, IRCode *inst);
+void generateCall(CompilerContext *ctx, IRCode *inst);
+void generateCompare(CompilerContext *ctx, IRCode *inst, const char *set_op);
+void generateLogicalOp(CompilerContext *ctx, IRCode *inst, const char *op);
+void generateEnter(CompilerContext *ctx, IRCode *inst);
+void generateInstruction(CompilerContext *ctx, IRCode *inst, Symbol *current_method);
+void generateBinaryOp(CompilerContext *ctx, IRCode *inst, const char *op);
+void generateAssign(CompilerContext *ctx, IRCode *inst);
+void generateLabel(CompilerContext *ctx, IRCode *inst);
+void generateGoto(CompilerContext *ctx, IRCode *inst);
+void generateCondJump(CompilerContext *ctx, IRCode *inst, const char *jump_op);
+void generateReturn(CompilerContext *ctx, IRCode *inst, Symbol *current_method);
+void generateParam(CompilerContext *ctx, IRCode *inst);
+void generateSaveParam(CompilerContext *ctx, IRCode *inst);
 
 #endif // ASSEMBLER_H
\ No newline at end of file
@@ -0,0 +1,15 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "Args.h"
+
+/*
+ * Modo batch (varios archivos o -j N): cada archivo se compila en su propio
+ * CompilerContext como una tarea del pool de hilos y se escribe en su .s
+ * (a.ctds -> a.s). Los diagnósticos de cada archivo se juntan en memoria y
+ * se imprimen al final en el orden de la línea de comandos.
+ * Devuelve el código de error más alto entre los archivos (0 si todos compilaron).
+ */
+int run_batch(Config *cfg);
+
+#endif /* BATCH_H */
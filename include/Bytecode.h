@@ -0,0 +1,113 @@
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "Intermediate.h"
+
+/*
+ * Bytecode de registros para -t vm: el código intermedio (ya optimizado si
+ * se pidió -opt) traducido a instrucciones de ancho fijo que lee vm.c.
+ *
+ * Cada método tiene un marco de slots de 64 bits: primero los parámetros
+ * (en orden), después las locales y los temporales, y al final unos slots
+ * de paso para operar con globales. Los operandos de las instrucciones son
+ * índices de slot del marco actual; las globales solo se leen y escriben con
+ * BC_LOADG y BC_STOREG. Los inmediatos y los destinos de los saltos (índice
+ * de instrucción) van en la misma instrucción.
+ *
+ *   BC_MOV a, b          a = b
+ *   BC_LOADI a, imm      a = imm                 (el inmediato va en b)
+ *   BC_ADD a, b, c       a = b + c               (igual SUB, MUL, DIV, MOD, AND, OR y EQ..GE)
+ *   BC_JEQ a, b, L       salta a L si a == b     (igual JNE..JGE)
+ *   BC_JNOT a, L         salta a L si a != 1
+ *   BC_CALL a, f, n      a = f(...) con n argumentos; los slots de los
+ *                        argumentos van en las instrucciones BC_ARGS que
+ *                        siguen, tres por instrucción
+ *   BC_CALLX a, e, n     igual, pero llama al externo e (se resuelve como
+ *                        dice Runtime.h)
+ *
+ * Un programa se puede guardar en disco (bc_save) y volver a cargar
+ * (bc_load) sin pasar por el parser: el archivo lleva un hash del fuente y
+ * de las optimizaciones, y si no coinciden no se usa.
+ */
+typedef enum {
+    BC_NOP,
+    BC_MOV,
+    BC_LOADI,
+    BC_LOADG,       // a = globals[b]
+    BC_STOREG,      // globals[a] = b
+    BC_ADD,
+    BC_SUB,
+    BC_MUL,
+    BC_DIV,
+    BC_MOD,
+    BC_NEG,         // a = -b
+    BC_NOT,         // a = b ^ 1
+    BC_AND,
+    BC_OR,
+    BC_EQ,
+    BC_NEQ,
+    BC_LT,
+    BC_LE,
+    BC_GT,
+    BC_GE,
+    BC_JMP,         // salta a a
+    BC_JNOT,
+    BC_JEQ,
+    BC_JNE,
+    BC_JLT,
+    BC_JLE,
+    BC_JGT,
+    BC_JGE,
+    BC_CALL,
+    BC_CALLX,
+    BC_ARGS,        // slots de argumentos de la llamada anterior (no se ejecuta)
+    BC_RET,         // devuelve el slot a, o 0 si a < 0
+    BC_OP_COUNT
+} BcOp;
+
+typedef struct {
+    int32_t op;
+    int32_t a, b, c;
+} BcInstr;
+
+typedef struct {
+    char *name;
+    int32_t entry;          // índice de su primera instrucción
+    int32_t frame_size;     // slots del marco
+    int32_t param_count;
+} BcFunction;
+
+typedef struct {
+    BcInstr *code;
+    int code_size;
+    BcFunction *functions;
+    int function_count;
+    int main_function;      // -1 si no hay main
+    long *globals;          // valores iniciales
+    int global_count;
+    char **externs;         // nombres de los métodos externos
+    int extern_count;
+} BcProgram;
+
+/* Traduce el código intermedio de un archivo (con offsets calculados) */
+void bc_compile(CompilerContext *ctx, IRList *list, BcProgram *prog);
+void bc_free(BcProgram *prog);
+/* Imprime el bytecode (con -debug) */
+void bc_print(const BcProgram *prog, FILE *out);
+
+/* Hash del fuente y de lo que cambia el bytecode (las optimizaciones) */
+uint64_t bc_source_hash(const char *source, size_t size, const char *optimization);
+/* Escribe el programa en 'path' (por un temporal y rename); false si falla */
+bool bc_save(const BcProgram *prog, uint64_t hash, const char *path);
+/* Carga 'path' si existe y es de este formato y de este hash */
+bool bc_load(BcProgram *prog, uint64_t hash, const char *path);
+
+/**
+ * Ejecuta main. Devuelve el código de salida, con las mismas reglas que
+ * interpret (Interpreter.h); los errores de ejecución van a 'err'.
+ */
+int vm_run(const BcProgram *prog, FILE *err);
+
+#endif /* BYTECODE_H */
@@ -0,0 +1,72 @@
+#ifndef CFG_H
+#define CFG_H
+
+#include <stdint.h>
+#include "Intermediate.h"
+
+/*
+ * Grafo de flujo de control de un método (IR_METHOD .. IR_FMETHOD).
+ *
+ * Un bloque básico empieza en la primera instrucción del método, en cada
+ * IR_LABEL y después de cada IR_GOTO o IR_RETURN. Los bloques se numeran en
+ * el orden en que aparecen en la lista; el 0 es la entrada. Sobre el grafo
+ * se calculan el árbol de dominadores y el anidamiento de los lazos.
+ */
+
+typedef uint64_t *Bitset;
+
+#define BITSET_WORDS(n)      (((n) + 63) / 64)
+#define BITSET_TEST(b, i)    (((b)[(i) >> 6] >> ((i) & 63)) & 1)
+#define BITSET_SET(b, i)     ((b)[(i) >> 6] |= (uint64_t)1 << ((i) & 63))
+#define BITSET_CLEAR(b, i)   ((b)[(i) >> 6] &= ~((uint64_t)1 << ((i) & 63)))
+
+typedef struct {
+    int first, last;        // rango de instrucciones del bloque (inclusive)
+    int succ[2];            // sucesores (-1 si no hay); succ[1] es la caída de un salto condicional
+    int *preds;             // predecesores
+    int npreds;
+
+    int rpo;                // posición en reverse postorder, -1 si es inalcanzable
+    int idom;               // dominador inmediato (-1 en la entrada y en los inalcanzables)
+    int dom_child;          // primer hijo en el árbol de dominadores, o -1
+    int dom_sibling;        // siguiente hermano en el árbol de dominadores, o -1
+    int dom_pre, dom_post;  // numeración del árbol para responder cfg_dominates en O(1)
+
+    int loop;               // lazo más interno que lo contiene (índice en loops), o -1
+    int loop_depth;         // 0 fuera de todo lazo
+} BasicBlock;
+
+typedef struct {
+    int header;             // bloque cabecera (domina a todo el cuerpo)
+    int parent;             // lazo que lo contiene, o -1
+    int depth;              // 1 para los lazos más externos
+    int size;               // cantidad de bloques del cuerpo
+} CFGLoop;
+
+typedef struct {
+    IRList *list;
+    int start, end;
+    int nblocks;
+    BasicBlock *blocks;
+    int *block_of;          // instrucción (relativa a start) -> bloque
+    int *order;             // bloques alcanzables en reverse postorder
+    int nreachable;
+    int nloops;
+    CFGLoop *loops;
+} CFG;
+
+CFG *cfg_build(IRList *list, int start, int end);
+void cfg_free(CFG *cfg);
+
+#define CFG_REACHABLE(cfg, b) ((cfg)->blocks[b].rpo >= 0)
+
+/* Bloque que contiene la instrucción i (índice absoluto en la lista) */
+int cfg_block_of(CFG *cfg, int i);
+
+/* true si el bloque a domina al bloque b (todo bloque se domina a sí mismo) */
+bool cfg_dominates(CFG *cfg, int a, int b);
+
+/* Índice de la instrucción IR_FMETHOD que cierra el método que empieza en start */
+int ir_method_end(IRList *list, int start);
+
+#endif /* CFG_H */
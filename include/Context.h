@@ -0,0 +1,131 @@
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#include <stdio.h>
+#include "Stack.h"
+#include "Tree.h"
+#include "Globals.h"
+#include "AsmBuffer.h"
+#include "X86.h"
+#include "Arena.h"
+#include "Intern.h"
+#include "ThreadPool.h"
+#include "TimeReport.h"
+
+/*
+ * Operando del código intermedio (Intermediate.h): un tag y un entero,
+ * guardados dentro de la instrucción.
+ *   IRO_TEMP    temporal número 'id' (newTemp)
+ *   IRO_LOCAL   parámetro o variable local: 'id' en ctx->ir_locals
+ *   IRO_GLOBAL  variable global: 'id' en ctx->ir_globals
+ *   IRO_METHOD  método (CALL, METHOD, FMETHOD, METH_EXT): 'id' en ctx->ir_methods
+ *   IRO_IMM     constante: 'id' es el valor
+ *   IRO_LABEL   etiqueta número 'id'; 'unit' es la unidad que la creó (Units.h)
+ */
+typedef enum {
+    IRO_NONE,
+    IRO_TEMP,
+    IRO_LOCAL,
+    IRO_GLOBAL,
+    IRO_METHOD,
+    IRO_IMM,
+    IRO_LABEL
+} IROperandKind;
+
+typedef struct {
+    unsigned kind : 4;      // IROperandKind
+    unsigned unit : 28;     // solo IRO_LABEL (0: la creó gen_code)
+    int id;
+} IROperand;
+
+/* Símbolos a los que se refieren los operandos del IR, por id */
+typedef struct {
+    Symbol **items;
+    int count;
+    int capacity;
+} IRSymbols;
+
+/* Lo que deciden regalloc y offset_temps para un temporal o una variable local */
+typedef struct {
+    const char *reg;        // registro asignado, o NULL si vive en su slot de la pila
+    int offset;             // temporales: slot relativo a %rbp (0: sin asignar); las variables usan el de su Symbol
+} IRValueInfo;
+
+/* IRValueInfo por id, desde 'base'; crece a demanda (ir_value_info) */
+typedef struct {
+    IRValueInfo *items;
+    int base;
+    int size;
+} IRValueTable;
+
+/* Argumento de una llamada pendiente (IR_PARAM ya visto, IR_CALL todavía no) */
+typedef struct PendingParam {
+    IROperand value;
+    int index;
+} PendingParam;
+
+/*
+ * Estado de la compilación de un archivo fuente. Todo lo que usan el lexer,
+ * el parser, los chequeos semánticos, el código intermedio y el backend vive
+ * acá en lugar de en variables globales, así un mismo proceso puede compilar
+ * varios archivos: cada uno con su propio contexto.
+ *
+ * La memoria del archivo (Arena.h) y sus nombres internados (Intern.h)
+ * también son del contexto: el hilo que lo compila los asocia con
+ * context_bind. Lo único del proceso son los pases elegidos con -opt.
+ *
+ * Los métodos de un archivo se optimizan y se traducen por separado, cada
+ * uno con una copia de este contexto (Units.h).
+ */
+typedef struct CompilerContext {
+    const char *input_file;
+    void *scanner;              // yyscan_t del lexer reentrante
+    FILE *err;                  // diagnósticos (stderr, o un buffer en modo batch)
+    Arena *arena;
+    InternTable *names;
+    ThreadPool *pool;           // donde se compilan los métodos (Units.h); NULL: en orden, en este hilo
+    int pool_threads;           // sin pool, units_run puede crear uno de hasta tantos hilos (< 2: nunca)
+    int unit;                   // > 0: copia del contexto para una unidad; va en las etiquetas que crea
+    TimeReport *report;         // --time-report; NULL si no se pidió
+
+    // Parser y chequeo semántico
+    Tree *ast_root;
+    int had_error;              // error sintáctico
+    int semantic_error;
+    int main_decl;              // se encontró el método main
+    ScopeStack scopes;
+    TypeStack types;            // tipo de retorno del método que se está chequeando
+
+    // Código intermedio
+    int temp_count;             // en una unidad sigue desde su último temporal (Units.h)
+    int label_count;
+    IRSymbols ir_locals;        // los del archivo: las unidades los comparten y no agregan
+    IRSymbols ir_globals;
+    IRSymbols ir_methods;
+    IRValueTable temps;         // de la unidad: registro y slot de cada temporal
+    IRValueTable locals;        // de la unidad: registro de cada variable local
+
+    // Backend
+    SymbolNode *decl_vars;      // globales para .data/.bss
+    AsmBuffer asm_out;
+    X86Code mc_out;             // -t jit: código máquina en lugar de asm_out
+    PendingParam *pending_params;
+    int pending_count;
+    int pending_capacity;
+    int div_label_count;
+} CompilerContext;
+
+/* Prepara el contexto y un lexer que lee de 'in' (no lo cierra); los diagnósticos van a 'err' */
+int context_init(CompilerContext *ctx, const char *input_file, FILE *in, FILE *err);
+void context_free(CompilerContext *ctx);
+/* El hilo actual pasa a usar la arena y los nombres de 'ctx' (NULL: los del proceso); devuelve el anterior */
+CompilerContext *context_bind(CompilerContext *ctx);
+
+/* Lexer reentrante generado por flex (%option reentrant bison-bridge) */
+int yylex_init_extra(struct CompilerContext *ctx, void **scanner);
+int yylex_destroy(void *scanner);
+void yyset_in(FILE *in, void *scanner);
+char *yyget_text(void *scanner);
+int yyget_lineno(void *scanner);
+
+#endif /* CONTEXT_H */
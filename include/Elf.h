@@ -0,0 +1,22 @@
+#ifndef ELF_WRITER_H
+#define ELF_WRITER_H
+
+#include <stdio.h>
+#include "Context.h"
+#include "X86.h"
+
+/*
+ * -t object: el mismo código máquina que usa -t jit, escrito como un objeto
+ * ELF64 reubicable (.o) que se enlaza con gcc sin pasar por el assembler.
+ *
+ * Secciones: .text, .data (globales con valor inicial), .bss (globales en
+ * cero), .symtab, .strtab y .rela.text. main es el único símbolo global
+ * definido; los externos y el 'exit' de la división por cero quedan sin
+ * definir, para el linker. Las llamadas entre métodos del archivo ya se
+ * resuelven acá.
+ */
+
+/* Escribe el .o en 'out'; devuelve 0 si pudo */
+int elf_write_object(CompilerContext *ctx, const X86Code *text, FILE *out);
+
+#endif /* ELF_WRITER_H */
@@ -4,11 +4,10 @@
 
 #include <stdarg.h>
 
-extern int semantic_error;
+struct CompilerContext;
 
-extern int yylineno;         // declarada en Bison
-extern char *yytext;         // declarada en Flex
-
-void yyerrorf(int lineno, const char *fmt, ...);
-void yyerror(const char *s);
+/* Error semántico en 'lineno': lo informa y lo marca en el contexto */
+void yyerrorf(struct CompilerContext *ctx, int lineno, const char *fmt, ...);
+/* Error sintáctico (lo llama el parser con sus %parse-param) */
+void yyerror(void *scanner, struct CompilerContext *ctx, const char *s);
 #endif
@@ -0,0 +1,26 @@
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <stddef.h>
+
+/*
+ * Pool de strings internados: cada texto distinto se guarda una sola vez,
+ * así que dos nombres internados son iguales si y solo si son el mismo
+ * puntero. Las tablas de símbolos usan el puntero como clave.
+ *
+ * Cada compilación tiene su propia tabla (CompilerContext) y la asocia a su
+ * hilo con intern_bind; sin asociar se usa la tabla del proceso. Los strings
+ * viven hasta intern_destroy: no se modifican ni se liberan antes.
+ */
+typedef struct InternTable InternTable;
+
+InternTable *intern_create(void);
+void intern_destroy(InternTable *table);
+/* La tabla que usa el hilo actual pasa a ser 'table' (NULL: la del proceso); devuelve la anterior */
+InternTable *intern_bind(InternTable *table);
+
+/* Versión internada de s (la agrega al pool si no estaba) */
+char *intern(const char *s);
+char *intern_n(const char *s, size_t len);
+
+#endif /* INTERN_H */
@@ -0,0 +1,23 @@
+#ifndef INTERPRETER_H
+#define INTERPRETER_H
+
+#include "Context.h"
+
+/*
+ * Intérprete del AST para -t run: ejecuta el programa ya chequeado sin pasar
+ * por el assembly, gcc y el linker.
+ *
+ * Los enteros son de 64 bits, como en el código generado. Cada llamada tiene
+ * su marco con un slot por parámetro y por local, en el orden que les dio
+ * calculate_offsets. Los métodos externos se resuelven como dice Runtime.h;
+ * llamar a uno que no está es un error de ejecución.
+ */
+
+/**
+ * Ejecuta main. Devuelve el código de salida del programa: lo que devuelve
+ * main (0 si es void), 136 si hubo una división por cero (como el assembly)
+ * o 1 si hubo otro error de ejecución, que se informa por ctx->err.
+ */
+int interpret(CompilerContext *ctx);
+
+#endif /* INTERPRETER_H */
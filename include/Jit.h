@@ -0,0 +1,26 @@
+#ifndef JIT_H
+#define JIT_H
+
+#include "Context.h"
+#include "X86.h"
+
+/*
+ * -t jit: el código máquina del archivo (generateUnitMachineCode de cada
+ * unidad, juntos con x86_append) se copia a memoria ejecutable y main se
+ * llama desde el compilador, sin assembler ni linker.
+ *
+ * Las globales de ctx->decl_vars van en páginas aparte, de lectura y
+ * escritura. Las llamadas a externos pasan por un salto indirecto (jmp
+ * *addr(%rip)) junto al código porque la libc puede quedar a más de 2 GiB;
+ * los externos se resuelven como dice Runtime.h.
+ */
+
+/**
+ * Ejecuta main. Devuelve su código de salida, o 1 si el programa no se pudo
+ * cargar (un externo que no está, sin memoria ejecutable); el motivo va a
+ * ctx->err. Una división por cero termina el proceso con 136, como el
+ * ejecutable generado.
+ */
+int jit_run(CompilerContext *ctx, const X86Code *text);
+
+#endif /* JIT_H */
@@ -0,0 +1,64 @@
+#ifndef LIVENESS_H
+#define LIVENESS_H
+
+#include "CFG.h"
+
+/*
+ * Análisis de variables vivas sobre el código intermedio de un método.
+ *
+ * Los valores analizados son los temporales y las variables locales y
+ * parámetros (todo lo que no es global). Cada uno recibe un id denso
+ * 0..nvalues-1 y los conjuntos se representan como bitsets, uno por cada
+ * bloque del CFG del método (blocks[b] corresponde a cfg->blocks[b]).
+ *
+ * Los operandos de IR_PARAM se consideran leídos en el IR_CALL que los
+ * consume: el backend carga los argumentos recién al momento de la llamada.
+ */
+
+typedef struct {
+    Bitset use, def;        // leídos antes de escribirse / escritos en el bloque
+    Bitset in, out;         // vivos a la entrada / a la salida
+} LiveBlock;
+
+typedef struct {
+    CompilerContext *ctx;
+    IRList *list;
+    int start, end;         // IR_METHOD .. IR_FMETHOD
+    int nvalues;
+    int words;              // palabras de 64 bits por bitset
+    IROperand *values;      // id -> valor
+    IRValueRange range;     // los ids de temporales y locales del método
+    int *ids;               // ir_value_index -> id, o -1
+    CFG *cfg;
+    int nblocks;
+    LiveBlock *blocks;
+    int *param_next;        // por instrucción: siguiente PARAM de la misma llamada, o -1
+    int *call_params;       // por instrucción CALL: primer PARAM que consume, o -1
+} Liveness;
+
+typedef struct {
+    IROperand value;
+    int start, end;         // primera y última instrucción donde está vivo
+    bool crosses_call;      // vivo a través de un CALL
+} LiveInterval;
+
+Liveness *liveness_compute(CompilerContext *ctx, IRList *list, int start, int end);
+void liveness_free(Liveness *lv);
+
+/* id del valor, o -1 si no es un valor analizado (globales, literales, etiquetas) */
+int liveness_id(Liveness *lv, IROperand v);
+
+/*
+ * Operandos que lee la instrucción i, con la convención de PARAM descripta
+ * arriba. 'uses' debe tener lugar para liveness_max_uses(lv) operandos.
+ */
+int liveness_uses(Liveness *lv, int i, IROperand *uses);
+int liveness_max_uses(Liveness *lv);
+
+/*
+ * Intervalos de vida [start, end] de todos los valores, ordenados por start.
+ * Devuelve la cantidad; el arreglo se libera con free().
+ */
+int liveness_intervals(Liveness *lv, LiveInterval **out);
+
+#endif /* LIVENESS_H */
@@ -0,0 +1,48 @@
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include "Intermediate.h"
+
+/* Cantidad máxima de vueltas del driver de punto fijo */
+#define OPT_MAX_ITERATIONS 16
+
+/**
+ * Un pase de optimización sobre el código intermedio.
+ * 'run' devuelve true si modificó la lista (el driver vuelve a iterar);
+ * los temporales y etiquetas nuevos se numeran en 'ctx'.
+ * Los pases de backend (run == NULL) no se ejecutan en el punto fijo:
+ * solo se consultan con optimization_enabled() desde la etapa assembly.
+ * Un pase 'once' corre solo en la primera vuelta (no es idempotente).
+ */
+typedef struct {
+    const char *name;
+    const char *description;
+    bool (*run)(CompilerContext *ctx, IRList *list);
+    bool once;
+} OptPass;
+
+/**
+ * Selecciona los pases a partir del argumento de -opt:
+ * "all" para todos o una lista separada por comas ("fold,dce").
+ * Devuelve false si algún nombre no corresponde a un pase registrado.
+ */
+bool optimizer_configure(const char *spec);
+
+/* true si el pase 'name' fue seleccionado con -opt */
+bool optimization_enabled(const char *name);
+
+/**
+ * Ejecuta los pases seleccionados hasta alcanzar un punto fijo.
+ * Con debug imprime, por pase, el tiempo y la variación de instrucciones.
+ */
+void run_optimizations(CompilerContext *ctx, IRList *list, bool debug);
+
+void print_optimizations(void);
+
+/* Pases sobre el código intermedio (cada uno en su propio archivo) */
+bool opt_ssa(CompilerContext *ctx, IRList *list);
+bool opt_fold(CompilerContext *ctx, IRList *list);
+bool opt_dce(CompilerContext *ctx, IRList *list);
+bool opt_branches(CompilerContext *ctx, IRList *list);
+
+#endif /* OPTIMIZER_H */
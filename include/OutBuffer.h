@@ -0,0 +1,30 @@
+#ifndef OUTBUFFER_H
+#define OUTBUFFER_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+/*
+ * Buffer de bytes que crece a demanda. El texto de salida se arma entero en
+ * memoria y se escribe con un único fwrite (out_flush), en lugar de pasar
+ * por stdio línea por línea.
+ */
+typedef struct {
+    char *data;
+    size_t size;
+    size_t capacity;
+} OutBuffer;
+
+void out_init(OutBuffer *out);
+void out_free(OutBuffer *out);
+
+void out_write(OutBuffer *out, const char *s, size_t len);
+void out_puts(OutBuffer *out, const char *s);
+void out_putc(OutBuffer *out, char c);
+/* Entero en decimal, sin pasar por printf */
+void out_int(OutBuffer *out, long value);
+
+/* Escribe todo el contenido en 'file'; devuelve 0 si pudo */
+int out_flush(OutBuffer *out, FILE *file);
+
+#endif /* OUTBUFFER_H */
@@ -0,0 +1,18 @@
+#ifndef PEEPHOLE_H
+#define PEEPHOLE_H
+
+#include "AsmBuffer.h"
+
+/*
+ * Optimizador peephole sobre el assembly ya generado. Cada regla se
+ * habilita por separado (en la etapa assembly, con -opt):
+ */
+#define PEEP_MOVES     (1u << 0)   // peep-mov: movq redundantes y operandos con valor conocido
+#define PEEP_JUMPS     (1u << 1)   // peep-jmp: saltos a la etiqueta siguiente
+#define PEEP_BRANCHES  (1u << 2)   // peep-cmp: setcc + cmpq $1 + jne  ->  jcc
+#define PEEP_SHIFTS    (1u << 3)   // peep-shl: imulq por potencia de 2  ->  salq
+
+/* Aplica las reglas seleccionadas; devuelve cuántas instrucciones se eliminaron */
+int peephole(AsmBuffer *buf, unsigned rules);
+
+#endif /* PEEPHOLE_H */
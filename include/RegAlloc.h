@@ -0,0 +1,19 @@
+#ifndef REGALLOC_H
+#define REGALLOC_H
+
+#include "Intermediate.h"
+
+// Registros que preserva el método llamado (se guardan en el prólogo si se usan)
+#define CALLEE_SAVED_COUNT 5
+extern const char *const CALLEE_SAVED_REGISTERS[CALLEE_SAVED_COUNT];
+
+/**
+ * Asignación de registros por linear scan, método por método.
+ * Deja el registro de cada temporal/variable local elegido en las tablas
+ * de la unidad (ir_value_info) y reserva en el frame los slots para
+ * preservar los callee-saved usados.
+ * Debe correr después de calculate_offsets y antes de offset_temps.
+ */
+void allocate_registers(CompilerContext *ctx, IRList *list, bool debug);
+
+#endif /* REGALLOC_H */
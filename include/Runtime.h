@@ -0,0 +1,35 @@
+#ifndef RUNTIME_H
+#define RUNTIME_H
+
+/*
+ * Métodos externos para los targets que ejecutan el programa dentro del
+ * compilador (-t run y -t vm), y lo que comparten sus dos intérpretes.
+ *
+ * print_int y get_int son internos: imprime el valor (como int) con un salto
+ * de línea; lee un entero de la entrada estándar, 0 si no hay. Cualquier otro
+ * externo se busca por nombre entre los símbolos del proceso (dlsym) y se
+ * llama con la convención de C: hasta 6 argumentos enteros por registro y el
+ * resultado en %rax.
+ */
+#include <stdio.h>
+#include <stdarg.h>
+
+#define EXTERN_MAX_ARGS 6
+#define EXIT_DIV_ZERO   136     // el mismo código que usa el assembly
+
+/* Aritmética sin signo: desborda como en el assembly en lugar de ser indefinida */
+#define WRAP(op, a, b) ((long)((unsigned long)(a) op (unsigned long)(b)))
+
+typedef long (*ExternFn)(long, long, long, long, long, long);
+
+/* El externo 'name', o NULL si no está en el proceso */
+ExternFn runtime_resolve(const char *name);
+
+/*
+ * "Error de ejecución en la línea N: ..." en 'err' (sin la línea si es 0).
+ * Antes vacía stdout: lo que el programa ya imprimió va antes del error.
+ */
+void runtime_error(FILE *err, int line, const char *fmt, ...);
+void runtime_verror(FILE *err, int line, const char *fmt, va_list ap);
+
+#endif /* RUNTIME_H */
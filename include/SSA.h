@@ -0,0 +1,66 @@
+#ifndef SSA_H
+#define SSA_H
+
+#include "Liveness.h"
+
+/*
+ * Forma SSA del código intermedio de un método.
+ *
+ * Cada definición de un valor (temporal, variable local o parámetro) pasa a
+ * escribir un temporal propio, una "versión" de la variable original. En los
+ * puntos de unión los nodos phi eligen la versión según el predecesor por el
+ * que se llegó. Las phi no se guardan en la IRList: viven en SSABlock hasta
+ * que ssa_destruct las reemplaza por copias en los predecesores.
+ *
+ * La construcción es la de Cytron et al.: phi en la frontera de dominancia
+ * iterada de los bloques que definen cada variable (podada con el análisis
+ * de variables vivas) y renombrado recorriendo el árbol de dominadores.
+ */
+
+typedef struct {
+    IROperand result;       // versión que define la phi
+    IROperand var;          // variable original
+    IROperand *args;        // una versión por predecesor, en el orden de preds
+    bool removed;
+} PhiNode;
+
+typedef struct {
+    PhiNode *phis;
+    int nphis;
+} SSABlock;
+
+typedef struct {
+    Liveness *lv;           // análisis del código original (incluye el CFG)
+    CFG *cfg;
+    SSABlock *blocks;       // en paralelo a cfg->blocks
+    int first_version;      // las versiones son los temporales [first_version, first_version + nversions)
+    int nversions;          // versiones nuevas creadas al renombrar
+    CompilerContext *ctx;   // numera los temporales y etiquetas que agrega ssa_destruct
+} SSAForm;
+
+/* Convierte en SSA el método [start, end]; renombra los operandos en la lista */
+SSAForm *ssa_build(CompilerContext *ctx, IRList *list, int start, int end);
+void ssa_free(SSAForm *ssa);
+
+/*
+ * Chequea las propiedades de la forma SSA: cada versión se define una sola
+ * vez, toda phi tiene un argumento por predecesor y cada uso está dominado
+ * por su definición. Imprime el primer problema en stderr.
+ */
+bool ssa_verify(SSAForm *ssa);
+
+/*
+ * Propagación de copias sobre la forma SSA: los LOAD/STORE entre valores
+ * y las phi con un único argumento distinto desaparecen y sus usos pasan a
+ * leer directamente la versión original. Devuelve true si cambió algo.
+ */
+bool ssa_copy_propagate(SSAForm *ssa);
+
+/*
+ * Sale de SSA agregando a 'out' el método sin phi: cada phi se reemplaza por
+ * copias paralelas al final de sus predecesores (partiendo las aristas
+ * críticas con un bloque nuevo). Los bloques inalcanzables se descartan.
+ */
+void ssa_destruct(SSAForm *ssa, IRList *out);
+
+#endif /* SSA_H */
@@ -7,23 +7,48 @@
 typedef struct TypeStack {
     SymbolType arr[100];
     int top;
+    FILE *err;              // donde se informa un desborde (el ctx->err del archivo)
 } TypeStack;
 
-void initTypeStack(TypeStack *s);
+void initTypeStack(TypeStack *s, FILE *err);
 void pushType(TypeStack *s, SymbolType t);
 SymbolType popType(TypeStack *s);
 SymbolType peekType(TypeStack *s);
 int isEmptyTypeStack(TypeStack *s);
 
+/*
+ * Pila de scopes. Además de la tabla de cada scope se mantiene 'visible':
+ * nombre -> declaración más interna, así que lookupInScopes es una sola
+ * búsqueda en lugar de recorrer todos los scopes. Cada declaración anota en
+ * 'undo' el símbolo que tapó; al cerrar un scope se deshacen sus anotaciones.
+ */
+typedef struct ScopeUndo {
+    const char *name;
+    Symbol *shadowed;       // declaración visible antes, o NULL
+} ScopeUndo;
+
+typedef struct ScopeFrame {
+    SymbolTable *table;
+    int mark;               // tamaño de 'undo' al abrir el scope
+} ScopeFrame;
+
 typedef struct ScopeStack {
-    SymbolTable *arr[100];  // tablas de símbolos
+    ScopeFrame *frames;     // crece con el anidamiento, sin tope
     int top;
+    int capacity;
+    SymbolTable *visible;
+    ScopeUndo *undo;
+    int undo_size;
+    int undo_capacity;
+    FILE *err;
 } ScopeStack;
 
-void initScopeStack(ScopeStack *s);
+void initScopeStack(ScopeStack *s, FILE *err);
 void pushScope(ScopeStack *s, SymbolTable *t);
 void popScope(ScopeStack *s);
 SymbolTable* peekScope(ScopeStack *s);
+/* Inserta en el scope actual y deja el símbolo visible hasta cerrarlo */
+Symbol* declareInScope(ScopeStack *s, char *name, SymbolType type, Valores value);
 Symbol* lookupInScopes(ScopeStack *s, const char *name);
 void printScopeStack(ScopeStack *s);
 
@@ -18,8 +18,7 @@ typedef enum {
     TYPE_INT,
     TYPE_BOOL,
     TYPE_VOID,
-    TYPE_ERROR,
-    TYPE_LABEL
+    TYPE_ERROR
 } SymbolType;
 
 typedef struct Symbol {
@@ -39,12 +38,19 @@ typedef struct Symbol {
     int param_count;
     int local_count;
     int total_stack_space;
-    int is_temp;
+
+    // Código intermedio
+    int ir_id;              // id de su operando + 1 (0: todavía no aparece en el IR)
+
+    // Asignación de registros (etapa assembly con -opt regalloc)
+    int saved_regs;         // (métodos) máscara de registros callee-saved que usa
+    int saved_regs_offset;  // (métodos) offset del primer slot donde se preservan
 
 } Symbol;
 struct Tree;
 
-Symbol *createSymbolCall(const char *name, SymbolKind kind);
-Symbol* createSymbol(const char *name, struct Tree *typeNode, SymbolKind kind, Valores valor);
+/* 'name' tiene que venir internado (Intern.h), como los ID del lexer */
+Symbol *createSymbolCall(char *name, SymbolKind kind);
+Symbol* createSymbol(char *name, struct Tree *typeNode, SymbolKind kind, Valores valor);
 Symbol* createLiteralSymbol(int value, SymbolType type);
 #endif /*SYMBOL_H*/
\ No newline at end of file
@@ -0,0 +1,46 @@
+#ifndef SYMBOL_MAP_H
+#define SYMBOL_MAP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "Symbol.h"
+
+/* Hash de un puntero; también lo usa SymbolTable, con nombres internados como clave */
+static inline unsigned hash_ptr(const void *p) {
+    uintptr_t x = (uintptr_t)p;
+    x ^= x >> 17;
+    x *= 0x9E3779B1u;
+    return (unsigned)(x ^ (x >> 15));
+}
+
+/*
+ * Diccionario Symbol* -> int con direccionamiento abierto.
+ * Lo usan los pases de optimización para asociar información a temporales
+ * y variables sin agregar campos a Symbol. symmap_clear() es O(1): cada
+ * entrada guarda la generación en la que se escribió y las de generaciones
+ * anteriores se consideran vacías.
+ */
+typedef struct {
+    Symbol *sym;
+    int value;
+    unsigned gen;
+} SymbolMapEntry;
+
+typedef struct {
+    SymbolMapEntry *entries;
+    int capacity;       // potencia de 2
+    int used;           // slots ocupados, incluyendo entradas viejas
+    unsigned gen;
+} SymbolMap;
+
+void symmap_init(SymbolMap *m);
+void symmap_free(SymbolMap *m);
+void symmap_clear(SymbolMap *m);
+bool symmap_get(SymbolMap *m, Symbol *sym, int *value);
+void symmap_set(SymbolMap *m, Symbol *sym, int value);
+void symmap_remove(SymbolMap *m, Symbol *sym);
+
+/* true si el slot i contiene una entrada vigente (para recorrer el mapa) */
+#define SYMMAP_LIVE(m, i) ((m)->entries[i].sym && (m)->entries[i].gen == (m)->gen)
+
+#endif /* SYMBOL_MAP_H */
@@ -3,15 +3,34 @@
 
 #include "Symbol.h"
 
+/*
+ * Tabla de símbolos de un scope. Los símbolos quedan en 'symbols' en orden
+ * de inserción; 'slots' es un hash abierto indexado por el nombre internado
+ * (Intern.h), así que buscar es comparar punteros.
+ *
+ * Los nombres que reciben estas funciones tienen que estar internados (los
+ * de los Symbol y los del lexer lo están): solo se hashea y se compara el
+ * puntero, nunca el texto.
+ */
 typedef struct SymbolTable {
     Symbol **symbols;
+    const char **names; // nombre internado de cada posición de symbols
     int size;
     int capacity;
+    int *slots;         // posición en symbols, o -1 si el slot está libre
+    int slot_capacity;  // potencia de 2
 } SymbolTable;
 
 SymbolTable* createTable();
-Symbol* insertSymbol(SymbolTable *table, const char *name, SymbolType type, Valores value);
+Symbol* insertSymbol(SymbolTable *table, char *name, SymbolType type, Valores value);
 Symbol* lookupSymbol(SymbolTable *table, const char *name);
+
+/**
+ * Asocia 'name' con 'sym' (NULL la deja sin símbolo) y devuelve el que
+ * tenía antes. Lo usa la pila de scopes para la tabla de nombres visibles.
+ */
+Symbol* bindSymbol(SymbolTable *table, const char *name, Symbol *sym);
+
 void printSymbolTable(SymbolTable *table);
 
 #endif
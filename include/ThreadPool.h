@@ -0,0 +1,38 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <stdio.h>
+#include <stdatomic.h>
+
+/*
+ * Pool de hilos con robo de trabajo. Cada hilo tiene su propia cola: saca
+ * las tareas de su extremo (la última que agregó) y, cuando se queda sin
+ * trabajo, le roba la más vieja a otro hilo. Una tarea puede agregar más
+ * tareas: quedan en la cola del hilo que la está ejecutando.
+ *
+ * Las tareas se agrupan en un PoolGroup para esperar a que terminen todas;
+ * quien espera con pool_wait ejecuta tareas pendientes mientras tanto, así
+ * que también se puede esperar desde adentro de una tarea.
+ */
+typedef void (*PoolTaskFn)(void *arg);
+
+typedef struct {
+    atomic_int pending;     // tareas del grupo que todavía no terminaron
+} PoolGroup;
+
+typedef struct ThreadPool ThreadPool;
+
+ThreadPool *pool_create(int nthreads);
+/* Espera a que se vacíen las colas y junta los hilos */
+void pool_destroy(ThreadPool *pool);
+
+void pool_submit(ThreadPool *pool, PoolGroup *group, PoolTaskFn fn, void *arg);
+void pool_wait(ThreadPool *pool, PoolGroup *group);
+
+/* Índice del hilo del pool que está ejecutando, o -1 fuera del pool */
+int pool_worker_index(void);
+
+/* Tareas ejecutadas y robadas por cada hilo */
+void pool_print_stats(ThreadPool *pool, FILE *out);
+
+#endif /* THREADPOOL_H */
@@ -0,0 +1,89 @@
+#ifndef TIMEREPORT_H
+#define TIMEREPORT_H
+
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * Instrumentación de --time-report: tiempo de pared y de CPU, cantidad de
+ * pedidos de memoria (malloc, calloc, realloc) y bytes pedidos en cada fase
+ * de la compilación y en cada pase de optimización, más lo que produjo cada
+ * una (tokens, nodos, símbolos, instrucciones, líneas de assembly).
+ *
+ * Cada contexto tiene su reporte (ctx->report, NULL si no se pidió). Las
+ * unidades de Units.h llevan uno propio que se suma al del archivo cuando
+ * terminan: en las fases por método el tiempo es la suma de todos los
+ * métodos y puede superar al de pared si corrieron en paralelo.
+ */
+typedef enum {
+    PHASE_LEX,
+    PHASE_PARSE,            // yyparse sin el tiempo del lexer
+    PHASE_SEMANTIC,         // check_scopes y check_types
+    PHASE_OFFSETS,          // calculate_offsets
+    PHASE_GEN_CODE,
+    PHASE_OPTIMIZE,         // todos los pases (el detalle va en 'passes')
+    PHASE_REGALLOC,
+    PHASE_OFFSET_TEMPS,
+    PHASE_ASSEMBLY,         // generateUnitAssembly, con el peephole
+    PHASE_MACHINE_CODE,     // generateUnitMachineCode (-t jit y -t object)
+    PHASE_OUTPUT,           // secciones de las globales, concatenación y fwrite
+    PHASE_BYTECODE,         // -t vm: bc_compile, o la carga del caché
+    PHASE_RUN,              // -t run, -t vm y -t jit: ejecución del programa
+    PHASE_COUNT
+} Phase;
+
+#define REPORT_MAX_PASSES 16
+
+typedef struct {
+    double wall_ms;
+    double cpu_ms;          // CPU del hilo que ejecutó la fase
+    long allocs;
+    long bytes;
+    long runs;
+} PhaseStats;
+
+typedef struct {
+    struct timespec wall;
+    struct timespec cpu;
+    long allocs;
+    long bytes;
+} PhaseTimer;
+
+typedef struct TimeReport {
+    const char *input_file;
+    PhaseStats phases[PHASE_COUNT];
+    PhaseStats passes[REPORT_MAX_PASSES];       // por índice en la tabla de Optimizer.c
+    const char *pass_names[REPORT_MAX_PASSES];
+    PhaseStats total;
+    double units_wall_ms;   // pared de las fases por método, todas las unidades juntas
+
+    long tokens;
+    long ast_nodes;
+    long symbols;
+    long ir_instructions;   // después de gen_code
+    long ir_optimized;      // después de los pases
+    long asm_lines;
+    long max_rss_kb;        // pico de memoria residente del proceso
+} TimeReport;
+
+/* Empieza a medir (no hace nada si report es NULL) */
+void report_start(TimeReport *report, PhaseTimer *timer);
+/* Suma a la fase lo que pasó desde report_start */
+void report_stop(TimeReport *report, Phase phase, PhaseTimer *timer);
+void report_stop_pass(TimeReport *report, int pass, const char *name, PhaseTimer *timer);
+/* Cierra el total de la compilación del archivo y anota el pico de memoria */
+void report_finish(TimeReport *report, PhaseTimer *timer);
+/* Milisegundos de pared (CLOCK_MONOTONIC) desde 'start'; no depende de que haya reporte */
+double elapsed_ms(const struct timespec *start);
+
+void report_merge(TimeReport *into, const TimeReport *from);
+
+void report_print(const TimeReport *report, FILE *out);
+void report_print_json(const TimeReport *report, FILE *out);
+
+/* Pedidos de memoria hechos por el hilo actual desde alloc_counting_enable (allocstats.c) */
+void alloc_counters(long *allocs, long *bytes);
+/* Empieza a contar; se llama una vez, antes de crear hilos. Sin esto los contadores quedan en cero */
+void alloc_counting_enable(void);
+
+#endif /* TIMEREPORT_H */
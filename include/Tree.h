@@ -64,13 +64,13 @@ typedef struct Queue {
 } Queue;
 
 /* Funciones principales de manejo de árbol */
-Tree* createNode(typeTree tipo, Symbol *sym, Tree *left, Tree *right);
+Tree* createNode(typeTree tipo, Symbol *sym, Tree *left, Tree *right, int lineno);
 void printTree(Tree *n, int level);
 const char* tipoToStr(typeTree t);
-void execute(Tree *node);
 
 /*Chequeo semantico */
-SymbolType check_types(Tree *node);
-void check_scopes(Tree *node);
+struct CompilerContext;
+SymbolType check_types(struct CompilerContext *ctx, Tree *node);
+void check_scopes(struct CompilerContext *ctx, Tree *node);
 
 #endif /* TREE_H */
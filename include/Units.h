@@ -0,0 +1,53 @@
+#ifndef UNITS_H
+#define UNITS_H
+
+#include "Intermediate.h"
+
+/*
+ * El código intermedio de un archivo partido en unidades: cada método
+ * (IR_METHOD .. IR_FMETHOD) y cada tramo de código entre métodos. Los
+ * métodos solo comparten las globales, así que cada unidad se optimiza y
+ * se traduce a assembly por su cuenta, como una tarea del pool del
+ * contexto, y después se juntan los resultados en el orden del fuente.
+ *
+ * Cada unidad trabaja con una copia del contexto: su propia arena, sus
+ * contadores, sus tablas de valores (registro y slot de cada temporal),
+ * sus argumentos pendientes y su buffer de assembly. Los contadores siguen
+ * desde el último temporal y la última etiqueta de la unidad, y las
+ * etiquetas que crea llevan el número de unidad (L7_3) para no chocar con
+ * las de otra. La salida es la misma con cualquier cantidad de hilos.
+ */
+typedef struct {
+    CompilerContext ctx;
+    IRList list;
+} IRUnit;
+
+typedef struct {
+    IRUnit *units;
+    int count;
+    int methods;
+} IRUnits;
+
+typedef void (*UnitFn)(IRUnit *unit, void *arg);
+
+/* Copia las instrucciones de 'list' en unidades (la lista no cambia) */
+void units_split(CompilerContext *ctx, IRList *list, IRUnits *units);
+
+/**
+ * Ejecuta fn sobre cada unidad, con la arena de la unidad asociada al hilo.
+ * Con ctx->pool cada unidad es una tarea; si no, corren en orden. Al
+ * terminar, lo que midió cada unidad se suma a ctx->report.
+ *
+ * Si no hay pool pero ctx->pool_threads lo permite y hay unidades para
+ * repartir, lo crea y lo deja en ctx->pool (lo destruye quien es dueño del
+ * contexto): un archivo chico no paga el arranque de los hilos.
+ */
+void units_run(CompilerContext *ctx, IRUnits *units, UnitFn fn, void *arg);
+
+/* Concatena las listas de las unidades, en orden, en 'list' (vacía) */
+void units_join(IRUnits *units, IRList *list);
+
+/* Libera las listas, los buffers y las arenas de las unidades */
+void units_free(IRUnits *units);
+
+#endif /* UNITS_H */
@@ -0,0 +1,132 @@
+#ifndef X86_H
+#define X86_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "Symbol.h"
+
+/*
+ * Codificador de x86-64 para el subconjunto de instrucciones que usa
+ * Assembler.c (mov, add, sub, imul, idiv, cmp, setcc, jcc, call,
+ * enter/leave, push), siempre con operandos de 64 bits.
+ *
+ * Las instrucciones se escriben en un X86Code. Los saltos van a etiquetas
+ * del mismo código (x86_new_label / x86_bind) y se completan en
+ * x86_finish. Lo que está fuera del código (otro método, un externo, una
+ * global) queda como reubicación: un campo de 32 bits relativo a %rip que
+ * completa quien ubica el código en memoria (Jit.h) o en un .o (Elf.h).
+ */
+
+typedef enum {
+    X86_RAX, X86_RCX, X86_RDX, X86_RBX, X86_RSP, X86_RBP, X86_RSI, X86_RDI,
+    X86_R8, X86_R9, X86_R10, X86_R11, X86_R12, X86_R13, X86_R14, X86_R15
+} X86Reg;
+
+/* Códigos de condición de jcc y setcc */
+typedef enum {
+    X86_CC_E  = 0x4,
+    X86_CC_NE = 0x5,
+    X86_CC_L  = 0xC,
+    X86_CC_GE = 0xD,
+    X86_CC_LE = 0xE,
+    X86_CC_G  = 0xF
+} X86Cond;
+
+/* Operaciones de dos operandos con la misma codificación (el /digit del 0x81) */
+typedef enum {
+    X86_ADD = 0,
+    X86_OR  = 1,
+    X86_AND = 4,
+    X86_SUB = 5,
+    X86_XOR = 6,
+    X86_CMP = 7
+} X86Alu;
+
+typedef enum {
+    X86_OPND_REG,
+    X86_OPND_MEM,           // disp(base)
+    X86_OPND_SYMBOL         // sym(%rip): una global
+} X86OperandKind;
+
+typedef struct {
+    X86OperandKind kind;
+    X86Reg reg;             // REG: el registro; MEM: la base
+    int32_t disp;
+    Symbol *sym;
+} X86Operand;
+
+#define X86_REG(r)          ((X86Operand){ X86_OPND_REG, (r), 0, NULL })
+#define X86_MEM(base, d)    ((X86Operand){ X86_OPND_MEM, (base), (d), NULL })
+#define X86_SYM(s)          ((X86Operand){ X86_OPND_SYMBOL, X86_RAX, 0, (s) })
+
+typedef enum {
+    X86_RELOC_CALL,         // call rel32 a un método o a un externo
+    X86_RELOC_DATA          // disp32 de un operando sym(%rip)
+} X86RelocKind;
+
+/* El campo de 32 bits en 'offset' vale dirección(símbolo) + addend - dirección(campo) */
+typedef struct {
+    X86RelocKind kind;
+    int offset;
+    int addend;
+    Symbol *sym;            // NULL: un externo de la libc, por 'name'
+    const char *name;
+} X86Reloc;
+
+/* Un método definido en el código */
+typedef struct {
+    Symbol *sym;
+    int offset;
+} X86Def;
+
+typedef struct {
+    unsigned char *bytes;
+    int size;
+    int capacity;
+
+    int *labels;            // posición de cada etiqueta, -1 si todavía no se ubicó
+    int label_count;
+    int label_capacity;
+    int *jumps;             // campos rel32 de saltos; el valor guardado es la etiqueta
+    int jump_count;
+    int jump_capacity;
+
+    X86Reloc *relocs;
+    int reloc_count;
+    int reloc_capacity;
+    X86Def *defs;
+    int def_count;
+    int def_capacity;
+} X86Code;
+
+void x86_init(X86Code *c);
+void x86_free(X86Code *c);
+/* Completa los saltos a etiquetas; después de esto solo quedan las reubicaciones */
+void x86_finish(X86Code *c);
+/* Agrega 'src' (ya terminado) al final de 'dst', con sus reubicaciones y métodos */
+void x86_append(X86Code *dst, const X86Code *src);
+
+int x86_new_label(X86Code *c);
+void x86_bind(X86Code *c, int label);
+/* El método 'sym' empieza en la posición actual */
+void x86_define(X86Code *c, Symbol *sym);
+
+void x86_mov(X86Code *c, X86Operand dst, X86Operand src);      // a lo sumo uno en memoria
+void x86_mov_imm(X86Code *c, X86Operand dst, int32_t imm);      // con extensión de signo
+void x86_alu(X86Code *c, X86Alu op, X86Reg dst, X86Operand src);
+void x86_alu_imm(X86Code *c, X86Alu op, X86Operand dst, int32_t imm);
+void x86_imul(X86Code *c, X86Reg dst, X86Operand src);
+void x86_neg(X86Code *c, X86Operand dst);
+void x86_cqo(X86Code *c);
+void x86_idiv(X86Code *c, X86Operand divisor);
+void x86_setcc(X86Code *c, X86Cond cc, X86Reg dst);             // el byte bajo de dst
+void x86_movzx8(X86Code *c, X86Reg dst, X86Reg src);            // dst = byte bajo de src
+void x86_push(X86Code *c, X86Operand src);
+void x86_jmp(X86Code *c, int label);
+void x86_jcc(X86Code *c, X86Cond cc, int label);
+void x86_call(X86Code *c, Symbol *sym, const char *name);
+void x86_enter(X86Code *c, int size);
+void x86_leave(X86Code *c);
+void x86_ret(X86Code *c);
+
+#endif /* X86_H */
@@ -1,18 +1,28 @@
-#ifndef ARGS_H
-#define ARGS_H
-
-#include "Utils.h"
-
-typedef struct {
-    char *input_file;
-    char *output_file;
-    char *target;
-    char *optimization;
-    bool debug;
-} Config;
-
-bool parse_args(int argc, char **argv, Config *cfg);
-FILE *open_input(const char *path);
-FILE *open_output(const char *path);
-
-#endif
+#ifndef ARGS_H
+#define ARGS_H
+
+#include "Utils.h"
+
+typedef struct {
+    char *input_file;       // el primero de input_files
+    char **input_files;
+    int input_count;
+    int jobs;               // -j N: modo batch con N hilos (0: sin -j)
+    char *output_file;
+    char *target;
+    char *optimization;
+    bool debug;
+    char *time_report;      // --time-report[=json]: "text" o "json" (NULL: sin reporte)
+} Config;
+
+bool parse_args(int argc, char **argv, Config *cfg);
+/* Varios archivos o -j: se compilan en paralelo, cada uno a su .s */
+bool is_batch(const Config *cfg);
+/* Copia de 'path' con la extensión cambiada por 'ext' ("a.ctds", ".s" -> "a.s") */
+char *replace_extension(const char *path, const char *ext);
+FILE *open_input(const char *path);
+FILE *open_output(const char *path);
+/* Cierra lo que devolvió open_output; stdout ("-") solo se vacía, sigue en uso */
+void close_output(FILE *file);
+
+#endif
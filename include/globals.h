@@ -2,6 +2,7 @@
 #define GLOBALS_H
 
 #include "Symbol.h"
+#include "OutBuffer.h"
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -9,15 +10,12 @@
 /* Nodo de lista enlazada de símbolos */
 typedef struct SymbolNode {
     Symbol *sym;
-    Symbol *valor;
+    int valor;              /* valor inicial (0: va a .bss) */
     struct SymbolNode *next;
 } SymbolNode;
 
-/* Lista global con todas las variables globales declaradas */
-extern SymbolNode *decl_vars;
-
 /* Funciones para manejar la lista */
-void add_decl(SymbolNode **head, Symbol *sym, Symbol *valor);
-void print_global_sections(SymbolNode *head);
+void add_decl(SymbolNode **head, Symbol *sym, int valor);
+void print_global_sections(SymbolNode *head, OutBuffer *out);
 
 #endif /* GLOBALS_H */
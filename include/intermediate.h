@@ -2,6 +2,7 @@
 #define INTERMEDIATE_H
 
 #include "Tree.h"
+#include "Context.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
@@ -35,15 +36,34 @@ typedef enum {
     IR_FMETHOD, 
     IR_METH_EXT,
     IR_PRINT,
-    IR_SAVE_PARAM
+    IR_SAVE_PARAM,
+    // Saltos con comparación: 'J<cond> a, b, L' salta a L si a <cond> b.
+    // Mismo orden que IR_EQ..IR_GE
+    IR_JEQ,
+    IR_JNE,
+    IR_JLT,
+    IR_JLE,
+    IR_JGT,
+    IR_JGE,
+    IR_NOP          // instrucción eliminada por un pase, se descarta con ir_compact
 } IRInstr;
 
 
+/*
+ * Cada operando es un IROperand (Context.h) dentro de la instrucción: los
+ * temporales y las etiquetas son solo un número y las constantes van como
+ * inmediatos, sin un Symbol propio.
+ *   STORAGE imm -> result      literal
+ *   PARAM arg1, imm            índice del argumento
+ *   DECL imm -> result         valor inicial de una global (sin arg1: 0)
+ * Lo que los pases del backend deciden para cada valor (registro y slot)
+ * queda en las tablas de la unidad (ir_value_info), no en la instrucción.
+ */
 typedef struct {
     IRInstr op;
-    Symbol *arg1;
-    Symbol *arg2;
-    Symbol *result;
+    IROperand arg1;
+    IROperand arg2;
+    IROperand result;
 } IRCode;
 
 
@@ -54,9 +74,97 @@ typedef struct IRList {
 } IRList;
 
 
+static inline IROperand ir_none(void) {
+    return (IROperand){ .kind = IRO_NONE };
+}
+
+static inline IROperand ir_imm(int value) {
+    return (IROperand){ .kind = IRO_IMM, .id = value };
+}
+
+static inline bool ir_has(IROperand v) {
+    return v.kind != IRO_NONE;
+}
+
+static inline bool ir_same(IROperand a, IROperand b) {
+    return a.kind == b.kind && a.id == b.id && a.unit == b.unit;
+}
+
+/* Temporal o variable local: los valores que analizan los pases (las globales no) */
+static inline bool ir_is_value(IROperand v) {
+    return v.kind == IRO_TEMP || v.kind == IRO_LOCAL;
+}
+
 void ir_init(IRList *list);
-void ir_emit(IRList *list, IRInstr op, Symbol *arg1, Symbol *arg2, Symbol *result);
-void ir_print(IRList *list);
-Symbol* gen_code(Tree *node, IRList *list);
+void ir_emit(IRList *list, IRInstr op, IROperand arg1, IROperand arg2, IROperand result);
+/* Copia una instrucción al final de la lista */
+void ir_append(IRList *list, IRCode *code);
+void ir_print(CompilerContext *ctx, IRList *list);
+void ir_free(IRList *list);
+void ir_compact(IRList *list);
+
+/* Operandos que lee una instrucción (a lo sumo 2); devuelve la cantidad */
+int ir_uses(IRCode *code, IROperand *uses);
+/* Operando que escribe una instrucción, o IRO_NONE */
+IROperand ir_def(IRCode *code);
+/* IR_GOTO o un salto con comparación (IR_JEQ..IR_JGE) */
+bool ir_is_jump(IRInstr op);
+/* Salto que puede no tomarse: GOTO con condición o salto con comparación */
+bool ir_is_conditional(IRCode *code);
+IROperand gen_code(CompilerContext *ctx, Tree *node, IRList *list);
+
+/* Temporales y etiquetas nuevas (también los usan los pases de optimización) */
+IROperand newTemp(CompilerContext *ctx);
+IROperand newLabel(CompilerContext *ctx);
+
+/* Operando de una variable (local o global) y de un método; le dan un id la primera vez */
+IROperand ir_symbol_operand(CompilerContext *ctx, Symbol *sym);
+IROperand ir_method_operand(CompilerContext *ctx, Symbol *sym);
+/* Símbolo de un operando IRO_LOCAL, IRO_GLOBAL o IRO_METHOD; NULL para el resto */
+Symbol *ir_symbol(CompilerContext *ctx, IROperand v);
+/* Nombre para mostrar (t3, L5_2, x): el de su Symbol o el que se escribe en 'buf' */
+const char *ir_name(CompilerContext *ctx, IROperand v, char *buf, size_t size);
+
+/*
+ * Registro y slot de un temporal o una variable local en la unidad de
+ * 'ctx'; NULL para el resto. ir_value_info agranda la tabla si hace falta,
+ * ir_value_find no: devuelve NULL si el valor todavía no tiene entrada.
+ */
+IRValueInfo *ir_value_info(CompilerContext *ctx, IROperand v);
+IRValueInfo *ir_value_find(CompilerContext *ctx, IROperand v);
+/* Registro asignado al valor, o NULL (también para lo que no es un valor) */
+const char *ir_value_reg(CompilerContext *ctx, IROperand v);
+
+/*
+ * Numeración densa de los valores (temporales y variables locales) de un
+ * tramo del IR, para indexar arreglos en lugar de buscar en un diccionario.
+ * Los ids de un método son casi contiguos: gen_code los crea en orden y
+ * los pases de una unidad siguen desde el último (Units.h).
+ * Los temporales van primero (0..temps-1) y después las locales.
+ */
+typedef struct {
+    int temp_base, temps;       // temporales [temp_base, temp_base + temps)
+    int local_base, locals;     // variables locales [local_base, local_base + locals)
+} IRValueRange;
+
+void ir_value_range(IRList *list, int start, int end, IRValueRange *range);
+
+static inline int ir_value_count(const IRValueRange *r) {
+    return r->temps + r->locals;
+}
+
+/* Índice del valor en el rango, o -1 si no es un valor o queda afuera */
+static inline int ir_value_index(const IRValueRange *r, IROperand v) {
+    int k;
+    if (v.kind == IRO_TEMP) {
+        k = v.id - r->temp_base;
+        return k >= 0 && k < r->temps ? k : -1;
+    }
+    if (v.kind == IRO_LOCAL) {
+        k = v.id - r->local_base;
+        return k >= 0 && k < r->locals ? r->temps + k : -1;
+    }
+    return -1;
+}
 
-#endif
\ No newline at end of file
+#endif
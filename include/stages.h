@@ -1,13 +1,29 @@
-#ifndef STAGES_H
-#define STAGES_H
-
-#include "Args.h"
-#include "Intermediate.h"
-
-int run_scan_stage(FILE *f, bool debug);
-int run_parse_stage(Config *cfg);
-int run_codinter_stage(void);
-int run_assembly_stage(FILE *f, bool debug);
-void offset_temps(IRList *list);
-
-#endif
+#ifndef STAGES_H
+#define STAGES_H
+
+#include "Args.h"
+#include "Intermediate.h"
+#include "Optimizer.h"
+#include "RegAlloc.h"
+#include "Peephole.h"
+#include "Units.h"
+#include "Interpreter.h"
+#include "Bytecode.h"
+#include "Jit.h"
+#include "Elf.h"
+
+int run_scan_stage(CompilerContext *ctx, FILE *f, bool debug);
+int run_parse_stage(CompilerContext *ctx, Config *cfg);
+int run_codinter_stage(CompilerContext *ctx, Config *cfg);
+int run_assembly_stage(CompilerContext *ctx, FILE *f, Config *cfg);
+/* -t run: ejecuta el programa chequeado; devuelve su código de salida */
+int run_interpret_stage(CompilerContext *ctx);
+/* -t vm: ejecuta el bytecode del programa (del caché si está al día); devuelve su código de salida */
+int run_vm_stage(CompilerContext *ctx, Config *cfg, FILE *in);
+/* -t jit: traduce a código máquina y ejecuta main en el proceso; devuelve su código de salida */
+int run_jit_stage(CompilerContext *ctx, Config *cfg);
+/* -t object: traduce a código máquina y escribe un .o ELF64 en f */
+int run_object_stage(CompilerContext *ctx, FILE *f, Config *cfg);
+void offset_temps(CompilerContext *ctx, IRList *list, bool share_slots);
+
+#endif
@@ -17,21 +17,15 @@
 #include "Intermediate.h"
 #include "Assembler.h"
 #include "Error.h"
+#include "Context.h"
 
-// ==== Globals ====
-extern FILE *yyin;
-extern char *yytext;
-extern int yylex(void);
-extern int yyparse(void);
+// ==== Lexer y parser ====
+// El estado de cada compilación vive en su CompilerContext (Context.h)
+extern int yylex(YYSTYPE *lval, void *scanner);
 extern int yydebug;
-extern int main_decl;
-extern ScopeStack scope_Stack;
-extern Tree *ast_root;
-extern int had_error;
-extern int semantic_error;
 
 // ==== Macros ====
-#define PRINT_TOKEN(tok) do { \
+#define PRINT_TOKEN(tok, text) do { \
     const char *_name = NULL; \
     switch(tok) { \
         case PROGRAM: _name="PROGRAM"; break; \
@@ -57,7 +51,7 @@ extern int semantic_error;
         case UNKNOW:  _name="UNKNOW"; break; \
         default:      _name="SIMBOLO"; break; \
     } \
-    fprintf(f, "TOKEN: %s : '%s'\n", _name, yytext); \
+    fprintf(f, "TOKEN: %s : '%s'\n", _name, (text)); \
 } while(0)
 
 void print_usage(void);
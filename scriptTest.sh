@@ -1,5 +1,23 @@
 #!/bin/bash
-TARGET=$1   # scan, parse, codinter, assembly
+TARGET=$1   # scan, parse, codinter, assembly, object, run, vm, jit
+OPT=$2      # optimizaciones opcionales (ej: all, jumps)
+OPT_FLAGS=""
+if [ -n "$OPT" ]; then
+    OPT_FLAGS="-opt $OPT"
+fi
+
+# Los tests correctos que tienen <test>.expected se ejecutan y su salida se
+# compara con ese archivo (la entrada sale de <test>.in si existe). En
+# assembly y object el programa se enlaza con RUNTIME; run, vm y jit lo
+# ejecutan dentro del compilador, y ahí los que no tienen .expected no se
+# corren (alguno, como TestCorrect3, no termina).
+RUNTIME="externs/test_runtime.c"
+TIMEOUT=10
+case "$TARGET" in
+    assembly|object) EXECUTES=link ;;
+    run|vm|jit)      EXECUTES=inline ;;
+    *)               EXECUTES="" ;;
+esac
 
 # Carpetas de tests y resultados
 TEST_DIRS=("tests/correct" "tests/syntax_fail" "tests/semantic_fail")
@@ -17,6 +35,7 @@ NC="\033[0m"
 total=0
 passed=0
 failed=0
+skipped=0
 
 echo -e "${BLUE}==============================================${NC}"
 echo -e "${BLUE}🧪 Ejecutando tests para target: $TARGET${NC}"
@@ -36,16 +55,33 @@ for i in "${!TEST_DIRS[@]}"; do
     echo -e "${YELLOW}--- ${LABEL} ---${NC}"
 
     for f in $TEST_DIR/*.ctds; do
-        total=$((total+1))
         base=$(basename $f .ctds)
+        expected=$TEST_DIR/$base.expected
+        input=$TEST_DIR/$base.in
+        [ -f "$input" ] || input=/dev/null
+
+        if [ "$EXECUTES" = "inline" ] && [ $i -eq 0 ] && [ ! -f "$expected" ]; then
+            echo -e "${YELLOW}⏭  $(printf '%-30s' $base) → sin .expected, no se ejecuta${NC}"
+            skipped=$((skipped+1))
+            continue
+        fi
+        total=$((total+1))
 
-        if [ "$TARGET" = "assembly" ]; then
-            ext="s"
+        case "$TARGET" in
+            assembly) ext="s" ;;
+            object)   ext="o" ;;
+            *)        ext="out" ;;
+        esac
+
+        if [ "$EXECUTES" = "link" ]; then
+            # El código va al archivo de -o; los mensajes quedan en .log
+            ./bin/c-tds -t $TARGET $OPT_FLAGS -o $RES_DIR/$base.$ext $f > $RES_DIR/$base.log 2>&1
+        elif [ "$EXECUTES" = "inline" ]; then
+            # Lo que imprime el programa va a .out y los errores a .log
+            timeout $TIMEOUT ./bin/c-tds -t $TARGET $OPT_FLAGS $f < $input > $RES_DIR/$base.out 2> $RES_DIR/$base.log
         else
-            ext="out"
+            ./bin/c-tds -t $TARGET $OPT_FLAGS $f > $RES_DIR/$base.$ext 2>&1
         fi
-        
-        ./bin/c-tds -t $TARGET $f > $RES_DIR/$base.$ext 2>&1
 
         code=$?
 
@@ -55,11 +91,32 @@ for i in "${!TEST_DIRS[@]}"; do
             2) expected_code=2 ;;
         esac
 
-        if [ $code -eq $expected_code ]; then
+        problem=""
+        show_diff=0
+        if [ $code -ne $expected_code ]; then
+            problem="got $code, expected $expected_code"
+        elif [ $i -eq 0 ] && [ -f "$expected" ] && [ -n "$EXECUTES" ]; then
+            if [ "$EXECUTES" = "link" ]; then
+                if ! gcc -o $RES_DIR/$base $RES_DIR/$base.$ext $RUNTIME >> $RES_DIR/$base.log 2>&1; then
+                    problem="gcc no pudo ensamblar/enlazar, ver $RES_DIR/$base.log"
+                else
+                    timeout $TIMEOUT $RES_DIR/$base < $input > $RES_DIR/$base.out 2>> $RES_DIR/$base.log
+                    code=$?
+                    [ $code -ne 0 ] && problem="el programa terminó con $code"
+                fi
+            fi
+            if [ -z "$problem" ] && ! diff -q "$expected" $RES_DIR/$base.out > /dev/null; then
+                problem="la salida no coincide con $expected"
+                show_diff=1
+            fi
+        fi
+
+        if [ -z "$problem" ]; then
             echo -e "${GREEN}✅ $(printf '%-30s' $base) → OK${NC}"
             passed=$((passed+1))
         else
-            echo -e "${RED}❌ $(printf '%-30s' $base) → FAIL (got $code, expected $expected_code)${NC}"
+            echo -e "${RED}❌ $(printf '%-30s' $base) → FAIL ($problem)${NC}"
+            [ $show_diff -eq 1 ] && diff "$expected" $RES_DIR/$base.out | head -5
             failed=$((failed+1))
         fi
     done
@@ -72,5 +129,10 @@ echo -e "${BLUE}==============================================${NC}"
 echo -e "${YELLOW}▶ Resumen final:${NC}"
 echo -e "${GREEN}✅ Pasaron: $passed${NC}"
 echo -e "${RED}❌ Fallaron: $failed${NC}"
+if [ $skipped -gt 0 ]; then
+    echo -e "${YELLOW}⏭  Sin ejecutar: $skipped${NC}"
+fi
 echo -e "${YELLOW}⚡ Total tests: $total${NC}"
 echo -e "${BLUE}==============================================${NC}"
+
+[ $failed -eq 0 ]
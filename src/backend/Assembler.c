@@ -3,8 +3,22 @@
 #include <stdlib.h>
 #include <Intermediate.h>
 #include <Globals.h>
-
-extern SymbolNode *decl_vars;
+#include "RegAlloc.h"
+#include "Peephole.h"
+
+// El assembly se acumula en el contexto y el peephole lo revisa antes de escribirlo.
+// Las instrucciones van ya separadas (instr); emit queda para comentarios y etiquetas.
+#define emit(...) asm_emit(&ctx->asm_out, __VA_ARGS__)
+#define instr(op, src, dst) asm_instr(&ctx->asm_out, op, src, dst)
+
+const char *const PARAM_REGISTERS[PARAM_REGISTER_COUNT] = {
+    "%rdi",  // Parámetro 1
+    "%rsi",  // Parámetro 2
+    "%rdx",  // Parámetro 3
+    "%rcx",  // Parámetro 4
+    "%r8",   // Parámetro 5
+    "%r9"    // Parámetro 6
+};
 
 // Declaración de función helper interna (solo visible en este archivo)
 static void calculate_offsets_helper(Tree *node, int *current_offset, Symbol *current_method);
@@ -235,19 +249,9 @@ void assign_block_locals(Tree *node, int *offset)
     assign_block_locals(node->right, offset);
 }
 
-// funcion principal
-void generateAssembly(IRList *irlist)
+// Traduce una unidad (un método o el código entre métodos) a ctx->asm_out
+void generateUnitAssembly(CompilerContext *ctx, IRList *irlist, unsigned peephole_rules)
 {
-    // primero recorremos variables globales
-    collect_globals(irlist);
-
-    // secciones de declaracion e inicializacion de variables
-    print_global_sections(decl_vars);
-
-    // seccion text
-    printf(".text\n");
-    printf(".globl main\n");
-
     Symbol *current_method = NULL; // saber el metodo actual
 
     // Iterar sobre todas las instrucciones
@@ -256,17 +260,45 @@ void generateAssembly(IRList *irlist)
         IRCode *inst = &irlist->codes[i];
         if (inst->op == IR_METHOD)
         {
-            current_method = inst->result;
+            current_method = ir_symbol(ctx, inst->result);
         }
-        generateInstruction(inst, current_method);
+        generateInstruction(ctx, inst, current_method);
     }
 
     // Reservar espacio local si es necesario (por ahora fijo)
     // printf("    sub $128, %%rsp\n\n");
+
+    peephole(&ctx->asm_out, peephole_rules);
+}
+
+// funcion principal
+int generateAssembly(CompilerContext *ctx, IRUnits *units, FILE *out)
+{
+    OutBuffer text;
+    out_init(&text);
+
+    // primero recorremos variables globales
+    for (int i = 0; i < units->count; i++)
+        collect_globals(ctx, &units->units[i].list);
+
+    // secciones de declaracion e inicializacion de variables
+    print_global_sections(ctx->decl_vars, &text);
+
+    // seccion text
+    out_puts(&text, ".text\n");
+    out_puts(&text, ".globl main\n");
+
+    // El assembly de cada unidad, en el orden del fuente
+    for (int i = 0; i < units->count; i++)
+        asm_write(&units->units[i].ctx.asm_out, &text);
+
+    int result = out_flush(&text, out);
+    out_free(&text);
+    return result;
 }
 
 // Recorre la lista de IR para recolectar variables globales
-void collect_globals(IRList *irlist)
+void collect_globals(CompilerContext *ctx, IRList *irlist)
 {
     if (!irlist)
         return;
@@ -281,14 +313,15 @@ void collect_globals(IRList *irlist)
         {
         case IR_DECL:
             // Solo variables globales
-            if (inst->result && inst->result->is_global)
+            if (inst->result.kind == IRO_GLOBAL)
             {
+                Symbol *sym = ir_symbol(ctx, inst->result);
                 int encontrado = 0;
-                SymbolNode *actual = decl_vars;
+                SymbolNode *actual = ctx->decl_vars;
     
                 // no agregar si ya existe la variable global en decl_vars
                 while (actual) {
-                    if (actual->sym == inst->result) {
+                    if (actual->sym == sym) {
                         encontrado = 1;
                         break;
                     }
@@ -297,7 +330,7 @@ void collect_globals(IRList *irlist)
                 
                 // --- Añadir si no se encontró ---
                 if (!encontrado) {
-                    add_decl(&decl_vars, inst->result, inst->arg1);
+                    add_decl(&ctx->decl_vars, sym, ir_has(inst->arg1) ? inst->arg1.id : 0);
                 }
             }
             break;
@@ -305,546 +338,587 @@ void collect_globals(IRList *irlist)
     }
 }
 
+// =============================
+// Operandos
+// =============================
+
+/**
+ * Ubicación de un operando en AT&T: el registro asignado por el allocator,
+ * el label de una global (x(%rip)), su slot en la pila (-8(%rbp)) o un inmediato.
+ * Usa buffers rotativos (uno por hilo) para poder combinar varios operandos en un printf.
+ */
+static char *next_buffer(void)
+{
+    static _Thread_local char buffers[4][64];
+    static _Thread_local int next = 0;
+
+    char *buf = buffers[next];
+    next = (next + 1) % 4;
+    return buf;
+}
+
+static const char *operand(CompilerContext *ctx, IROperand v)
+{
+    const char *reg = ir_value_reg(ctx, v);
+    if (reg)
+        return reg;
+
+    char *buf = next_buffer();
+    if (v.kind == IRO_IMM)
+        snprintf(buf, 64, "$%d", v.id);
+    else if (v.kind == IRO_GLOBAL)
+        snprintf(buf, 64, "%s(%%rip)", ir_symbol(ctx, v)->name);
+    else if (v.kind == IRO_LOCAL)
+        snprintf(buf, 64, "%d(%%rbp)", ir_symbol(ctx, v)->offset);
+    else
+        snprintf(buf, 64, "%d(%%rbp)", ir_value_info(ctx, v)->offset);
+    return buf;
+}
+
+/* Nombre de un operando para los comentarios y las etiquetas */
+static const char *name(CompilerContext *ctx, IROperand v)
+{
+    return ir_name(ctx, v, next_buffer(), 64);
+}
+
+/* Inmediato "$n" */
+static const char *imm(long value)
+{
+    char *buf = next_buffer();
+    snprintf(buf, 64, "$%ld", value);
+    return buf;
+}
+
+/* Slot de la pila "n(%rbp)" */
+static const char *rbp_slot(int offset)
+{
+    char *buf = next_buffer();
+    snprintf(buf, 64, "%d(%%rbp)", offset);
+    return buf;
+}
+
+/* movq src -> dst, pasando por %rax si ambos están en memoria */
+static void emit_move(CompilerContext *ctx, IROperand src, IROperand dst)
+{
+    const char *src_reg = ir_value_reg(ctx, src);
+    const char *dst_reg = ir_value_reg(ctx, dst);
+    if (ir_same(src, dst) || (src_reg && src_reg == dst_reg))
+        return;
+    if (!src_reg && !dst_reg)
+    {
+        instr("movq", operand(ctx, src), "%rax");
+        instr("movq", "%rax", operand(ctx, dst));
+    }
+    else
+    {
+        instr("movq", operand(ctx, src), operand(ctx, dst));
+    }
+}
+
 // =============================
 // Implementación helpers
 // =============================
-void generateInstruction(IRCode *inst, Symbol *current_method)
+void generateInstruction(CompilerContext *ctx, IRCode *inst, Symbol *current_method)
 {
     switch (inst->op)
     {
     case IR_LOAD:
-        generateLoad(inst);
+        generateLoad(ctx, inst);
         break;
     case IR_METH_EXT:
+    case IR_NOP:
         break;
     case IR_PARAM:
-        generateParam(inst);
+        generateParam(ctx, inst);
         break;
     case IR_SAVE_PARAM:
-        generateSaveParam(inst);
+        generateSaveParam(ctx, inst);
         break;
     case IR_STORAGE:
-        generateStorage(inst);
+        generateStorage(ctx, inst);
         break;
     case IR_STORE:
-        generateAssign(inst);
+        generateAssign(ctx, inst);
         break;
     case IR_ADD:
-        generateBinaryOp(inst, "addq");
+        generateBinaryOp(ctx, inst, "addq");
         break;
     case IR_SUB:
-        generateBinaryOp(inst, "subq");
+        generateBinaryOp(ctx, inst, "subq");
         break;
     case IR_UMINUS:
-        generateUminus(inst);
+        generateUminus(ctx, inst);
         break;
     case IR_MUL:
-        generateBinaryOp(inst, "imulq");
+        generateBinaryOp(ctx, inst, "imulq");
         break;
     case IR_DIV:
-        generateBinaryOp(inst, "idivq");
+        generateBinaryOp(ctx, inst, "idivq");
         break;
 
     case IR_MOD:
-        generateBinaryOp(inst, "modq");
+        generateBinaryOp(ctx, inst, "modq");
         break;
 
     case IR_DECL:
         break; // implementar para locales
 
     case IR_CALL:
-        generateCall(inst);
+        generateCall(ctx, inst);
         break;
     // Operadores de comparacion
     case IR_EQ:
-        generateCompare(inst, "sete");
+        generateCompare(ctx, inst, "sete");
         break;
     case IR_NEQ:
-        generateCompare(inst, "setne");
+        generateCompare(ctx, inst, "setne");
         break;
     case IR_LT:
-        generateCompare(inst, "setl");
+        generateCompare(ctx, inst, "setl");
         break;
     case IR_LE:
-        generateCompare(inst, "setle");
+        generateCompare(ctx, inst, "setle");
         break;
     case IR_GT:
-        generateCompare(inst, "setg");
+        generateCompare(ctx, inst, "setg");
         break;
     case IR_GE:
-        generateCompare(inst, "setge");
+        generateCompare(ctx, inst, "setge");
         break;
 
         // Operadores Logicos
 
     case IR_AND:
-        generateLogicalOp(inst, "andq");
+        generateLogicalOp(ctx, inst, "andq");
         break;
     case IR_OR:
-        generateLogicalOp(inst, "orq");
+        generateLogicalOp(ctx, inst, "orq");
         break;
     case IR_NOT:
-        generateLogicalOp(inst, "notq");
+        generateLogicalOp(ctx, inst, "xorq");
         break;
 
     case IR_FMETHOD:
     case IR_LABEL:
-        generateLabel(inst);
+        generateLabel(ctx, inst);
         break;
     case IR_METHOD:
-        generateLabel(inst);
-        generateEnter(inst);
+        generateLabel(ctx, inst);
+        generateEnter(ctx, inst);
         break;
     case IR_GOTO:
-        generateGoto(inst);
+        generateGoto(ctx, inst);
+        break;
+    // Saltos con comparación
+    case IR_JEQ:
+        generateCondJump(ctx, inst, "je");
+        break;
+    case IR_JNE:
+        generateCondJump(ctx, inst, "jne");
+        break;
+    case IR_JLT:
+        generateCondJump(ctx, inst, "jl");
+        break;
+    case IR_JLE:
+        generateCondJump(ctx, inst, "jle");
+        break;
+    case IR_JGT:
+        generateCondJump(ctx, inst, "jg");
+        break;
+    case IR_JGE:
+        generateCondJump(ctx, inst, "jge");
         break;
     case IR_RETURN:
-        generateReturn(inst, current_method);
+        generateReturn(ctx, inst, current_method);
         break;
     default:
-        printf("    # [WARN] Operación IR no implementada: %d\n", inst->op);
+        emit("    # [WARN] Operación IR no implementada: %d\n", inst->op);
         break;
     }
 }
 
-void generateLoad(IRCode *inst)
+void generateLoad(CompilerContext *ctx, IRCode *inst)
 {
-    Symbol *src = inst->arg1;
-    Symbol *dst = inst->result;
-
-    if (src->is_param == 1)
-    {
-        printf("    # Carga el valor del parámetro '%s' en un temporal AAAAAAAAAAAAAAAAAAAAAAA\n", src->name);
-
-        printf("    movq %d(%%rbp), %%rax\n", src->offset);
-
-        printf("    movq %%rax, %d(%%rbp)\n", dst->offset);
+    IROperand src = inst->arg1;
+    IROperand dst = inst->result;
+    Symbol *var = ir_symbol(ctx, src);
 
-        printf("\n");
-    }
+    if (var && var->is_param == 1)
+        emit("    # Carga el valor del parámetro '%s' en un temporal\n", var->name);
     else
-    {
-
-        printf("    # Carga el valor de la variable '%s' en un temporal\n", src->name);
-
-        // Cargar en %rax
-        if (src->is_global)
-            printf("    movq %s(%%rip), %%rax\n", src->name);
-        else
-            printf("    movq %d(%%rbp), %%rax\n", src->offset);
+        emit("    # Carga el valor de la variable '%s' en un temporal\n", name(ctx, src));
 
-        // Guardar en destino
-        if (dst->is_global)
-            printf("    movq %%rax, %s(%%rip)\n", dst->name);
-        else
-            printf("    movq %%rax, %d(%%rbp)\n", dst->offset);
-
-        printf("\n");
-    }
+    emit_move(ctx, src, dst);
+    emit("\n");
 }
 
-void generateCall(IRCode *inst)
+void generateCall(CompilerContext *ctx, IRCode *inst)
 {
-    Symbol *a = inst->arg1; // nombre de la función
-    Symbol *r = inst->result;
-    int flag = 0; // si se debe alinear la pila
+    Symbol *a = ir_symbol(ctx, inst->arg1); // la función
+    IROperand r = inst->result;
+    int n = a->param_count;
+
+    // Los argumentos de esta llamada son los últimos n PARAM pendientes
+    PendingParam *args = &ctx->pending_params[ctx->pending_count - n];
+    ctx->pending_count -= n;
+
+    // Parámetros 7+ por la pila, de derecha a izquierda. Si son impares se
+    // agrega antes un relleno para que %rsp quede alineado a 16 en el call.
+    int stack_args = (n > 6) ? n - 6 : 0;
+    int padding = (stack_args % 2 != 0) ? 8 : 0;
+    if (padding)
+    {
+        emit("    ## Corregir alineamiento ##\n");
+        instr("subq", "$8", "%rsp");
+    }
+    for (int k = 0; k < n; k++)
+    {
+        if (args[k].index >= 6)
+            instr("pushq", operand(ctx, args[k].value), NULL);
+    }
 
-    // Alinear la pila para parametros impares y cantidad mayor a 6.
-    if (a->param_count > 6 && a->param_count % 2 != 0)
+    // Parámetros 1-6 por registro, recién ahora para que una llamada anidada
+    // en los argumentos no los pise
+    for (int k = 0; k < n; k++)
     {
-        printf("    ## Corregir alineamiento ##");
-        printf("    subq $8, %%rsp\n");
-        flag = 1;
+        if (args[k].index < PARAM_REGISTER_COUNT)
+            instr("movq", operand(ctx, args[k].value), PARAM_REGISTERS[args[k].index]);
     }
+
     // Llamar a la función
-    printf("    # Llamada a la función '%s'\n", a->name);
-    printf("    call %s\n", a->name);
+    emit("    # Llamada a la función '%s'\n", a->name);
+    instr("call", a->name, NULL);
 
     // Limpiar la pila
-    if (flag) {
-        printf("    ## Limpieza ##");
-        printf("    addq $16, %%rsp\n");
+    if (stack_args || padding)
+    {
+        emit("    ## Limpieza ##\n");
+        instr("addq", imm(stack_args * 8 + padding), "%rsp");
     }
-    
+
     // Guardar el valor de retorno (en %%rax)
-    if (r) {
-        printf("    # Guardar el valor de retorno (desde RAX)\n");
-        if (r->is_global)
-            printf("    movq %%rax, %s(%%rip)\n", r->name);
-        else
-            printf("    movq %%rax, %d(%%rbp)\n", r->offset);
+    if (ir_has(r))
+    {
+        emit("    # Guardar el valor de retorno (desde RAX)\n");
+        instr("movq", "%rax", operand(ctx, r));
     }
-    printf("\n");
+    emit("\n");
 }
 
-void generateEnter(IRCode *inst)
+void generateEnter(CompilerContext *ctx, IRCode *inst)
 {
-    int space = inst->result ? inst->result->total_stack_space : 0;
+    Symbol *method = ir_symbol(ctx, inst->result);
+    int space = method ? method->total_stack_space : 0;
     if (space % 16 != 0)
     {
         space += 8;
     }
-    printf("    # Prólogo del método: crear stack frame y reservar %d bytes\n", space);
-    printf("    enter $(%d), $0\n", space);
-    printf("\n");
+    emit("    # Prólogo del método: crear stack frame y reservar %d bytes\n", space);
+    if (space <= 0xFFFF)
+    {
+        char size[32];
+        snprintf(size, sizeof(size), "$(%d)", space);
+        instr("enter", size, "$0");
+    }
+    else
+    {
+        // enter solo lleva 16 bits de tamaño: lo mismo en tres instrucciones (como x86_enter)
+        instr("pushq", "%rbp", NULL);
+        instr("movq", "%rsp", "%rbp");
+        instr("subq", imm(space), "%rsp");
+    }
+
+    // Preservar los registros callee-saved que usa el allocator
+    int offset = method ? method->saved_regs_offset : 0;
+    for (int i = 0; method && i < CALLEE_SAVED_COUNT; i++)
+    {
+        if (method->saved_regs & (1 << i))
+        {
+            instr("movq", CALLEE_SAVED_REGISTERS[i], rbp_slot(offset));
+            offset -= 8;
+        }
+    }
+    emit("\n");
 }
 
 // =============================
 // Operaciones binarias
 // =============================
-// Se necesita un contador global o estático para generar etiquetas únicas
-static int div_label_count = 0;
+// Las etiquetas del chequeo de división se numeran en el contexto (ctx->div_label_count)
+// y llevan el número de unidad: cada método numera las suyas desde 0
 
-void generateBinaryOp(IRCode *inst, const char *op)
+void generateBinaryOp(CompilerContext *ctx, IRCode *inst, const char *op)
 {
-    Symbol *a = inst->arg1;
-    Symbol *b = inst->arg2;
-    Symbol *r = inst->result;
+    IROperand a = inst->arg1;
+    IROperand b = inst->arg2;
+    IROperand r = inst->result;
 
     // --- MANEJO ESPECIAL PARA DIVISIÓN Y MÓDULO ---
     if (strcmp(op, "idivq") == 0 || strcmp(op, "modq") == 0)
     {
-        int current_label = div_label_count++; // Etiqueta única para este bloque
+        int current_label = ctx->div_label_count++; // Etiqueta única para este bloque
 
-        printf("    # --- Inicio de bloque de división/módulo ---\n");
-        printf("    # Verificar si el divisor es cero\n");
+        emit("    # --- Inicio de bloque de división/módulo ---\n");
+        emit("    # Verificar si el divisor es cero\n");
 
         // 1. Cargar el DIVISOR y compararlo con cero
-        if (b->is_global)
-            printf("    movq %s(%%rip), %%rcx\n", b->name); // Usamos %rcx como registro temporal
-        else
-            printf("    movq %d(%%rbp), %%rcx\n", b->offset);
+        instr("movq", operand(ctx, b), "%rcx"); // Usamos %rcx como registro temporal
 
-        printf("    cmpq $0, %%rcx\n");
-        printf("    je _division_by_zero_error_%d\n", current_label); // Si es cero, saltar
-        printf("\n");
+        char error_label[64], ok_label[64];
+        snprintf(error_label, sizeof(error_label), "_division_by_zero_error_%d_%d", ctx->unit, current_label);
+        snprintf(ok_label, sizeof(ok_label), "_division_ok_%d_%d", ctx->unit, current_label);
+        instr("cmpq", "$0", "%rcx");
+        instr("je", error_label, NULL); // Si es cero, saltar
+        emit("\n");
 
-        printf("    # Realizar la operación de división\n");
+        emit("    # Realizar la operación de división\n");
         // 2. Si no es cero, proceder con la operación normal
-        if (a->is_global)
-            printf("    movq %s(%%rip), %%rax\n", a->name);
-        else
-            printf("    movq %d(%%rbp), %%rax\n", a->offset);
-
-        printf("    cqto\n");
-        printf("    idiv %%rcx\n"); // Dividir por el registro %rcx
-        printf("\n");
+        instr("movq", operand(ctx, a), "%rax");
+        instr("cqto", NULL, NULL);
+        instr("idiv", "%rcx", NULL); // Dividir por el registro %rcx
+        emit("\n");
         // 3. Guardar el resultado correcto (cociente o resto)
-        const char *result_reg = (strcmp(op, "mod") == 0) ? "%rdx" : "%rax";
-        const char *op_name = (strcmp(op, "mod") == 0) ? "Módulo (%)" : "División (/)";
-        printf("    # Guardar el resultado de la operación '%s'\n", op_name);
-        if (r->is_global)
-            printf("    movq %s, %s(%%rip)\n", result_reg, r->name);
-        else
-            printf("    movq %s, %d(%%rbp)\n", result_reg, r->offset);
-
-        printf("    jmp _division_ok_%d\n", current_label);
-        printf("\n");
+        const char *result_reg = (strcmp(op, "modq") == 0) ? "%rdx" : "%rax";
+        const char *op_name = (strcmp(op, "modq") == 0) ? "Módulo (%)" : "División (/)";
+        emit("    # Guardar el resultado de la operación '%s'\n", op_name);
+        instr("movq", result_reg, operand(ctx, r));
+
+        instr("jmp", ok_label, NULL);
+        emit("\n");
         // 4. Bloque de manejo de error
-        printf("_division_by_zero_error_%d:\n", current_label);
+        asm_label(&ctx->asm_out, error_label);
         // terminamos el programa.
-        printf("    movl $136, %%edi\n");
-        printf("    call exit\n");
-        printf("\n");
-        printf("_division_ok_%d:\n", current_label);
-        printf("    # --- Fin de bloque de división/módulo ---\n");
-        printf("\n");
+        instr("movl", "$136", "%edi");
+        instr("call", "exit", NULL);
+        emit("\n");
+        asm_label(&ctx->asm_out, ok_label);
+        emit("    # --- Fin de bloque de división/módulo ---\n");
+        emit("\n");
         return;
     }
 
     // --- CÓDIGO ORIGINAL PARA OTRAS OPERACIONES (add, sub, imul) ---
     // (Este código está bien y no necesita cambios)
-    printf("    # Operación binaria: %s\n", op);
-    if (a->is_global)
-        printf("    movq %s(%%rip), %%rax\n", a->name);
-    else
-        printf("    movq %d(%%rbp), %%rax\n", a->offset);
-
-    if (b->is_global)
-        printf("    %s %s(%%rip), %%rax\n", op, b->name);
-    else
-        printf("    %s %d(%%rbp), %%rax\n", op, b->offset);
-
-    if (r->is_global)
-        printf("    movq %%rax, %s(%%rip)\n", r->name);
-    else
-        printf("    movq %%rax, %d(%%rbp)\n", r->offset);
+    emit("    # Operación binaria: %s\n", op);
+    instr("movq", operand(ctx, a), "%rax");
+    instr(op, operand(ctx, b), "%rax");
+    instr("movq", "%rax", operand(ctx, r));
 
-    printf("\n");
+    emit("\n");
 }
 
 /**
  * Genera el código assembly para la operación de menos unario (negación).
  * IR: UMINUS src, NULL, dest  (ej. dest = -src)
  */
-void generateUminus(IRCode *inst)
+void generateUminus(CompilerContext *ctx, IRCode *inst)
 {
-    Symbol *src = inst->arg1;    // Símbolo de origen (el que se va a negar)
-    Symbol *dest = inst->result; // Símbolo de destino (donde se guarda el resultado)
-    printf("    # Operación unaria: negación de '%s'\n", src->name);
+    IROperand src = inst->arg1;    // operando de origen (el que se va a negar)
+    IROperand dest = inst->result; // destino (donde se guarda el resultado)
+    emit("    # Operación unaria: negación de '%s'\n", name(ctx, src));
     // 1. Cargar el valor del operando 'src' en el registro %rax.
-    if (src->is_global)
-    {
-        printf("    movq %s(%%rip), %%rax\n", src->name);
-    }
-    else
-    {
-        printf("    movq %d(%%rbp), %%rax\n", src->offset);
-    }
+    instr("movq", operand(ctx, src), "%rax");
 
     // 2. Aplicar la instrucción NEG a %rax.
     // Esto calcula el complemento a dos del valor en el registro.
-    printf("    negq %%rax\n");
+    instr("negq", "%rax", NULL);
 
     // 3. Guardar el resultado (que ahora está en %rax) en el destino 'dest'.
-    if (dest->is_global)
-    {
-        printf("    movq %%rax, %s(%%rip)\n", dest->name);
-    }
-    else
-    {
-        printf("    movq %%rax, %d(%%rbp)\n", dest->offset);
-    }
+    instr("movq", "%rax", operand(ctx, dest));
 
-    printf("\n");
+    emit("\n");
 }
 
-void generateLogicalOp(IRCode *inst, const char *op)
+void generateLogicalOp(CompilerContext *ctx, IRCode *inst, const char *op)
 {
-    Symbol *a = inst->arg1;
-    Symbol *b = inst->arg2;
-    Symbol *r = inst->result;
+    IROperand a = inst->arg1;
+    IROperand b = inst->arg2;
+    IROperand r = inst->result;
 
-    // === NOT bit a bit ===
-    if (strcmp(op, "notq") == 0)
+    // === NOT lógico (los booleanos valen 0 o 1) ===
+    if (strcmp(op, "xorq") == 0)
     {
-        printf("    # Operación lógica: NOT '%s'\n", a->name);
+        emit("    # Operación lógica: NOT '%s'\n", name(ctx, a));
         // Cargar arg1 en %rax
-        if (a->is_global)
-            printf("    movq %s(%%rip), %%rax\n", a->name);
-        else
-            printf("    movq %d(%%rbp), %%rax\n", a->offset);
+        instr("movq", operand(ctx, a), "%rax");
 
-        // Aplicar NOT bit a bit
-        printf("    notq %%rax\n");
+        // Invertir el bit menos significativo: 1 -> 0, 0 -> 1
+        instr("xorq", "$1", "%rax");
 
         // Guardar resultado
-        if (r->is_global)
-            printf("    movq %%rax, %s(%%rip)\n", r->name);
-        else
-            printf("    movq %%rax, %d(%%rbp)\n", r->offset);
+        instr("movq", "%rax", operand(ctx, r));
 
-        printf("\n");
+        emit("\n");
         return;
     }
 
     // === AND / OR ===
-    printf("    # Operación lógica: %s\n", op);
+    emit("    # Operación lógica: %s\n", op);
     // Cargar arg1 en %rax
-    if (a->is_global)
-        printf("    movq %s(%%rip), %%rax\n", a->name);
-    else
-        printf("    movq %d(%%rbp), %%rax\n", a->offset);
+    instr("movq", operand(ctx, a), "%rax");
 
     // Aplicar operación con arg2
-    if (b->is_global)
-        printf("    %s %s(%%rip), %%rax\n", op, b->name);
-    else
-        printf("    %s %d(%%rbp), %%rax\n", op, b->offset);
+    instr(op, operand(ctx, b), "%rax");
 
     // Guardar resultado
-    if (r->is_global)
-        printf("    movq %%rax, %s(%%rip)\n", r->name);
-    else
-        printf("    movq %%rax, %d(%%rbp)\n", r->offset);
+    instr("movq", "%rax", operand(ctx, r));
 
-    printf("\n");
+    emit("\n");
 }
 
-void generateCompare(IRCode *inst, const char *set_op)
+void generateCompare(CompilerContext *ctx, IRCode *inst, const char *set_op)
 {
-    Symbol *a = inst->arg1;
-    Symbol *b = inst->arg2;
-    Symbol *r = inst->result;
-
-    printf("    # Comparación\n");
-    // Cargar arg1 en %rax
-    if (a->is_global)
-        printf("    movq %s(%%rip), %%rax\n", a->name);
-    else
-        printf("    movq %d(%%rbp), %%rax\n", a->offset);
-
-    // Comparar con arg2
-    if (b->is_global)
-        printf("    cmpq %s(%%rip), %%rax\n", b->name);
-    else
-        printf("    cmpq %d(%%rbp), %%rax\n", b->offset);
-    printf("\n");
-    printf("    # Guardar resultado booleano de la comparación\n");
+    IROperand a = inst->arg1;
+    IROperand b = inst->arg2;
+    IROperand r = inst->result;
+
+    emit("    # Comparación\n");
+    // Cargar arg1 en %rax y comparar con arg2
+    instr("movq", operand(ctx, a), "%rax");
+    instr("cmpq", operand(ctx, b), "%rax");
+    emit("\n");
+    emit("    # Guardar resultado booleano de la comparación\n");
     // Guardar resultado (0 o 1)
-    printf("    %s %%al\n", set_op);
-    printf("    movzbq %%al, %%rax\n");
-    if (r->is_global)
-        printf("    movq %%rax, %s(%%rip)\n", r->name);
-    else
-        printf("    movq %%rax, %d(%%rbp)\n", r->offset);
-    printf("\n");
+    instr(set_op, "%al", NULL);
+    instr("movzbq", "%al", "%rax");
+    instr("movq", "%rax", operand(ctx, r));
+    emit("\n");
 }
 
 // =============================
 // STORAGE: carga un literal o temporal
 // =============================
-void generateStorage(IRCode *inst)
+void generateStorage(CompilerContext *ctx, IRCode *inst)
 {
-    Symbol *literal = inst->arg1; // El símbolo que contiene el valor literal.
-    Symbol *dest = inst->result;  // El temporal de destino en la pila.
+    int literal = inst->arg1.id;     // El valor literal (inmediato en la instrucción).
+    IROperand dest = inst->result;   // El temporal de destino (registro o pila).
 
-    printf("    # Almacena el valor literal %d en el temporal '%s'\n", literal->valor.value, dest->name);
-    // Genera la instrucción para mover el valor inmediato al offset del temporal.
-    printf("    movq $%d, %d(%%rbp)\n", literal->valor.value, dest->offset);
-    printf("\n");
+    emit("    # Almacena el valor literal %d en el temporal '%s'\n", literal, name(ctx, dest));
+    // Genera la instrucción para mover el valor inmediato al destino.
+    instr("movq", imm(literal), operand(ctx, dest));
+    emit("\n");
 }
 
 // =============================
 // ASSIGN: asigna valor de una variable o temporal
 // =============================
-void generateAssign(IRCode *inst)
+void generateAssign(CompilerContext *ctx, IRCode *inst)
 {
-    Symbol *a = inst->arg1; // DEBERIA SER RAX
-    Symbol *r = inst->result;
-    printf("    # Asignación: '%s' = '%s'\n", r->name, a->name);
+    IROperand a = inst->arg1;
+    IROperand r = inst->result;
+    emit("    # Asignación: '%s' = '%s'\n", name(ctx, r), name(ctx, a));
 
-    if (a->is_global)
-    {
-        printf("    movq %s(%%rip), %%rax\n", a->name);
-    }
-    else
-    {
-        printf("    movq %d(%%rbp), %%rax\n", a->offset);
-    }
-    // Guardar valor en destino
-    if (r->is_global)
-    {
-        printf("    movq %%rax, %s(%%rip)\n", r->name);
-    }
-    else
-    {
-        printf("    movq %%rax, %d(%%rbp)\n", r->offset);
-    }
-    printf("\n");
+    emit_move(ctx, a, r);
+    emit("\n");
 }
 
 // =============================
 // Labels y Goto
 // =============================
-void generateLabel(IRCode *inst)
+void generateLabel(CompilerContext *ctx, IRCode *inst)
 {
     if (inst->op == IR_FMETHOD)
-        printf("f%s:\n", inst->result->name);
+        emit("f%s:\n", name(ctx, inst->result));
     else
-        printf("%s:\n", inst->result->name);
-    printf("\n");
+        asm_label(&ctx->asm_out, name(ctx, inst->result));
+    emit("\n");
 }
 
-void generateGoto(IRCode *inst)
+void generateGoto(CompilerContext *ctx, IRCode *inst)
 {
-    if (inst->arg1 != NULL)
+    const char *label = name(ctx, inst->result);
+    if (ir_has(inst->arg1))
     {
-        if (inst->arg1->is_global)
-        {
-            char *name = inst->arg1->name;
-            printf("    cmpq $1, %s(%%rip);\n", name);
-        }
-        else
-        {
-            int offset = inst->arg1->offset;
-            printf("    cmpq $1, %d(%%rbp);\n", offset);
-        }
-
-        printf("    # Salto CONDICIONAL a la etiqueta '%s'\n", inst->result->name);
-        printf("    jne %s\n", inst->result->name);
+        instr("cmpq", "$1", operand(ctx, inst->arg1));
+        emit("    # Salto CONDICIONAL a la etiqueta '%s'\n", label);
+        instr("jne", label, NULL);
     }
     else
     {
-        printf("    # Salto INCONDICIONAL a la etiqueta '%s'\n", inst->result->name);
-        printf("    jmp %s\n", inst->result->name);
+        emit("    # Salto INCONDICIONAL a la etiqueta '%s'\n", label);
+        instr("jmp", label, NULL);
     }
-    printf("\n");
+    emit("\n");
+}
+
+// Compara los dos operandos y salta según los flags, sin materializar el booleano
+void generateCondJump(CompilerContext *ctx, IRCode *inst, const char *jump_op)
+{
+    const char *label = name(ctx, inst->result);
+    emit("    # Comparación y salto a la etiqueta '%s'\n", label);
+    instr("movq", operand(ctx, inst->arg1), "%rax");
+    instr("cmpq", operand(ctx, inst->arg2), "%rax");
+    instr(jump_op, label, NULL);
+    emit("\n");
 }
 
 // =============================
 //  Return
 // =============================
-void generateReturn(IRCode *inst, Symbol *current_method)
+void generateReturn(CompilerContext *ctx, IRCode *inst, Symbol *current_method)
 {
-    printf("    # Preparando el retorno de la función\n");
+    emit("    # Preparando el retorno de la función\n");
     int is_main = 0;
     if (current_method && strcmp(current_method->name, "main") == 0)
     {
         is_main = 1;
     }
 
-    if (inst->arg1 != NULL)
+    if (ir_has(inst->arg1))
     {
         if (is_main) {
-            printf("    # Retorno explícito de main\n");
+            emit("    # Retorno explícito de main\n");
         }
-        Symbol *arg = inst->arg1;
-        if (arg->is_global)
-            printf("    movq %s(%%rip), %%rax\n", arg->name);
-        else
-            printf("    movq %d(%%rbp), %%rax\n", arg->offset);
+        instr("movq", operand(ctx, inst->arg1), "%rax");
     } else {
         if (is_main)
         {
-            printf("    # Forzando 'exit code 0' para main (sin valor explícito)\n");
-            printf("    movq $0, %%rax\n");
+            emit("    # Forzando 'exit code 0' para main (sin valor explícito)\n");
+            instr("movq", "$0", "%rax");
         }
     }
-    printf("    leave\n");
-    printf("    ret\n");
-    printf("\n");
+
+    // Restaurar los registros callee-saved preservados en el prólogo
+    int offset = current_method ? current_method->saved_regs_offset : 0;
+    for (int i = 0; current_method && i < CALLEE_SAVED_COUNT; i++)
+    {
+        if (current_method->saved_regs & (1 << i))
+        {
+            instr("movq", rbp_slot(offset), CALLEE_SAVED_REGISTERS[i]);
+            offset -= 8;
+        }
+    }
+    instr("leave", NULL, NULL);
+    instr("ret", NULL, NULL);
+    emit("\n");
 }
 
 // no hay instruccion load equivalente sino que se contempla cuando se reserva espacio al inicio del metodo con enter.
 
 /**
- * Genera el código para pasar un temporal evaluado como parámetro
- * a una función.
- * IR: IR_PARAM <temp_con_valor>, <sym_con_indice>, NULL
+ * Registra un temporal evaluado como parámetro de la próxima llamada.
+ * IR: IR_PARAM <temp_con_valor>, <índice del argumento> (inmediato)
+ * No emite código: generateCall carga todos los argumentos juntos, así
+ * una llamada anidada dentro de otro argumento no pisa los registros.
  */
-void generateParam(IRCode *inst)
+void generateParam(CompilerContext *ctx, IRCode *inst)
 {
-    Symbol *src_temp = inst->arg1;   // Temporal que contiene el valor
-    Symbol *param_info = inst->arg2; // Símbolo "dummy" que contiene el índice
-    int index = param_info->valor.value;
-
-    printf("    # Pasa el temporal '%s' (desde %d(%%rbp)) como parámetro %d\n",
-           src_temp->name, src_temp->offset, index);
-
-    if (index < 6)
-    {
-        // Parámetro 0-5: Mover de la pila temporal al registro
-        // Asumo que PARAM_REGISTERS[] es {"%rdi", "%rsi", ...}
-        const char *reg = PARAM_REGISTERS[index];
-        printf("    movq %d(%%rbp), %s\n", src_temp->offset, reg);
-    }
-    else
+    if (ctx->pending_count == ctx->pending_capacity)
     {
-        // Parámetro 6+: Mover de la pila temporal a la pila de argumentos
-        // (vía %rax)
-        printf("    movq %d(%%rbp), %%rax\n", src_temp->offset);
-        printf("    pushq %%rax\n");
+        ctx->pending_capacity = ctx->pending_capacity ? ctx->pending_capacity * 2 : 16;
+        ctx->pending_params = realloc(ctx->pending_params, ctx->pending_capacity * sizeof(PendingParam));
     }
-    printf("\n");
+    ctx->pending_params[ctx->pending_count].value = inst->arg1;
+    ctx->pending_params[ctx->pending_count].index = inst->arg2.id;
+    ctx->pending_count++;
 }
 
 /**
  * Guarda un parámetro que llegó por registro en su slot de la pila
  */
-void generateSaveParam(IRCode *inst)
+void generateSaveParam(CompilerContext *ctx, IRCode *inst)
 {
-    Symbol *param_sym = inst->arg1;
+    Symbol *param_sym = ir_symbol(ctx, inst->arg1);
 
     if (!param_sym || !param_sym->is_param || param_sym->param_index >= 6)
     {
@@ -853,8 +927,8 @@ void generateSaveParam(IRCode *inst)
 
     const char *reg = PARAM_REGISTERS[param_sym->param_index];
 
-    printf("    # Guardar parámetro '%s' (desde %s) en su stack slot\n",
+    emit("    # Guardar parámetro '%s' (desde %s) en su stack slot\n",
            param_sym->name, reg);
-    printf("    movq %s, %d(%%rbp)\n", reg, param_sym->offset);
-    printf("\n");
+    instr("movq", reg, operand(ctx, inst->arg1));
+    emit("\n");
 }
\ No newline at end of file
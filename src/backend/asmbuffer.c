@@ -0,0 +1,207 @@
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "AsmBuffer.h"
+
+// Los bloques empiezan chicos (hay una unidad por método) y se duplican hasta el máximo
+#define CHUNK_MIN_BYTES (4 * 1024)
+#define CHUNK_MAX_BYTES (64 * 1024)
+
+struct AsmChunk {
+    AsmChunk *next;
+    size_t used;
+    size_t size;
+    char data[];
+};
+
+void asm_init(AsmBuffer *buf) {
+    buf->lines = NULL;
+    buf->size = 0;
+    buf->capacity = 0;
+    buf->chunks = NULL;
+    buf->partial = NULL;
+}
+
+void asm_free(AsmBuffer *buf) {
+    while (buf->chunks) {
+        AsmChunk *next = buf->chunks->next;
+        free(buf->chunks);
+        buf->chunks = next;
+    }
+    free(buf->lines);
+    free(buf->partial);
+    asm_init(buf);
+}
+
+/* Copia [start, end) en el bloque actual (o en uno nuevo si no entra) */
+static const char *copy_text(AsmBuffer *buf, const char *start, const char *end) {
+    size_t len = end - start;
+    AsmChunk *c = buf->chunks;
+    if (!c || c->used + len + 1 > c->size) {
+        size_t size = !c ? CHUNK_MIN_BYTES : c->size < CHUNK_MAX_BYTES / 2 ? c->size * 2 : CHUNK_MAX_BYTES;
+        if (size < len + 1) size = len + 1;
+        c = malloc(sizeof(AsmChunk) + size);
+        c->next = buf->chunks;
+        c->used = 0;
+        c->size = size;
+        buf->chunks = c;
+    }
+    char *s = c->data + c->used;
+    memcpy(s, start, len);
+    s[len] = '\0';
+    c->used += len + 1;
+    return s;
+}
+
+/* Como copy_text, sin los espacios de los extremos */
+static const char *copy_trimmed(AsmBuffer *buf, const char *start, const char *end) {
+    while (start < end && isspace((unsigned char)*start)) start++;
+    while (end > start && isspace((unsigned char)end[-1])) end--;
+    return copy_text(buf, start, end);
+}
+
+/* Separa "op a, b" en sus partes; las comas dentro de paréntesis no cuentan */
+static void parse_instruction(AsmBuffer *buf, AsmLine *line, const char *start, const char *end) {
+    const char *p = start;
+    while (p < end && !isspace((unsigned char)*p)) p++;
+    line->op = copy_text(buf, start, p);
+
+    while (p < end && isspace((unsigned char)*p)) p++;
+    if (p == end) return;
+
+    const char *comma = NULL;
+    int depth = 0;
+    for (const char *q = p; q < end && !comma; q++) {
+        if (*q == '(') depth++;
+        else if (*q == ')') depth--;
+        else if (*q == ',' && depth == 0) comma = q;
+    }
+    if (comma) {
+        line->src = copy_trimmed(buf, p, comma);
+        line->dst = copy_trimmed(buf, comma + 1, end);
+    } else {
+        line->src = copy_trimmed(buf, p, end);
+    }
+}
+
+static AsmLine *new_line(AsmBuffer *buf, AsmKind kind) {
+    if (buf->size == buf->capacity) {
+        buf->capacity = buf->capacity ? buf->capacity * 2 : 256;
+        buf->lines = realloc(buf->lines, buf->capacity * sizeof(AsmLine));
+    }
+    AsmLine *line = &buf->lines[buf->size++];
+    memset(line, 0, sizeof(AsmLine));
+    line->kind = kind;
+    return line;
+}
+
+static void add_line(AsmBuffer *buf, const char *start, const char *end) {
+    const char *first = start, *last = end;
+    while (first < last && isspace((unsigned char)*first)) first++;
+    while (last > first && isspace((unsigned char)last[-1])) last--;
+
+    if (first == last || *first == '#' || *first == '.') {
+        // Se conserva la indentación original de comentarios y directivas
+        new_line(buf, ASM_TEXT)->text = copy_text(buf, start, end);
+    } else if (last[-1] == ':' && !memchr(first, ' ', last - first)) {
+        new_line(buf, ASM_LABEL)->text = copy_text(buf, first, last - 1);
+    } else {
+        parse_instruction(buf, new_line(buf, ASM_INSTR), first, last);
+    }
+}
+
+void asm_emit(AsmBuffer *buf, const char *fmt, ...) {
+    // Casi todas las líneas entran en el buffer local: se formatea una sola vez
+    char local[256];
+    size_t prev = buf->partial ? strlen(buf->partial) : 0;
+    char *text = local;
+    if (prev) {
+        if (prev >= sizeof(local)) text = malloc(prev + 1);
+        memcpy(text, buf->partial, prev);
+    }
+
+    va_list args;
+    va_start(args, fmt);
+    size_t room = text == local ? sizeof(local) - prev : 0;
+    int len = vsnprintf(text + prev, room, fmt, args);
+    va_end(args);
+    if ((size_t)len >= room) {
+        char *big = malloc(prev + len + 1);
+        memcpy(big, text, prev);
+        if (text != local) free(text);
+        text = big;
+        va_start(args, fmt);
+        vsnprintf(text + prev, len + 1, fmt, args);
+        va_end(args);
+    }
+    free(buf->partial);
+    buf->partial = NULL;
+
+    char *start = text, *nl;
+    while ((nl = strchr(start, '\n')) != NULL) {
+        add_line(buf, start, nl);
+        start = nl + 1;
+    }
+    if (*start) buf->partial = strdup(start);
+    if (text != local) free(text);
+}
+
+void asm_instr(AsmBuffer *buf, const char *op, const char *src, const char *dst) {
+    AsmLine *line = new_line(buf, ASM_INSTR);
+    line->op = op;
+    if (src) line->src = copy_text(buf, src, src + strlen(src));
+    if (dst) line->dst = copy_text(buf, dst, dst + strlen(dst));
+}
+
+void asm_label(AsmBuffer *buf, const char *name) {
+    new_line(buf, ASM_LABEL)->text = copy_text(buf, name, name + strlen(name));
+}
+
+void asm_set_operand(AsmBuffer *buf, const char **operand, const char *text) {
+    *operand = copy_text(buf, text, text + strlen(text));
+}
+
+int asm_instruction_count(AsmBuffer *buf) {
+    int count = 0;
+    for (int i = 0; i < buf->size; i++)
+        if (!buf->lines[i].deleted && buf->lines[i].kind == ASM_INSTR) count++;
+    return count;
+}
+
+int asm_line_count(AsmBuffer *buf) {
+    int count = 0;
+    for (int i = 0; i < buf->size; i++)
+        if (!buf->lines[i].deleted) count++;
+    return count;
+}
+
+void asm_write(AsmBuffer *buf, OutBuffer *out) {
+    for (int i = 0; i < buf->size; i++) {
+        AsmLine *line = &buf->lines[i];
+        if (line->deleted) continue;
+        switch (line->kind) {
+            case ASM_TEXT:
+                out_puts(out, line->text);
+                break;
+            case ASM_LABEL:
+                out_puts(out, line->text);
+                out_putc(out, ':');
+                break;
+            case ASM_INSTR:
+                out_write(out, "    ", 4);
+                out_puts(out, line->op);
+                if (line->src) {
+                    out_putc(out, ' ');
+                    out_puts(out, line->src);
+                }
+                if (line->dst) {
+                    out_write(out, ", ", 2);
+                    out_puts(out, line->dst);
+                }
+                break;
+        }
+        out_putc(out, '\n');
+    }
+    if (buf->partial) out_puts(out, buf->partial);
+}
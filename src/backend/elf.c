@@ -0,0 +1,249 @@
+#include <stdlib.h>
+#include <string.h>
+#include <elf.h>
+#include "Elf.h"
+#include "SymbolMap.h"
+
+enum {
+    SEC_NULL,
+    SEC_TEXT,
+    SEC_DATA,
+    SEC_BSS,
+    SEC_RELA_TEXT,
+    SEC_SYMTAB,
+    SEC_STRTAB,
+    SEC_SHSTRTAB,
+    SEC_NOTE_STACK,         // pila no ejecutable, como lo que agrega gcc
+    SEC_COUNT
+};
+
+typedef struct {
+    OutBuffer data;         // contenido de .data
+    int bss_size;
+    OutBuffer symtab;
+    OutBuffer strtab;
+    OutBuffer rela;
+    int symbol_count;
+    int first_global;       // en .symtab van primero las locales
+
+    SymbolMap methods;      // método -> offset en .text
+    SymbolMap globals;      // global -> índice en .symtab
+    SymbolMap externs;      // externo -> índice en .symtab
+    int exit_symbol;        // el 'exit' de la división por cero, o 0
+} ElfWriter;
+
+static int add_string(OutBuffer *strtab, const char *s) {
+    int offset = (int)strtab->size;
+    out_write(strtab, s, strlen(s) + 1);
+    return offset;
+}
+
+static int add_symbol(ElfWriter *w, const char *name, int bind, int type, int section, long value, long size) {
+    Elf64_Sym sym = { 0 };
+    sym.st_name = add_string(&w->strtab, name);
+    sym.st_info = ELF64_ST_INFO(bind, type);
+    sym.st_shndx = section;
+    sym.st_value = value;
+    sym.st_size = size;
+    out_write(&w->symtab, (const char *)&sym, sizeof(sym));
+    return w->symbol_count++;
+}
+
+static void add_rela(ElfWriter *w, long offset, int symbol, int type, long addend) {
+    Elf64_Rela rela = { offset, ELF64_R_INFO(symbol, type), addend };
+    out_write(&w->rela, (const char *)&rela, sizeof(rela));
+}
+
+static void pad(OutBuffer *out, size_t alignment) {
+    static const char zeros[16] = { 0 };
+    if (out->size % alignment) out_write(out, zeros, alignment - out->size % alignment);
+}
+
+// =============================
+// Símbolos
+// =============================
+
+/*
+ * Como en el assembly: los métodos y las globales son locales del .o (en
+ * el .s no llevan .globl) salvo main; los externos quedan sin definir. Las
+ * globales en cero van a .bss como símbolos locales en lugar de .comm.
+ */
+static void add_symbols(ElfWriter *w, CompilerContext *ctx, const X86Code *text) {
+    add_symbol(w, "", STB_LOCAL, STT_NOTYPE, SHN_UNDEF, 0, 0);
+
+    int main_def = -1;
+    for (int i = 0; i < text->def_count; i++) {
+        const X86Def *def = &text->defs[i];
+        symmap_set(&w->methods, def->sym, def->offset);
+        int end = i + 1 < text->def_count ? text->defs[i + 1].offset : text->size;
+        if (strcmp(def->sym->name, "main") == 0) main_def = i;
+        else add_symbol(w, def->sym->name, STB_LOCAL, STT_FUNC, SEC_TEXT, def->offset, end - def->offset);
+    }
+
+    for (SymbolNode *n = ctx->decl_vars; n; n = n->next) {
+        int index;
+        if (n->valor != 0) {
+            long value = n->valor;
+            index = add_symbol(w, n->sym->name, STB_LOCAL, STT_OBJECT, SEC_DATA, (long)w->data.size, 8);
+            out_write(&w->data, (const char *)&value, 8);
+        } else {
+            index = add_symbol(w, n->sym->name, STB_LOCAL, STT_OBJECT, SEC_BSS, w->bss_size, 8);
+            w->bss_size += 8;
+        }
+        symmap_set(&w->globals, n->sym, index);
+    }
+
+    w->first_global = w->symbol_count;
+    if (main_def >= 0) {
+        const X86Def *def = &text->defs[main_def];
+        int end = main_def + 1 < text->def_count ? text->defs[main_def + 1].offset : text->size;
+        add_symbol(w, "main", STB_GLOBAL, STT_FUNC, SEC_TEXT, def->offset, end - def->offset);
+    }
+}
+
+static int extern_symbol(ElfWriter *w, const X86Reloc *reloc) {
+    int index;
+    if (!reloc->sym) {
+        if (!w->exit_symbol) w->exit_symbol = add_symbol(w, reloc->name, STB_GLOBAL, STT_NOTYPE, SHN_UNDEF, 0, 0);
+        return w->exit_symbol;
+    }
+    if (symmap_get(&w->externs, reloc->sym, &index)) return index;
+    index = add_symbol(w, reloc->name, STB_GLOBAL, STT_NOTYPE, SHN_UNDEF, 0, 0);
+    symmap_set(&w->externs, reloc->sym, index);
+    return index;
+}
+
+/*
+ * Las llamadas a métodos del archivo se completan acá, como hace as con
+ * las etiquetas locales; quedan reubicaciones para los externos (PLT32,
+ * así el linker puede pasar por la PLT) y para las globales (PC32).
+ */
+static void add_relocations(ElfWriter *w, const X86Code *text, unsigned char *bytes) {
+    for (int i = 0; i < text->reloc_count; i++) {
+        const X86Reloc *reloc = &text->relocs[i];
+        int target;
+        if (reloc->kind == X86_RELOC_DATA) {
+            symmap_get(&w->globals, reloc->sym, &target);
+            add_rela(w, reloc->offset, target, R_X86_64_PC32, reloc->addend);
+        } else if (reloc->sym && symmap_get(&w->methods, reloc->sym, &target)) {
+            int32_t rel = target + reloc->addend - reloc->offset;
+            memcpy(bytes + reloc->offset, &rel, sizeof(rel));
+        } else {
+            add_rela(w, reloc->offset, extern_symbol(w, reloc), R_X86_64_PLT32, reloc->addend);
+        }
+    }
+}
+
+// =============================
+// Archivo
+// =============================
+
+static void section_header(Elf64_Shdr *sh, int name, int type, long flags, long offset, long size,
+                           int link, int info, long align, long entsize) {
+    sh->sh_name = name;
+    sh->sh_type = type;
+    sh->sh_flags = flags;
+    sh->sh_offset = offset;
+    sh->sh_size = size;
+    sh->sh_link = link;
+    sh->sh_info = info;
+    sh->sh_addralign = align;
+    sh->sh_entsize = entsize;
+}
+
+/* Agrega el contenido de una sección alineado; devuelve su offset en el archivo */
+static long append_section(OutBuffer *file, const void *data, size_t size, size_t alignment) {
+    pad(file, alignment);
+    long offset = (long)file->size;
+    if (size) out_write(file, data, size);
+    return offset;
+}
+
+int elf_write_object(CompilerContext *ctx, const X86Code *text, FILE *out) {
+    ElfWriter w = { 0 };
+    out_init(&w.data);
+    out_init(&w.symtab);
+    out_init(&w.strtab);
+    out_init(&w.rela);
+    symmap_init(&w.methods);
+    symmap_init(&w.globals);
+    symmap_init(&w.externs);
+
+    unsigned char *bytes = malloc(text->size ? text->size : 1);
+    memcpy(bytes, text->bytes, text->size);
+    add_symbols(&w, ctx, text);
+    add_relocations(&w, text, bytes);
+
+    OutBuffer shstrtab;
+    out_init(&shstrtab);
+    int names[SEC_COUNT] = { add_string(&shstrtab, "") };
+    names[SEC_TEXT] = add_string(&shstrtab, ".text");
+    names[SEC_DATA] = add_string(&shstrtab, ".data");
+    names[SEC_BSS] = add_string(&shstrtab, ".bss");
+    names[SEC_RELA_TEXT] = add_string(&shstrtab, ".rela.text");
+    names[SEC_SYMTAB] = add_string(&shstrtab, ".symtab");
+    names[SEC_STRTAB] = add_string(&shstrtab, ".strtab");
+    names[SEC_SHSTRTAB] = add_string(&shstrtab, ".shstrtab");
+    names[SEC_NOTE_STACK] = add_string(&shstrtab, ".note.GNU-stack");
+
+    // Cabecera, contenido de las secciones y al final la tabla de secciones
+    OutBuffer file;
+    out_init(&file);
+    Elf64_Ehdr eh = { 0 };
+    out_write(&file, (const char *)&eh, sizeof(eh));
+    long text_off = append_section(&file, bytes, text->size, 16);
+    long data_off = append_section(&file, w.data.data, w.data.size, 8);
+    long rela_off = append_section(&file, w.rela.data, w.rela.size, 8);
+    long symtab_off = append_section(&file, w.symtab.data, w.symtab.size, 8);
+    long strtab_off = append_section(&file, w.strtab.data, w.strtab.size, 1);
+    long shstrtab_off = append_section(&file, shstrtab.data, shstrtab.size, 1);
+
+    Elf64_Shdr sh[SEC_COUNT];
+    memset(sh, 0, sizeof(sh));
+    section_header(&sh[SEC_TEXT], names[SEC_TEXT], SHT_PROGBITS, SHF_ALLOC | SHF_EXECINSTR,
+                   text_off, text->size, 0, 0, 16, 0);
+    section_header(&sh[SEC_DATA], names[SEC_DATA], SHT_PROGBITS, SHF_ALLOC | SHF_WRITE,
+                   data_off, w.data.size, 0, 0, 8, 0);
+    section_header(&sh[SEC_BSS], names[SEC_BSS], SHT_NOBITS, SHF_ALLOC | SHF_WRITE,
+                   data_off + w.data.size, w.bss_size, 0, 0, 8, 0);
+    section_header(&sh[SEC_RELA_TEXT], names[SEC_RELA_TEXT], SHT_RELA, SHF_INFO_LINK,
+                   rela_off, w.rela.size, SEC_SYMTAB, SEC_TEXT, 8, sizeof(Elf64_Rela));
+    section_header(&sh[SEC_SYMTAB], names[SEC_SYMTAB], SHT_SYMTAB, 0,
+                   symtab_off, w.symtab.size, SEC_STRTAB, w.first_global, 8, sizeof(Elf64_Sym));
+    section_header(&sh[SEC_STRTAB], names[SEC_STRTAB], SHT_STRTAB, 0,
+                   strtab_off, w.strtab.size, 0, 0, 1, 0);
+    section_header(&sh[SEC_SHSTRTAB], names[SEC_SHSTRTAB], SHT_STRTAB, 0,
+                   shstrtab_off, shstrtab.size, 0, 0, 1, 0);
+    section_header(&sh[SEC_NOTE_STACK], names[SEC_NOTE_STACK], SHT_PROGBITS, 0,
+                   shstrtab_off + shstrtab.size, 0, 0, 0, 1, 0);
+    long sh_off = append_section(&file, sh, sizeof(sh), 8);
+
+    memcpy(eh.e_ident, ELFMAG, SELFMAG);
+    eh.e_ident[EI_CLASS] = ELFCLASS64;
+    eh.e_ident[EI_DATA] = ELFDATA2LSB;
+    eh.e_ident[EI_VERSION] = EV_CURRENT;
+    eh.e_ident[EI_OSABI] = ELFOSABI_SYSV;
+    eh.e_type = ET_REL;
+    eh.e_machine = EM_X86_64;
+    eh.e_version = EV_CURRENT;
+    eh.e_shoff = sh_off;
+    eh.e_ehsize = sizeof(Elf64_Ehdr);
+    eh.e_shentsize = sizeof(Elf64_Shdr);
+    eh.e_shnum = SEC_COUNT;
+    eh.e_shstrndx = SEC_SHSTRTAB;
+    memcpy(file.data, &eh, sizeof(eh));
+
+    int result = out_flush(&file, out);
+
+    out_free(&file);
+    out_free(&shstrtab);
+    out_free(&w.data);
+    out_free(&w.symtab);
+    out_free(&w.strtab);
+    out_free(&w.rela);
+    symmap_free(&w.methods);
+    symmap_free(&w.globals);
+    symmap_free(&w.externs);
+    free(bytes);
+    return result;
+}
@@ -2,9 +2,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 
-SymbolNode *decl_vars = NULL;
-
-void add_decl(SymbolNode **head, Symbol *sym, Symbol *valor) {
+void add_decl(SymbolNode **head, Symbol *sym, int valor) {
     SymbolNode *nueva = malloc(sizeof(SymbolNode));
     if (!nueva) return;
     nueva->sym = sym;
@@ -19,7 +17,7 @@ void add_decl(SymbolNode **head, Symbol *sym, Symbol *valor) {
  * - .data: Para variables con valor inicial explícito distinto de cero.
  * - .bss: Para variables no inicializadas o inicializadas en cero.
  */
-void print_global_sections(SymbolNode *head) {
+void print_global_sections(SymbolNode *head, OutBuffer *out) {
     SymbolNode *n;
     int printed_data_header = 0;
     int printed_bss_header = 0;
@@ -27,40 +25,45 @@ void print_global_sections(SymbolNode *head) {
     // SECCIÓN .data
     // Imprime solo las variables con un valor inicial NO nulo.
     for (n = head; n; n = n->next) {
-        if (n->sym && n->valor && n->valor->valor.value != 0) {
+        if (n->sym && n->valor != 0) {
             
             // Imprimir el header solo si no lo hemos hecho
             if (!printed_data_header) {
-                printf(".data\n");
+                out_puts(out, ".data\n");
                 printed_data_header = 1;
             }
             
             // Imprimir la variable inicializada
-            printf("%s: .quad %d\n", n->sym->name, n->valor->valor.value);
+            out_puts(out, n->sym->name);
+            out_puts(out, ": .quad ");
+            out_int(out, n->valor);
+            out_putc(out, '\n');
         }
     }
 
     // SECCIÓN .bss
-    // Imprime las variables no inicializadas (valor es NULL) o inicializadas a 0.
+    // Imprime las variables no inicializadas o inicializadas a 0.
     for (n = head; n; n = n->next) {
-        if (n->sym && (!n->valor || n->valor->valor.value == 0)) {
+        if (n->sym && n->valor == 0) {
             
             // Imprimir el header (y un espaciado) si no lo hemos hecho
             if (!printed_bss_header) {
                 if (printed_data_header) {
-                    printf("\n"); // Separador
+                    out_putc(out, '\n'); // Separador
                 }
-                printf(".bss\n");
+                out_puts(out, ".bss\n");
                 printed_bss_header = 1;
             }
             
             // Usar .comm para reservar espacio en .bss (8 bytes para un quad)
-            printf(".comm %s, 8\n", n->sym->name);
+            out_puts(out, ".comm ");
+            out_puts(out, n->sym->name);
+            out_puts(out, ", 8\n");
         }
     }
 
     // Dejar una línea en blanco antes de la sección .text
     if (printed_data_header || printed_bss_header) {
-        printf("\n");
+        out_putc(out, '\n');
     }
 }
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "Jit.h"
+#include "Runtime.h"
+#include "SymbolMap.h"
+
+#define STUB_SIZE   16      // jmp *0(%rip) (6 bytes) y la dirección (8)
+
+typedef struct {
+    Symbol *sym;            // NULL: externo sin símbolo del programa (exit)
+    const char *name;
+} Extern;
+
+typedef struct {
+    SymbolMap methods;      // método -> offset en el código
+    SymbolMap globals;      // global -> índice en las páginas de datos
+    SymbolMap extern_syms;  // externo -> índice en externs
+    Extern *externs;
+    int extern_count;
+} JitTables;
+
+static size_t align(size_t value, size_t to) {
+    return (value + to - 1) / to * to;
+}
+
+/* Índice del salto indirecto de un externo; lo agrega si es la primera llamada */
+static int extern_index(JitTables *t, const X86Reloc *reloc) {
+    int index;
+    if (reloc->sym && symmap_get(&t->extern_syms, reloc->sym, &index)) return index;
+    for (index = 0; !reloc->sym && index < t->extern_count; index++)
+        if (!t->externs[index].sym && strcmp(t->externs[index].name, reloc->name) == 0) return index;
+
+    t->externs = realloc(t->externs, (t->extern_count + 1) * sizeof(Extern));
+    t->externs[t->extern_count] = (Extern){ reloc->sym, reloc->name };
+    if (reloc->sym) symmap_set(&t->extern_syms, reloc->sym, t->extern_count);
+    return t->extern_count++;
+}
+
+static void build_tables(CompilerContext *ctx, const X86Code *text, JitTables *t, int *global_count) {
+    memset(t, 0, sizeof(*t));
+    symmap_init(&t->methods);
+    symmap_init(&t->globals);
+    symmap_init(&t->extern_syms);
+    for (int i = 0; i < text->def_count; i++) symmap_set(&t->methods, text->defs[i].sym, text->defs[i].offset);
+    *global_count = 0;
+    for (SymbolNode *n = ctx->decl_vars; n; n = n->next) symmap_set(&t->globals, n->sym, (*global_count)++);
+    for (int i = 0; i < text->reloc_count; i++) {
+        const X86Reloc *reloc = &text->relocs[i];
+        if (reloc->kind == X86_RELOC_CALL && !(reloc->sym && symmap_get(&t->methods, reloc->sym, NULL)))
+            extern_index(t, reloc);
+    }
+}
+
+static void free_tables(JitTables *t) {
+    symmap_free(&t->methods);
+    symmap_free(&t->globals);
+    symmap_free(&t->extern_syms);
+    free(t->externs);
+}
+
+/* Dirección a la que apunta una reubicación, ya con el código en 'mem' */
+static unsigned char *target_of(JitTables *t, const X86Reloc *reloc, unsigned char *mem,
+                                unsigned char *stubs, unsigned char *data) {
+    int value = 0;
+    if (reloc->kind == X86_RELOC_DATA) {
+        symmap_get(&t->globals, reloc->sym, &value);
+        return data + value * 8;
+    }
+    if (reloc->sym && symmap_get(&t->methods, reloc->sym, &value)) return mem + value;
+    return stubs + extern_index(t, reloc) * STUB_SIZE;
+}
+
+int jit_run(CompilerContext *ctx, const X86Code *text) {
+    JitTables t;
+    int global_count;
+    build_tables(ctx, text, &t, &global_count);
+
+    int main_offset = -1;
+    for (int i = 0; i < text->def_count; i++)
+        if (strcmp(text->defs[i].sym->name, "main") == 0) main_offset = text->defs[i].offset;
+
+    // [código][saltos a externos] en páginas ejecutables, [globales] en otras de escritura
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t stubs_offset = align(text->size, 16);
+    size_t code_size = align(stubs_offset + t.extern_count * STUB_SIZE, page);
+    size_t data_size = align(global_count * 8, page);
+    unsigned char *mem = mmap(NULL, code_size + data_size, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) {
+        perror("Error al reservar memoria para el código");
+        free_tables(&t);
+        return 1;
+    }
+    unsigned char *stubs = mem + stubs_offset;
+    unsigned char *data = mem + code_size;
+    memcpy(mem, text->bytes, text->size);
+
+    long *globals = (long *)data;
+    int g = 0;
+    for (SymbolNode *n = ctx->decl_vars; n; n = n->next) globals[g++] = n->valor;
+
+    int status = 0;
+    for (int i = 0; i < t.extern_count; i++) {
+        ExternFn fn = runtime_resolve(t.externs[i].name);
+        if (!fn) {
+            fprintf(ctx->err, "Error: el método externo '%s' no está disponible\n", t.externs[i].name);
+            status = 1;
+        }
+        static const unsigned char jmp_indirect[6] = { 0xFF, 0x25, 0, 0, 0, 0 };
+        memcpy(stubs + i * STUB_SIZE, jmp_indirect, sizeof(jmp_indirect));
+        memcpy(stubs + i * STUB_SIZE + sizeof(jmp_indirect), &fn, sizeof(fn));
+    }
+
+    // Todo queda en el mismo mapeo: los desplazamientos entran en 32 bits
+    for (int i = 0; i < text->reloc_count; i++) {
+        const X86Reloc *reloc = &text->relocs[i];
+        unsigned char *field = mem + reloc->offset;
+        int32_t rel = (int32_t)(target_of(&t, reloc, mem, stubs, data) + reloc->addend - field);
+        memcpy(field, &rel, sizeof(rel));
+    }
+
+    if (main_offset < 0) {
+        fprintf(ctx->err, "Error: no se encontró el método main\n");
+        status = 1;
+    }
+    if (status == 0 && mprotect(mem, code_size, PROT_READ | PROT_EXEC) != 0) {
+        perror("Error al hacer ejecutable el código");
+        status = 1;
+    }
+    if (status == 0) {
+        long (*entry)(void);
+        unsigned char *address = mem + main_offset;
+        memcpy(&entry, &address, sizeof(entry));
+        status = (int)entry();
+        fflush(stdout);
+    }
+
+    munmap(mem, code_size + data_size);
+    free_tables(&t);
+    return status;
+}
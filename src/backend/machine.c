@@ -0,0 +1,274 @@
+#include <string.h>
+#include "Assembler.h"
+#include "RegAlloc.h"
+
+/*
+ * Las mismas instrucciones que Assembler.c, pero codificadas (X86.h) en
+ * ctx->mc_out en lugar de escritas como texto. Cada generateX de allá tiene
+ * su encodeX acá; si cambia una, tiene que cambiar la otra.
+ */
+
+typedef struct {
+    CompilerContext *ctx;
+    X86Code *code;
+    int *labels;                // etiqueta del IR (id - label_base) -> etiqueta de X86Code, o -1
+    int label_base, nlabels;
+    Symbol *method;
+} Encoder;
+
+/* Los registros que asigna RegAlloc.c y las tablas de Assembler.h/RegAlloc.h van por nombre */
+static X86Reg reg_from_name(const char *name) {
+    static const char *const names[] = {
+        "%rax", "%rcx", "%rdx", "%rbx", "%rsp", "%rbp", "%rsi", "%rdi",
+        "%r8", "%r9", "%r10", "%r11", "%r12", "%r13", "%r14", "%r15"
+    };
+    for (int r = 0; r < 16; r++)
+        if (strcmp(names[r], name) == 0) return (X86Reg)r;
+    return X86_RAX;
+}
+
+/* Como operand() de Assembler.c: registro asignado, global (sym(%rip)) o slot */
+static X86Operand operand(Encoder *e, IROperand v) {
+    const char *reg = ir_value_reg(e->ctx, v);
+    if (reg) return X86_REG(reg_from_name(reg));
+    if (v.kind == IRO_GLOBAL) return X86_SYM(ir_symbol(e->ctx, v));
+    if (v.kind == IRO_LOCAL) return X86_MEM(X86_RBP, ir_symbol(e->ctx, v)->offset);
+    return X86_MEM(X86_RBP, ir_value_info(e->ctx, v)->offset);
+}
+
+static void load(Encoder *e, X86Reg reg, IROperand v) {
+    x86_mov(e->code, X86_REG(reg), operand(e, v));
+}
+
+static void store(Encoder *e, IROperand v, X86Reg reg) {
+    x86_mov(e->code, operand(e, v), X86_REG(reg));
+}
+
+static void encode_move(Encoder *e, IROperand src, IROperand dst) {
+    const char *src_reg = ir_value_reg(e->ctx, src);
+    const char *dst_reg = ir_value_reg(e->ctx, dst);
+    if (ir_same(src, dst) || (src_reg && src_reg == dst_reg)) return;
+    if (!src_reg && !dst_reg) {
+        load(e, X86_RAX, src);
+        store(e, dst, X86_RAX);
+    } else {
+        x86_mov(e->code, operand(e, dst), operand(e, src));
+    }
+}
+
+/* Las etiquetas de una unidad tienen ids distintos y casi contiguos (Units.h) */
+static void labels_init(Encoder *e, IRList *list) {
+    int lo = 0, hi = -1;
+    for (int i = 0; i < list->size; i++) {
+        IROperand l = list->codes[i].result;
+        if (l.kind != IRO_LABEL) continue;
+        if (hi < lo) lo = hi = l.id;
+        else if (l.id < lo) lo = l.id;
+        else if (l.id > hi) hi = l.id;
+    }
+    e->label_base = lo;
+    e->nlabels = hi - lo + 1;
+    e->labels = malloc((e->nlabels > 0 ? e->nlabels : 1) * sizeof(int));
+    for (int k = 0; k < e->nlabels; k++) e->labels[k] = -1;
+}
+
+static int label_of(Encoder *e, IROperand label) {
+    int *id = &e->labels[label.id - e->label_base];
+    if (*id < 0) *id = x86_new_label(e->code);
+    return *id;
+}
+
+// =============================
+// Métodos
+// =============================
+
+static void encode_enter(Encoder *e, Symbol *method) {
+    int space = method->total_stack_space;
+    if (space % 16 != 0) space += 8;
+    x86_define(e->code, method);
+    x86_enter(e->code, space);
+
+    int offset = method->saved_regs_offset;
+    for (int i = 0; i < CALLEE_SAVED_COUNT; i++) {
+        if (method->saved_regs & (1 << i)) {
+            x86_mov(e->code, X86_MEM(X86_RBP, offset), X86_REG(reg_from_name(CALLEE_SAVED_REGISTERS[i])));
+            offset -= 8;
+        }
+    }
+}
+
+static void encode_return(Encoder *e, IRCode *inst) {
+    Symbol *method = e->method;
+    if (ir_has(inst->arg1)) load(e, X86_RAX, inst->arg1);
+    else if (method && strcmp(method->name, "main") == 0) x86_mov_imm(e->code, X86_REG(X86_RAX), 0);
+
+    int offset = method ? method->saved_regs_offset : 0;
+    for (int i = 0; method && i < CALLEE_SAVED_COUNT; i++) {
+        if (method->saved_regs & (1 << i)) {
+            x86_mov(e->code, X86_REG(reg_from_name(CALLEE_SAVED_REGISTERS[i])), X86_MEM(X86_RBP, offset));
+            offset -= 8;
+        }
+    }
+    x86_leave(e->code);
+    x86_ret(e->code);
+}
+
+static void encode_call(Encoder *e, IRCode *inst) {
+    CompilerContext *ctx = e->ctx;
+    Symbol *method = ir_symbol(ctx, inst->arg1);
+    int n = method->param_count;
+    PendingParam *args = &ctx->pending_params[ctx->pending_count - n];
+    ctx->pending_count -= n;
+
+    int stack_args = n > 6 ? n - 6 : 0;
+    int padding = stack_args % 2 != 0 ? 8 : 0;
+    if (padding) x86_alu_imm(e->code, X86_SUB, X86_REG(X86_RSP), 8);
+    for (int k = 0; k < n; k++)
+        if (args[k].index >= 6) x86_push(e->code, operand(e, args[k].value));
+    for (int k = 0; k < n; k++)
+        if (args[k].index < PARAM_REGISTER_COUNT) load(e, reg_from_name(PARAM_REGISTERS[args[k].index]), args[k].value);
+
+    x86_call(e->code, method, method->name);
+    if (stack_args || padding) x86_alu_imm(e->code, X86_ADD, X86_REG(X86_RSP), stack_args * 8 + padding);
+    if (ir_has(inst->result)) store(e, inst->result, X86_RAX);
+}
+
+// =============================
+// Operaciones
+// =============================
+
+static void encode_binary(Encoder *e, IRCode *inst, X86Alu op) {
+    load(e, X86_RAX, inst->arg1);
+    x86_alu(e->code, op, X86_RAX, operand(e, inst->arg2));
+    store(e, inst->result, X86_RAX);
+}
+
+/* División y módulo: un divisor 0 termina el programa con exit(136) */
+static void encode_division(Encoder *e, IRCode *inst) {
+    X86Code *c = e->code;
+    int error = x86_new_label(c);
+    int ok = x86_new_label(c);
+
+    load(e, X86_RCX, inst->arg2);
+    x86_alu_imm(c, X86_CMP, X86_REG(X86_RCX), 0);
+    x86_jcc(c, X86_CC_E, error);
+    load(e, X86_RAX, inst->arg1);
+    x86_cqo(c);
+    x86_idiv(c, X86_REG(X86_RCX));
+    store(e, inst->result, inst->op == IR_MOD ? X86_RDX : X86_RAX);
+    x86_jmp(c, ok);
+
+    x86_bind(c, error);
+    x86_mov_imm(c, X86_REG(X86_RDI), 136);
+    x86_call(c, NULL, "exit");
+    x86_bind(c, ok);
+}
+
+static void encode_compare(Encoder *e, IRCode *inst, X86Cond cc) {
+    load(e, X86_RAX, inst->arg1);
+    x86_alu(e->code, X86_CMP, X86_RAX, operand(e, inst->arg2));
+    x86_setcc(e->code, cc, X86_RAX);
+    x86_movzx8(e->code, X86_RAX, X86_RAX);
+    store(e, inst->result, X86_RAX);
+}
+
+static void encode_cond_jump(Encoder *e, IRCode *inst, X86Cond cc) {
+    load(e, X86_RAX, inst->arg1);
+    x86_alu(e->code, X86_CMP, X86_RAX, operand(e, inst->arg2));
+    x86_jcc(e->code, cc, label_of(e, inst->result));
+}
+
+static void encode_instruction(Encoder *e, IRCode *inst) {
+    X86Code *c = e->code;
+    switch (inst->op) {
+        case IR_LOAD:
+        case IR_STORE:
+            encode_move(e, inst->arg1, inst->result);
+            break;
+        case IR_STORAGE:
+            x86_mov_imm(c, operand(e, inst->result), inst->arg1.id);
+            break;
+        case IR_PARAM:
+            generateParam(e->ctx, inst);    // solo anota el argumento
+            break;
+        case IR_SAVE_PARAM: {
+            Symbol *param = ir_symbol(e->ctx, inst->arg1);
+            if (param && param->is_param && param->param_index < PARAM_REGISTER_COUNT)
+                x86_mov(c, operand(e, inst->arg1), X86_REG(reg_from_name(PARAM_REGISTERS[param->param_index])));
+            break;
+        }
+
+        case IR_ADD: encode_binary(e, inst, X86_ADD); break;
+        case IR_SUB: encode_binary(e, inst, X86_SUB); break;
+        case IR_AND: encode_binary(e, inst, X86_AND); break;
+        case IR_OR:  encode_binary(e, inst, X86_OR); break;
+        case IR_MUL:
+            load(e, X86_RAX, inst->arg1);
+            x86_imul(c, X86_RAX, operand(e, inst->arg2));
+            store(e, inst->result, X86_RAX);
+            break;
+        case IR_DIV:
+        case IR_MOD:
+            encode_division(e, inst);
+            break;
+        case IR_UMINUS:
+            load(e, X86_RAX, inst->arg1);
+            x86_neg(c, X86_REG(X86_RAX));
+            store(e, inst->result, X86_RAX);
+            break;
+        case IR_NOT:
+            load(e, X86_RAX, inst->arg1);
+            x86_alu_imm(c, X86_XOR, X86_REG(X86_RAX), 1);
+            store(e, inst->result, X86_RAX);
+            break;
+
+        case IR_EQ:  encode_compare(e, inst, X86_CC_E); break;
+        case IR_NEQ: encode_compare(e, inst, X86_CC_NE); break;
+        case IR_LT:  encode_compare(e, inst, X86_CC_L); break;
+        case IR_LE:  encode_compare(e, inst, X86_CC_LE); break;
+        case IR_GT:  encode_compare(e, inst, X86_CC_G); break;
+        case IR_GE:  encode_compare(e, inst, X86_CC_GE); break;
+
+        case IR_LABEL:
+            x86_bind(c, label_of(e, inst->result));
+            break;
+        case IR_GOTO:
+            if (ir_has(inst->arg1)) {
+                x86_alu_imm(c, X86_CMP, operand(e, inst->arg1), 1);
+                x86_jcc(c, X86_CC_NE, label_of(e, inst->result));
+            } else {
+                x86_jmp(c, label_of(e, inst->result));
+            }
+            break;
+        case IR_JEQ: encode_cond_jump(e, inst, X86_CC_E); break;
+        case IR_JNE: encode_cond_jump(e, inst, X86_CC_NE); break;
+        case IR_JLT: encode_cond_jump(e, inst, X86_CC_L); break;
+        case IR_JLE: encode_cond_jump(e, inst, X86_CC_LE); break;
+        case IR_JGT: encode_cond_jump(e, inst, X86_CC_G); break;
+        case IR_JGE: encode_cond_jump(e, inst, X86_CC_GE); break;
+
+        case IR_METHOD:
+            e->method = ir_symbol(e->ctx, inst->result);
+            encode_enter(e, e->method);
+            break;
+        case IR_CALL:
+            encode_call(e, inst);
+            break;
+        case IR_RETURN:
+            encode_return(e, inst);
+            break;
+
+        default:
+            // IR_FMETHOD (una etiqueta a la que nadie salta), IR_DECL,
+            // IR_METH_EXT e IR_NOP no generan código
+            break;
+    }
+}
+
+void generateUnitMachineCode(CompilerContext *ctx, IRList *list) {
+    Encoder e = { ctx, &ctx->mc_out, NULL, 0, 0, NULL };
+    labels_init(&e, list);
+    for (int i = 0; i < list->size; i++) encode_instruction(&e, &list->codes[i]);
+    x86_finish(e.code);
+    free(e.labels);
+}
@@ -0,0 +1,294 @@
+#include <stdlib.h>
+#include <string.h>
+#include "Peephole.h"
+
+/*
+ * Las reglas miran instrucciones consecutivas saltando comentarios y líneas
+ * en blanco. Una etiqueta siempre corta un patrón: puede llegarse a ella
+ * desde otro lado.
+ */
+
+static bool starts_with(const char *s, const char *prefix) {
+    return strncmp(s, prefix, strlen(prefix)) == 0;
+}
+
+static bool is_immediate(const char *loc) { return loc[0] == '$'; }
+static bool is_register(const char *loc)  { return loc[0] == '%'; }
+static bool is_memory(const char *loc)    { return strchr(loc, '(') != NULL; }
+
+/* Siguiente línea viva que no sea ASM_TEXT, o -1 */
+static int next_line(AsmBuffer *buf, int i) {
+    for (i++; i < buf->size; i++) {
+        AsmLine *line = &buf->lines[i];
+        if (!line->deleted && line->kind != ASM_TEXT) return i;
+    }
+    return -1;
+}
+
+static bool is_instr(AsmBuffer *buf, int i, const char *op) {
+    return i >= 0 && buf->lines[i].kind == ASM_INSTR && strcmp(buf->lines[i].op, op) == 0;
+}
+
+// =============================
+// Valores conocidos (peep-mov, peep-shl)
+// =============================
+
+/*
+ * Numeración de valores dentro de un tramo sin etiquetas: dos ubicaciones
+ * (registro, slot de la pila, global o inmediato) con el mismo número tienen
+ * el mismo valor. Un movq hacia una ubicación que ya tiene el valor de la
+ * fuente sobra, y una lectura de memoria puede tomar el valor de un
+ * inmediato o un registro equivalente.
+ */
+#define MAX_KNOWN 64
+
+typedef struct {
+    char loc[64];
+    int vn;
+} Known;
+
+typedef struct {
+    Known entries[MAX_KNOWN];
+    int count;
+    int next_vn;
+} Values;
+
+/* Los sub-registros que usa el backend se cuentan como su registro de 64 bits */
+static const char *canonical(const char *loc) {
+    static const char *aliases[][2] = {
+        { "%al", "%rax" }, { "%eax", "%rax" }, { "%edi", "%rdi" }, { "%ecx", "%rcx" },
+    };
+    for (size_t i = 0; i < sizeof(aliases) / sizeof(aliases[0]); i++)
+        if (strcmp(loc, aliases[i][0]) == 0) return aliases[i][1];
+    return loc;
+}
+
+static int find(Values *v, const char *loc) {
+    loc = canonical(loc);
+    for (int i = 0; i < v->count; i++)
+        if (strcmp(v->entries[i].loc, loc) == 0) return i;
+    return -1;
+}
+
+static void clobber(Values *v, const char *loc) {
+    int i = find(v, loc);
+    if (i >= 0) v->entries[i] = v->entries[--v->count];
+}
+
+static void set_value(Values *v, const char *loc, int vn) {
+    clobber(v, loc);
+    if (v->count == MAX_KNOWN) v->count = 0;   // tabla llena: se olvida todo
+    Known *k = &v->entries[v->count++];
+    snprintf(k->loc, sizeof(k->loc), "%s", canonical(loc));
+    k->vn = vn;
+}
+
+static int value_of(Values *v, const char *loc) {
+    int i = find(v, loc);
+    if (i >= 0) return v->entries[i].vn;
+    if (!is_immediate(loc)) return -1;
+    set_value(v, loc, v->next_vn);
+    return v->next_vn++;
+}
+
+static int value_or_new(Values *v, const char *loc) {
+    int vn = value_of(v, loc);
+    if (vn < 0) {
+        vn = v->next_vn++;
+        set_value(v, loc, vn);
+    }
+    return vn;
+}
+
+/* Ubicación más barata con el valor vn: un inmediato, o si no un registro */
+static const char *cheaper_equal(Values *v, int vn) {
+    const char *reg = NULL;
+    for (int i = 0; i < v->count && vn >= 0; i++) {
+        if (v->entries[i].vn != vn) continue;
+        if (is_immediate(v->entries[i].loc)) return v->entries[i].loc;
+        if (is_register(v->entries[i].loc) && !reg) reg = v->entries[i].loc;
+    }
+    return reg;
+}
+
+static bool in_list(const char *op, const char *const *list) {
+    for (int i = 0; list[i]; i++)
+        if (strcmp(op, list[i]) == 0) return true;
+    return false;
+}
+
+// Leen src y escriben dst
+static const char *const WRITE_DST[] = {
+    "addq", "subq", "imulq", "andq", "orq", "xorq", "salq", "sarq", "shlq", "shrq",
+    "leaq", "movzbq", "movl", NULL
+};
+// Aceptan un inmediato o un registro en lugar de una lectura de memoria en src
+static const char *const SRC_REPLACEABLE[] = {
+    "movq", "addq", "subq", "imulq", "andq", "orq", "xorq", "cmpq", "pushq", NULL
+};
+// Escriben su único operando
+static const char *const WRITE_SRC[] = { "negq", "notq", "incq", "decq", "popq", NULL };
+// No escriben ninguna ubicación seguida
+static const char *const READ_ONLY[] = { "cmpq", "testq", "pushq", NULL };
+
+/* Potencia de 2 del inmediato "$n", o -1 */
+static int power_of_two(const char *imm) {
+    long n = strtol(imm + 1, NULL, 10);
+    if (n <= 0 || (n & (n - 1)) != 0) return -1;
+    int k = 0;
+    while (n > 1) { n >>= 1; k++; }
+    return k;
+}
+
+static int optimize_values(AsmBuffer *buf, unsigned rules) {
+    Values v = { .count = 0, .next_vn = 0 };
+    int removed = 0;
+
+    for (int i = 0; i < buf->size; i++) {
+        AsmLine *line = &buf->lines[i];
+        if (line->deleted || line->kind == ASM_TEXT) continue;
+        if (line->kind == ASM_LABEL) {
+            v.count = 0;
+            continue;
+        }
+
+        const char *op = line->op;
+
+        // Lecturas de memoria con valor conocido
+        if ((rules & PEEP_MOVES) && line->src && is_memory(line->src) && in_list(op, SRC_REPLACEABLE)) {
+            const char *better = cheaper_equal(&v, value_of(&v, line->src));
+            if (better) asm_set_operand(buf, &line->src, better);
+        }
+        if ((rules & PEEP_MOVES) && strcmp(op, "cmpq") == 0 && line->dst && is_memory(line->dst)) {
+            const char *better = cheaper_equal(&v, value_of(&v, line->dst));
+            if (better && is_register(better)) asm_set_operand(buf, &line->dst, better);
+        }
+
+        if (strcmp(op, "movq") == 0 && line->dst) {
+            int vn = value_or_new(&v, line->src);
+            if ((rules & PEEP_MOVES) && value_of(&v, line->dst) == vn) {
+                line->deleted = true;
+                removed++;
+                continue;
+            }
+            set_value(&v, line->dst, vn);
+            continue;
+        }
+
+        if ((rules & PEEP_SHIFTS) && strcmp(op, "imulq") == 0 && line->dst && is_register(line->dst)) {
+            const char *imm = is_immediate(line->src) ? line->src
+                                                      : cheaper_equal(&v, value_of(&v, line->src));
+            int k = (imm && is_immediate(imm)) ? power_of_two(imm) : -1;
+            if (k == 0) {
+                line->deleted = true;   // multiplicar por 1
+                removed++;
+                continue;
+            }
+            if (k > 0) {
+                char shift[16];
+                snprintf(shift, sizeof(shift), "$%d", k);
+                line->op = "salq";
+                asm_set_operand(buf, &line->src, shift);
+                op = line->op;
+            }
+        }
+
+        // Efecto sobre las ubicaciones conocidas
+        if (in_list(op, WRITE_DST) && line->dst) {
+            clobber(&v, line->dst);
+        } else if ((in_list(op, WRITE_SRC) || starts_with(op, "set")) && line->src) {
+            clobber(&v, line->src);
+        } else if (strcmp(op, "cqto") == 0) {
+            clobber(&v, "%rdx");
+        } else if (starts_with(op, "idiv")) {
+            clobber(&v, "%rax");
+            clobber(&v, "%rdx");
+        } else if (in_list(op, READ_ONLY) || (op[0] == 'j' && strcmp(op, "jmp") != 0)) {
+            // solo leen; en un salto condicional lo conocido sigue valiendo al caer
+        } else {
+            v.count = 0;    // call, jmp, enter, leave, ret o algo desconocido
+        }
+    }
+    return removed;
+}
+
+// =============================
+// peep-cmp
+// =============================
+
+/* Salto equivalente a "el setcc dio 1" (taken = true) o "dio 0" */
+static const char *branch_for(const char *setcc, bool taken) {
+    static const char *table[][3] = {
+        { "sete", "je", "jne" }, { "setne", "jne", "je" },
+        { "setl", "jl", "jge" }, { "setle", "jle", "jg" },
+        { "setg", "jg", "jle" }, { "setge", "jge", "jl" },
+    };
+    for (size_t i = 0; i < sizeof(table) / sizeof(table[0]); i++)
+        if (strcmp(setcc, table[i][0]) == 0) return table[i][taken ? 1 : 2];
+    return NULL;
+}
+
+/*
+ * setcc %al / movzbq %al, %rax / [movq %rax, T] / cmpq $1, (T|%rax) / jne L
+ * Los mov no tocan los flags de la comparación original: el cmpq $1 sobra
+ * y el salto usa directamente la condición.
+ */
+static int fuse_branches(AsmBuffer *buf) {
+    int removed = 0;
+    for (int i = 0; i < buf->size; i++) {
+        AsmLine *set = &buf->lines[i];
+        if (set->deleted || set->kind != ASM_INSTR || !branch_for(set->op, true)) continue;
+
+        int j = next_line(buf, i);
+        if (!is_instr(buf, j, "movzbq")) continue;
+
+        const char *stored = NULL;
+        int k = next_line(buf, j);
+        if (is_instr(buf, k, "movq") && strcmp(buf->lines[k].src, "%rax") == 0) {
+            stored = buf->lines[k].dst;
+            k = next_line(buf, k);
+        }
+        if (!is_instr(buf, k, "cmpq") || strcmp(buf->lines[k].src, "$1") != 0) continue;
+        const char *tested = buf->lines[k].dst;
+        if (strcmp(tested, "%rax") != 0 && !(stored && strcmp(tested, stored) == 0)) continue;
+
+        int jump = next_line(buf, k);
+        bool jne = is_instr(buf, jump, "jne");
+        if (!jne && !is_instr(buf, jump, "je")) continue;
+
+        buf->lines[k].deleted = true;
+        buf->lines[jump].op = branch_for(set->op, !jne);
+        removed++;
+    }
+    return removed;
+}
+
+// =============================
+// peep-jmp
+// =============================
+
+/* Elimina jmp/jcc cuyo destino es una de las etiquetas que siguen inmediatamente */
+static int remove_jumps_to_next(AsmBuffer *buf) {
+    int removed = 0;
+    for (int i = 0; i < buf->size; i++) {
+        AsmLine *line = &buf->lines[i];
+        if (line->deleted || line->kind != ASM_INSTR || line->op[0] != 'j' || !line->src) continue;
+
+        for (int k = next_line(buf, i); k >= 0 && buf->lines[k].kind == ASM_LABEL; k = next_line(buf, k)) {
+            if (strcmp(buf->lines[k].text, line->src) == 0) {
+                line->deleted = true;
+                removed++;
+                break;
+            }
+        }
+    }
+    return removed;
+}
+
+int peephole(AsmBuffer *buf, unsigned rules) {
+    int removed = 0;
+    if (rules & (PEEP_MOVES | PEEP_SHIFTS)) removed += optimize_values(buf, rules);
+    if (rules & PEEP_BRANCHES) removed += fuse_branches(buf);
+    if (rules & PEEP_JUMPS) removed += remove_jumps_to_next(buf);
+    return removed;
+}
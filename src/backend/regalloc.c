@@ -0,0 +1,125 @@
+#include "RegAlloc.h"
+#include "Liveness.h"
+
+/*
+ * Linear scan (Poletto & Sarkar) sobre los intervalos de vida del método.
+ *
+ * - Los valores vivos a través de un CALL solo pueden ir a registros
+ *   callee-saved; el resto prefiere los caller-saved (no hay que preservarlos).
+ * - Sin registros libres se derrama el intervalo que termina más lejos:
+ *   queda con reg = NULL y usa su slot en la pila como hasta ahora.
+ * - %rax, %rcx y %rdx son de uso interno del backend y los registros de
+ *   PARAM_REGISTERS solo se cargan justo antes de cada call.
+ */
+
+const char *const CALLEE_SAVED_REGISTERS[CALLEE_SAVED_COUNT] = {
+    "%rbx", "%r12", "%r13", "%r14", "%r15"
+};
+
+typedef struct {
+    const char *name;
+    bool callee_saved;
+    int saved_index;        // posición en CALLEE_SAVED_REGISTERS
+} Register;
+
+/*
+ * Primero los que destruye un call (%r10 y %r11): solo para valores que no
+ * viven a través de uno, y no hay que preservarlos. Después los
+ * callee-saved, en el orden de CALLEE_SAVED_REGISTERS.
+ */
+#define REG_COUNT (2 + CALLEE_SAVED_COUNT)
+static const Register registers[REG_COUNT] = {
+    { "%r10", false, -1 },
+    { "%r11", false, -1 },
+    { "%rbx", true, 0 },
+    { "%r12", true, 1 },
+    { "%r13", true, 2 },
+    { "%r14", true, 3 },
+    { "%r15", true, 4 },
+};
+
+/* Los parámetros que llegan por la pila (7mo en adelante) se leen desde su slot */
+static bool allocatable(CompilerContext *ctx, IROperand v) {
+    if (v.kind == IRO_TEMP) return true;
+    if (v.kind != IRO_LOCAL) return false;
+    Symbol *sym = ir_symbol(ctx, v);
+    return !(sym->is_param && sym->param_index >= 6);
+}
+
+static void allocate_method(CompilerContext *ctx, IRList *list, int start, int end, bool debug) {
+    Symbol *method = ir_symbol(ctx, list->codes[start].result);
+    Liveness *lv = liveness_compute(ctx, list, start, end);
+    LiveInterval *ivs;
+    int n = liveness_intervals(lv, &ivs);
+
+    // active[r]: índice del intervalo que ocupa el registro r, o -1
+    int active[REG_COUNT];
+    for (int r = 0; r < REG_COUNT; r++) active[r] = -1;
+
+    int in_regs = 0, spilled = 0;
+
+    for (int k = 0; k < n; k++) {
+        LiveInterval *cur = &ivs[k];
+        // Las globales las comparten todos los métodos (que pueden estar en otros hilos): no se tocan
+        if (!allocatable(ctx, cur->value)) continue;
+        ir_value_info(ctx, cur->value)->reg = NULL;
+
+        // Liberar los registros cuyos intervalos ya terminaron
+        for (int r = 0; r < REG_COUNT; r++) {
+            if (active[r] >= 0 && ivs[active[r]].end < cur->start) active[r] = -1;
+        }
+
+        int chosen = -1;
+        for (int r = 0; r < REG_COUNT && chosen < 0; r++) {
+            if (active[r] < 0 && (registers[r].callee_saved || !cur->crosses_call))
+                chosen = r;
+        }
+
+        if (chosen < 0) {
+            // Derramar el que termina más lejos (el actual o uno activo compatible)
+            int victim = -1;
+            for (int r = 0; r < REG_COUNT; r++) {
+                if (active[r] < 0 || (!registers[r].callee_saved && cur->crosses_call)) continue;
+                if (victim < 0 || ivs[active[r]].end > ivs[active[victim]].end) victim = r;
+            }
+            if (victim >= 0 && ivs[active[victim]].end > cur->end) {
+                ir_value_info(ctx, ivs[active[victim]].value)->reg = NULL;
+                chosen = victim;
+            }
+            spilled++;
+        }
+
+        if (chosen >= 0) {
+            active[chosen] = k;
+            ir_value_info(ctx, cur->value)->reg = registers[chosen].name;
+            if (registers[chosen].callee_saved)
+                method->saved_regs |= 1 << registers[chosen].saved_index;
+        }
+    }
+
+    // Reservar en el frame un slot por cada callee-saved usado
+    method->saved_regs_offset = -method->total_stack_space - 8;
+    for (int i = 0; i < CALLEE_SAVED_COUNT; i++) {
+        if (method->saved_regs & (1 << i)) method->total_stack_space += 8;
+    }
+
+    for (int k = 0; k < n; k++) {
+        if (ir_value_reg(ctx, ivs[k].value)) in_regs++;
+    }
+    if (debug) {
+        printf("[DEBUG] regalloc '%s': %d valores, %d en registros, %d derrames\n",
+               method->name, n, in_regs, spilled);
+    }
+
+    free(ivs);
+    liveness_free(lv);
+}
+
+void allocate_registers(CompilerContext *ctx, IRList *list, bool debug) {
+    for (int i = 0; i < list->size; i++) {
+        if (list->codes[i].op != IR_METHOD) continue;
+        int end = ir_method_end(list, i);
+        allocate_method(ctx, list, i, end, debug);
+        i = end;
+    }
+}
@@ -0,0 +1,261 @@
+#include <stdlib.h>
+#include <string.h>
+#include "X86.h"
+
+/*
+ * Referencias del formato: prefijo REX (0100WRXB), ModRM (mod, reg, rm) y
+ * SIB. W pide operandos de 64 bits; R, X y B extienden los campos reg,
+ * index y rm/base a los registros r8..r15.
+ */
+#define REX_W   8
+#define REX_R   4
+#define REX_B   1
+
+void x86_init(X86Code *c) {
+    memset(c, 0, sizeof(*c));
+}
+
+void x86_free(X86Code *c) {
+    free(c->bytes);
+    free(c->labels);
+    free(c->jumps);
+    free(c->relocs);
+    free(c->defs);
+    memset(c, 0, sizeof(*c));
+}
+
+// =============================
+// Buffer
+// =============================
+
+#define GROW(ptr, count, capacity, initial)                                    \
+    do {                                                                       \
+        if ((count) == (capacity)) {                                           \
+            (capacity) = (capacity) ? (capacity) * 2 : (initial);              \
+            (ptr) = realloc((ptr), (capacity) * sizeof(*(ptr)));               \
+        }                                                                      \
+    } while (0)
+
+static void put(X86Code *c, const void *data, int n) {
+    if (c->size + n > c->capacity) {
+        while (c->size + n > c->capacity) c->capacity = c->capacity ? c->capacity * 2 : 4096;
+        c->bytes = realloc(c->bytes, c->capacity);
+    }
+    memcpy(c->bytes + c->size, data, n);
+    c->size += n;
+}
+
+static void put8(X86Code *c, int value) {
+    unsigned char b = (unsigned char)value;
+    put(c, &b, 1);
+}
+
+static void put32(X86Code *c, int32_t value) {
+    put(c, &value, 4);      // x86 es little endian, como la máquina donde corre el JIT
+}
+
+static void add_reloc(X86Code *c, X86RelocKind kind, int addend, Symbol *sym, const char *name) {
+    GROW(c->relocs, c->reloc_count, c->reloc_capacity, 64);
+    c->relocs[c->reloc_count++] = (X86Reloc){ kind, c->size, addend, sym, name };
+}
+
+// =============================
+// Etiquetas
+// =============================
+
+int x86_new_label(X86Code *c) {
+    GROW(c->labels, c->label_count, c->label_capacity, 64);
+    c->labels[c->label_count] = -1;
+    return c->label_count++;
+}
+
+void x86_bind(X86Code *c, int label) {
+    c->labels[label] = c->size;
+}
+
+void x86_define(X86Code *c, Symbol *sym) {
+    GROW(c->defs, c->def_count, c->def_capacity, 16);
+    c->defs[c->def_count++] = (X86Def){ sym, c->size };
+}
+
+/* El campo queda con el número de etiqueta hasta x86_finish */
+static void jump_field(X86Code *c, int label) {
+    GROW(c->jumps, c->jump_count, c->jump_capacity, 64);
+    c->jumps[c->jump_count++] = c->size;
+    put32(c, label);
+}
+
+void x86_finish(X86Code *c) {
+    for (int i = 0; i < c->jump_count; i++) {
+        int32_t label, rel;
+        memcpy(&label, c->bytes + c->jumps[i], 4);
+        rel = c->labels[label] - (c->jumps[i] + 4);
+        memcpy(c->bytes + c->jumps[i], &rel, 4);
+    }
+    c->jump_count = 0;
+}
+
+void x86_append(X86Code *dst, const X86Code *src) {
+    int base = dst->size;
+    put(dst, src->bytes, src->size);
+    for (int i = 0; i < src->reloc_count; i++) {
+        GROW(dst->relocs, dst->reloc_count, dst->reloc_capacity, 64);
+        dst->relocs[dst->reloc_count] = src->relocs[i];
+        dst->relocs[dst->reloc_count++].offset += base;
+    }
+    for (int i = 0; i < src->def_count; i++) {
+        GROW(dst->defs, dst->def_count, dst->def_capacity, 16);
+        dst->defs[dst->def_count] = src->defs[i];
+        dst->defs[dst->def_count++].offset += base;
+    }
+}
+
+// =============================
+// Operandos
+// =============================
+
+/**
+ * Prefijo, opcode y ModRM de una instrucción 'opcode reg, rm'. 'imm_size'
+ * es lo que ocupa el inmediato que sigue: un operando sym(%rip) es relativo
+ * al final de la instrucción. 'byte_reg': rm es un registro de 8 bits (sin
+ * REX, 4..7 serían %ah..%bh en lugar de %spl..%dil).
+ */
+static void emit_rm(X86Code *c, int rex, const unsigned char *opcode, int opcode_size,
+                    int reg, X86Operand rm, int imm_size, bool byte_reg) {
+    if (reg & 8) rex |= REX_R;
+    if (rm.kind != X86_OPND_SYMBOL && (rm.reg & 8)) rex |= REX_B;
+    if (rex || (byte_reg && rm.kind == X86_OPND_REG && rm.reg >= X86_RSP)) put8(c, 0x40 | rex);
+    put(c, opcode, opcode_size);
+
+    int field = (reg & 7) << 3;
+    if (rm.kind == X86_OPND_REG) {
+        put8(c, 0xC0 | field | (rm.reg & 7));
+    } else if (rm.kind == X86_OPND_SYMBOL) {
+        put8(c, 0x05 | field);      // mod 00, rm 101: disp32(%rip)
+        add_reloc(c, X86_RELOC_DATA, -4 - imm_size, rm.sym, rm.sym->name);
+        put32(c, 0);
+    } else {
+        // %rbp y %r13 sin desplazamiento significan otra cosa: llevan un disp8 en 0
+        int base = rm.reg & 7;
+        int mod = (rm.disp == 0 && base != X86_RBP) ? 0 : (rm.disp >= -128 && rm.disp <= 127) ? 1 : 2;
+        put8(c, (mod << 6) | field | base);
+        if (base == X86_RSP) put8(c, 0x24);    // %rsp y %r12 como base necesitan SIB
+        if (mod == 1) put8(c, rm.disp);
+        else if (mod == 2) put32(c, rm.disp);
+    }
+}
+
+static void emit_op1(X86Code *c, int rex, int opcode, int reg, X86Operand rm, int imm_size) {
+    unsigned char op = (unsigned char)opcode;
+    emit_rm(c, rex, &op, 1, reg, rm, imm_size, false);
+}
+
+static void emit_op2(X86Code *c, int rex, int opcode, int reg, X86Operand rm, bool byte_reg) {
+    unsigned char op[2] = { 0x0F, (unsigned char)opcode };
+    emit_rm(c, rex, op, 2, reg, rm, 0, byte_reg);
+}
+
+static bool fits8(int32_t value) {
+    return value >= -128 && value <= 127;
+}
+
+// =============================
+// Instrucciones
+// =============================
+
+void x86_mov(X86Code *c, X86Operand dst, X86Operand src) {
+    if (dst.kind == X86_OPND_REG) emit_op1(c, REX_W, 0x8B, dst.reg, src, 0);    // mov r64, r/m64
+    else emit_op1(c, REX_W, 0x89, src.reg, dst, 0);                             // mov r/m64, r64
+}
+
+void x86_mov_imm(X86Code *c, X86Operand dst, int32_t imm) {
+    emit_op1(c, REX_W, 0xC7, 0, dst, 4);
+    put32(c, imm);
+}
+
+void x86_alu(X86Code *c, X86Alu op, X86Reg dst, X86Operand src) {
+    emit_op1(c, REX_W, op * 8 + 3, dst, src, 0);        // 03 add, 0B or, 23 and, 2B sub, 33 xor, 3B cmp
+}
+
+void x86_alu_imm(X86Code *c, X86Alu op, X86Operand dst, int32_t imm) {
+    if (fits8(imm)) {
+        emit_op1(c, REX_W, 0x83, op, dst, 1);
+        put8(c, imm);
+    } else {
+        emit_op1(c, REX_W, 0x81, op, dst, 4);
+        put32(c, imm);
+    }
+}
+
+void x86_imul(X86Code *c, X86Reg dst, X86Operand src) {
+    emit_op2(c, REX_W, 0xAF, dst, src, false);
+}
+
+void x86_neg(X86Code *c, X86Operand dst) {
+    emit_op1(c, REX_W, 0xF7, 3, dst, 0);
+}
+
+void x86_cqo(X86Code *c) {
+    put8(c, 0x40 | REX_W);
+    put8(c, 0x99);
+}
+
+void x86_idiv(X86Code *c, X86Operand divisor) {
+    emit_op1(c, REX_W, 0xF7, 7, divisor, 0);
+}
+
+void x86_setcc(X86Code *c, X86Cond cc, X86Reg dst) {
+    emit_op2(c, 0, 0x90 + cc, 0, X86_REG(dst), true);
+}
+
+void x86_movzx8(X86Code *c, X86Reg dst, X86Reg src) {
+    emit_op2(c, REX_W, 0xB6, dst, X86_REG(src), true);
+}
+
+void x86_push(X86Code *c, X86Operand src) {
+    if (src.kind == X86_OPND_REG) {
+        if (src.reg & 8) put8(c, 0x40 | REX_B);
+        put8(c, 0x50 + (src.reg & 7));
+    } else {
+        emit_op1(c, 0, 0xFF, 6, src, 0);    // push r/m64: ya es de 64 bits sin REX.W
+    }
+}
+
+void x86_jmp(X86Code *c, int label) {
+    put8(c, 0xE9);
+    jump_field(c, label);
+}
+
+void x86_jcc(X86Code *c, X86Cond cc, int label) {
+    put8(c, 0x0F);
+    put8(c, 0x80 + cc);
+    jump_field(c, label);
+}
+
+void x86_call(X86Code *c, Symbol *sym, const char *name) {
+    put8(c, 0xE8);
+    add_reloc(c, X86_RELOC_CALL, -4, sym, name);
+    put32(c, 0);
+}
+
+void x86_enter(X86Code *c, int size) {
+    if (size <= 0xFFFF) {
+        put8(c, 0xC8);
+        put8(c, size & 0xFF);
+        put8(c, size >> 8);
+        put8(c, 0);
+        return;
+    }
+    // enter solo lleva 16 bits de tamaño: lo mismo en tres instrucciones
+    x86_push(c, X86_REG(X86_RBP));
+    x86_mov(c, X86_REG(X86_RBP), X86_REG(X86_RSP));
+    x86_alu_imm(c, X86_SUB, X86_REG(X86_RSP), size);
+}
+
+void x86_leave(X86Code *c) {
+    put8(c, 0xC9);
+}
+
+void x86_ret(X86Code *c) {
+    put8(c, 0xC3);
+}
@@ -0,0 +1,136 @@
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include "Batch.h"
+#include "Stages.h"
+#include "ThreadPool.h"
+
+typedef struct {
+    const char *input;
+    char *output;
+    Config *cfg;
+    ThreadPool *pool;       // los métodos del archivo van como tareas al mismo pool
+    int result;
+    char *diag;             // lo que el archivo hubiera escrito en stderr
+    size_t diag_size;
+    double ms;
+    int worker;
+    TimeReport report;      // --time-report
+} BatchUnit;
+
+static void compile_unit(void *arg) {
+    BatchUnit *u = arg;
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    u->worker = pool_worker_index();
+    u->result = 1;
+
+    FILE *err = open_memstream(&u->diag, &u->diag_size);
+    FILE *in = fopen(u->input, "r");
+    FILE *out = in ? fopen(u->output, "w") : NULL;
+    if (!in || !out) {
+        fprintf(err, "Error al abrir '%s': %s\n", in ? u->output : u->input, strerror(errno));
+    } else {
+        CompilerContext ctx;
+        if (context_init(&ctx, u->input, in, err) == 0) {
+            PhaseTimer total;
+            ctx.pool = u->pool;
+            if (u->cfg->time_report) {
+                u->report.input_file = u->input;
+                ctx.report = &u->report;
+            }
+            report_start(ctx.report, &total);
+            CompilerContext *prev = context_bind(&ctx);
+            u->result = run_parse_stage(&ctx, u->cfg);
+            if (u->result == 0) u->result = run_assembly_stage(&ctx, out, u->cfg);
+            report_finish(ctx.report, &total);
+            context_bind(prev);
+        }
+        context_free(&ctx);
+    }
+
+    if (out) fclose(out);
+    if (in) fclose(in);
+    if (u->result != 0 && out) remove(u->output);
+    fclose(err);
+    u->ms = elapsed_ms(&start);
+}
+
+/* Cada línea del archivo con su nombre adelante, para poder mezclarlos */
+static void print_diagnostics(BatchUnit *u) {
+    char *line = u->diag;
+    char *end = u->diag + u->diag_size;
+    while (line < end) {
+        char *nl = memchr(line, '\n', end - line);
+        size_t len = nl ? (size_t)(nl - line) : (size_t)(end - line);
+        fprintf(stderr, "%s: %.*s\n", u->input, (int)len, line);
+        line += len + 1;
+    }
+}
+
+/* Un reporte por archivo, en el orden de la línea de comandos (en JSON, una lista) */
+static void print_reports(BatchUnit *units, int n, bool json) {
+    if (json) fputc('[', stderr);
+    for (int i = 0; i < n; i++) {
+        if (json) {
+            if (i > 0) fprintf(stderr, ",\n ");
+            report_print_json(&units[i].report, stderr);
+        } else {
+            report_print(&units[i].report, stderr);
+        }
+    }
+    if (json) fprintf(stderr, "]\n");
+}
+
+int run_batch(Config *cfg) {
+    int n = cfg->input_count;
+    int jobs = cfg->jobs;
+    if (jobs == 0) jobs = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (jobs > n) jobs = n;
+    if (jobs < 1) jobs = 1;
+
+    // Los archivos no imprimen nada propio por stdout: la información de -d la da el driver
+    Config unit_cfg = *cfg;
+    unit_cfg.debug = false;
+
+    BatchUnit *units = calloc(n, sizeof(BatchUnit));
+    for (int i = 0; i < n; i++) {
+        units[i].input = cfg->input_files[i];
+        units[i].output = replace_extension(cfg->input_files[i], ".s");
+        units[i].cfg = &unit_cfg;
+    }
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    ThreadPool *pool = pool_create(jobs);
+    for (int i = 0; i < n; i++) units[i].pool = pool;
+    PoolGroup group = { 0 };
+    for (int i = 0; i < n; i++) pool_submit(pool, &group, compile_unit, &units[i]);
+    pool_wait(pool, &group);
+    double total_ms = elapsed_ms(&start);
+
+    int result = 0, failed = 0;
+    for (int i = 0; i < n; i++) {
+        BatchUnit *u = &units[i];
+        print_diagnostics(u);
+        if (u->result != 0) failed++;
+        if (u->result > result) result = u->result;
+        if (cfg->debug)
+            printf("[DEBUG] %s -> %s: %s (%.3f ms, hilo %d)\n", u->input, u->output,
+                   u->result == 0 ? "ok" : "error", u->ms, u->worker);
+    }
+    if (failed) fprintf(stderr, "%d de %d archivo(s) con errores\n", failed, n);
+    if (cfg->time_report) print_reports(units, n, strcasecmp(cfg->time_report, "json") == 0);
+    if (cfg->debug) {
+        pool_print_stats(pool, stdout);
+        printf("[DEBUG] %d archivo(s) con %d hilo(s) en %.3f ms\n", n, jobs, total_ms);
+    }
+
+    pool_destroy(pool);
+    for (int i = 0; i < n; i++) {
+        free(units[i].output);
+        free(units[i].diag);
+    }
+    free(units);
+    return result;
+}
@@ -0,0 +1,69 @@
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+#include "Context.h"
+
+int context_init(CompilerContext *ctx, const char *input_file, FILE *in, FILE *err) {
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->input_file = input_file;
+    ctx->err = err;
+    ctx->arena = arena_create();
+    ctx->names = intern_create();
+
+    if (yylex_init_extra(ctx, &ctx->scanner) != 0) {
+        fprintf(err, "Error al crear el lexer: %s\n", strerror(errno));
+        return 1;
+    }
+    yyset_in(in, ctx->scanner);
+
+    initTypeStack(&ctx->types, err);
+    initScopeStack(&ctx->scopes, err);
+    pushScope(&ctx->scopes, createTable());
+    return 0;
+}
+
+void context_free(CompilerContext *ctx) {
+    if (ctx->scanner) yylex_destroy(ctx->scanner);
+    ctx->scanner = NULL;
+
+    free(ctx->scopes.frames);
+    free(ctx->scopes.undo);
+    ctx->scopes.frames = NULL;
+    ctx->scopes.undo = NULL;
+
+    while (ctx->decl_vars) {
+        SymbolNode *next = ctx->decl_vars->next;
+        free(ctx->decl_vars);
+        ctx->decl_vars = next;
+    }
+
+    free(ctx->pending_params);
+    ctx->pending_params = NULL;
+    ctx->pending_count = ctx->pending_capacity = 0;
+
+    free(ctx->ir_locals.items);
+    free(ctx->ir_globals.items);
+    free(ctx->ir_methods.items);
+    free(ctx->temps.items);
+    free(ctx->locals.items);
+    memset(&ctx->ir_locals, 0, sizeof(IRSymbols));
+    memset(&ctx->ir_globals, 0, sizeof(IRSymbols));
+    memset(&ctx->ir_methods, 0, sizeof(IRSymbols));
+    memset(&ctx->temps, 0, sizeof(IRValueTable));
+    memset(&ctx->locals, 0, sizeof(IRValueTable));
+
+    arena_destroy(ctx->arena);
+    intern_destroy(ctx->names);
+    ctx->arena = NULL;
+    ctx->names = NULL;
+}
+
+static _Thread_local CompilerContext *bound = NULL;
+
+CompilerContext *context_bind(CompilerContext *ctx) {
+    CompilerContext *prev = bound;
+    bound = ctx;
+    arena_bind(ctx ? ctx->arena : NULL);
+    intern_bind(ctx ? ctx->names : NULL);
+    return prev;
+}
@@ -7,24 +7,18 @@
 #include "Error.h"
 #include "stages.h"
 #include "utils.h"
+#include "Arena.h"
+#include "Context.h"
 
-extern int semantic_error;   // variable global
 struct Tree;  /* forward declaration */
-int main_decl = 0; // chequear la existencia del metodo main
-extern TypeStack typeStack;
-ScopeStack scope_Stack;  // pila global de scopes
-int current_offset = 0; // offset actual en la pila
-int param_offset = 0; // offset actual para parámetros
-int in_function = 0; // flag para saber si estamos dentro de una función
-int in_param = 0; // flag para saber si estamos dentro de los parámetros de una función
-
-Tree* createNode(typeTree tipo, Symbol *sym, Tree *left, Tree *right) {
-    Tree *n = malloc(sizeof(Tree));
+
+Tree* createNode(typeTree tipo, Symbol *sym, Tree *left, Tree *right, int lineno) {
+    Tree *n = ARENA_NEW(ARENA_AST, Tree);
     n->tipo = tipo;
     n->sym = sym;
     n->left = left;
     n->right = right;
-    n->lineno = yylineno;  // Asignar el número de línea actual
+    n->lineno = lineno;  // línea del lexer al reducir la regla
     return n;
 }
 
@@ -100,73 +94,6 @@ const char* tipoToStr(typeTree t) {
     }
 }
 
-int evaluate(Tree *node) {
-    if (!node) return 0;
-    switch(node->tipo) {
-        case NODE_INT: return node->sym->valor.value;
-        case NODE_TRUE: return 1;
-        case NODE_FALSE: return 0;
-
-        case NODE_ID: return node->sym->valor.value;
-        
-        case NODE_SUM: return evaluate(node->left) + evaluate(node->right);
-        case NODE_RES: return evaluate(node->left) - evaluate(node->right);
-        case NODE_MUL: return evaluate(node->left) * evaluate(node->right);
-        case NODE_DIV: 
-            if (evaluate(node->right) == 0) {
-                printf("Error: División por cero\n");
-                return 0;
-            } else {
-                return evaluate(node->left) / evaluate(node->right);
-            }
-        case NODE_MOD: {
-            int right = evaluate(node->right);
-            if (right == 0) {
-                printf("Error: Módulo por cero\n");
-                return 0;
-            }
-            return evaluate(node->left) % right;
-        }    
-        case NODE_PARENS: return evaluate(node->left);  
-
-        case NODE_OR:    return evaluate(node->left) || evaluate(node->right);
-        case NODE_AND:   return evaluate(node->left) && evaluate(node->right);
-        case NODE_NOT:   return !evaluate(node->left);
-        case NODE_EQ:    return evaluate(node->left) == evaluate(node->right);
-        case NODE_NEQ:   return evaluate(node->left) != evaluate(node->right);
-        case NODE_LE:    return evaluate(node->left) <= evaluate(node->right);
-        case NODE_LT:    return evaluate(node->left) <  evaluate(node->right);
-        case NODE_GE:    return evaluate(node->left) >= evaluate(node->right);
-        case NODE_GT:    return evaluate(node->left) >  evaluate(node->right);
-
-        // Agregá más operadores según tu gramática
-        default: return 0;
-    }
-}
-
-void execute(Tree *node) {
-    if (!node) return;
-
-    switch(node->tipo) {
-        case NODE_ASSIGN:
-            node->sym->valor.value = evaluate(node->left);
-            break;
-
-        case NODE_LIST:
-        case NODE_BLOCK:
-        case NODE_PROGRAM:
-        case NODE_METHOD:
-        case NODE_CODE:
-            execute(node->left);
-            execute(node->right);
-            break;
-
-        default:
-            // Otros nodos no hacen nada
-            break;
-    }
-}
-
 int has_return(Tree *n) {
                     if (!n) return 0;                 // nodo nulo
                     if (n->tipo == NODE_BLOCK) return 0;
@@ -176,7 +103,7 @@ int has_return(Tree *n) {
                     return has_return(n->left) || has_return(n->right);
                 } 
 
-SymbolType check_types(Tree *node){
+SymbolType check_types(CompilerContext *ctx, Tree *node){
     if (!node) return TYPE_VOID;  // nodo vacío siempre error
 
     switch(node->tipo) {
@@ -188,7 +115,7 @@ SymbolType check_types(Tree *node){
 
         case NODE_ID:{
                 if (!node->sym) {
-                    semantic_error = 1;
+                    ctx->semantic_error = 1;
                     return TYPE_ERROR;
                 }
                 return node->sym->type; 
@@ -196,11 +123,11 @@ SymbolType check_types(Tree *node){
 
         case NODE_ASSIGN: {
                 SymbolType var_type = node->sym ? node->sym->type : TYPE_ERROR;
-                SymbolType expr_type = check_types(node->left);
+                SymbolType expr_type = check_types(ctx, node->left);
                 if (var_type != expr_type) {
-                    yyerrorf(node->lineno,"Asignación incompatible en variable '%s' (esperado %d, encontrado %d)",
+                    yyerrorf(ctx, node->lineno,"Asignación incompatible en variable '%s' (esperado %d, encontrado %d)",
                  node->sym ? node->sym->name : "?", var_type, expr_type);
-                    semantic_error = 1;
+                    ctx->semantic_error = 1;
                     return TYPE_ERROR;
                 }
                 return var_type;
@@ -209,26 +136,26 @@ SymbolType check_types(Tree *node){
         case NODE_SUM:
         case NODE_RES:
         case NODE_MUL: {
-                SymbolType left = check_types(node->left);
-                SymbolType right = check_types(node->right);
+                SymbolType left = check_types(ctx, node->left);
+                SymbolType right = check_types(ctx, node->right);
                 if (left != TYPE_INT || right != TYPE_INT) {
-                    yyerrorf(node->lineno, "Operador aritmético espera enteros (encontrado %d y %d)", left, right);
-                    semantic_error = 1;
+                    yyerrorf(ctx, node->lineno, "Operador aritmético espera enteros (encontrado %d y %d)", left, right);
+                    ctx->semantic_error = 1;
                     return TYPE_ERROR;
                 }
                 return TYPE_INT;
             }
         case NODE_MOD:
         case NODE_DIV: {
-                SymbolType left = check_types(node->left);
-                SymbolType right = check_types(node->right);
+                SymbolType left = check_types(ctx, node->left);
+                SymbolType right = check_types(ctx, node->right);
                 if (left != TYPE_INT || right != TYPE_INT) {
-                    yyerrorf(node->lineno,"Operador aritmético espera enteros (encontrado %d y %d)", left, right);
-                    semantic_error = 1;
+                    yyerrorf(ctx, node->lineno,"Operador aritmético espera enteros (encontrado %d y %d)", left, right);
+                    ctx->semantic_error = 1;
                     return TYPE_ERROR;
                 } else if(node->right->tipo == NODE_INT && node->right->sym->valor.value == 0) {
-                    yyerrorf(node->lineno,"División o módulo por cero");
-                    semantic_error = 1;
+                    yyerrorf(ctx, node->lineno,"División o módulo por cero");
+                    ctx->semantic_error = 1;
                     return TYPE_ERROR;
                 }
                 return TYPE_INT;
@@ -238,11 +165,11 @@ SymbolType check_types(Tree *node){
         case NODE_LT:
         case NODE_GE:
         case NODE_GT: {
-                SymbolType left = check_types(node->left);
-                SymbolType right = check_types(node->right);
+                SymbolType left = check_types(ctx, node->left);
+                SymbolType right = check_types(ctx, node->right);
                 if (left != TYPE_INT || right != TYPE_INT) {
-                    yyerrorf(node->lineno,"Operador relacional espera enteros (encontrado %d y %d)", left, right);
-                    semantic_error = 1;
+                    yyerrorf(ctx, node->lineno,"Operador relacional espera enteros (encontrado %d y %d)", left, right);
+                    ctx->semantic_error = 1;
                     return TYPE_ERROR;
                 }
                 return TYPE_BOOL;
@@ -250,11 +177,11 @@ SymbolType check_types(Tree *node){
 
         case NODE_EQ:
         case NODE_NEQ: {
-            SymbolType left = check_types(node->left);
-            SymbolType right = check_types(node->right);
+            SymbolType left = check_types(ctx, node->left);
+            SymbolType right = check_types(ctx, node->right);
             if (left != right) {
-                yyerrorf(node->lineno,"Comparación de tipos incompatibles (%d != %d)", left, right);
-                semantic_error = 1;
+                yyerrorf(ctx, node->lineno,"Comparación de tipos incompatibles (%d != %d)", left, right);
+                ctx->semantic_error = 1;
                 return TYPE_ERROR;
             }
             return TYPE_BOOL;
@@ -262,44 +189,43 @@ SymbolType check_types(Tree *node){
 
         case NODE_OR:
         case NODE_AND: {
-                SymbolType left = check_types(node->left);
-                SymbolType right = check_types(node->right);
+                SymbolType left = check_types(ctx, node->left);
+                SymbolType right = check_types(ctx, node->right);
                 if (left != TYPE_BOOL || right != TYPE_BOOL) {
-                    yyerrorf(node->lineno,"Operador lógico espera booleanos (encontrado %d y %d)", left, right);
-                    semantic_error = 1;
+                    yyerrorf(ctx, node->lineno,"Operador lógico espera booleanos (encontrado %d y %d)", left, right);
+                    ctx->semantic_error = 1;
                     return TYPE_ERROR;
                 }
                 return TYPE_BOOL;
             }
 
         case NODE_NOT: {
-                SymbolType left = check_types(node->left);
+                SymbolType left = check_types(ctx, node->left);
                 if (left != TYPE_BOOL) {
-                    printf("Error: operador NOT espera booleano\n");
-                    semantic_error = 1;
+                    yyerrorf(ctx, node->lineno,"Operador NOT espera booleano (encontrado %d)", left);
                     return TYPE_ERROR;
                 }
                 return TYPE_BOOL;
             }
 
         case NODE_PARENS:
-            return check_types(node->left);
+            return check_types(ctx, node->left);
 
         case NODE_LIST: {
-                check_types(node->left);
-                check_types(node->right);
+                check_types(ctx, node->left);
+                check_types(ctx, node->right);
                 return TYPE_VOID;
             }
 
         case NODE_BLOCK: {
-                check_types(node->left);
-                check_types(node->right);
+                check_types(ctx, node->left);
+                check_types(ctx, node->right);
                 return TYPE_VOID;
             }
 
         case NODE_CODE:
-            check_types(node->left);
-            check_types(node->right);
+            check_types(ctx, node->left);
+            check_types(ctx, node->right);
             return TYPE_VOID;
 
         case NODE_PROGRAM: {
@@ -309,18 +235,18 @@ SymbolType check_types(Tree *node){
                 else if (node->left->tipo == NODE_T_BOOL) t = TYPE_BOOL;
                 else t = TYPE_VOID;
 
-                pushType(&typeStack, t);
-                check_types(node->right);
-                popType(&typeStack);
+                pushType(&ctx->types, t);
+                check_types(ctx, node->right);
+                popType(&ctx->types);
                 return TYPE_VOID;
             }
 
         case NODE_RETURN: {
-                SymbolType expected = peekType(&typeStack);
-                SymbolType got = node->left ? check_types(node->left) : TYPE_VOID;
+                SymbolType expected = peekType(&ctx->types);
+                SymbolType got = node->left ? check_types(ctx, node->left) : TYPE_VOID;
                 if (expected != got) {
-                    yyerrorf(node->lineno,"Return de tipo %d, esperado %d", got, expected);
-                    semantic_error = 1;
+                    yyerrorf(ctx, node->lineno,"Return de tipo %d, esperado %d", got, expected);
+                    ctx->semantic_error = 1;
                     return TYPE_ERROR;
                 }
                 return got;
@@ -329,17 +255,17 @@ SymbolType check_types(Tree *node){
         case NODE_METHOD: {
                 // push tipo del método en la pila
                 SymbolType t = node->sym->type;
-                pushType(&typeStack, t);
-                check_types(node->right); // cuerpo del método
-                popType(&typeStack);
+                pushType(&ctx->types, t);
+                check_types(ctx, node->right); // cuerpo del método
+                popType(&ctx->types);
                     
                 if (!node->right )
                 {
                     return TYPE_VOID;
                 }  else {
                     if (!has_return(node->right->left) && !has_return(node->right->right)) {
-                        yyerrorf(node->lineno,"El método '%s' debe tener una sentencia return", node->sym->name);
-                        semantic_error = 1;
+                        yyerrorf(ctx, node->lineno,"El método '%s' debe tener una sentencia return", node->sym->name);
+                        ctx->semantic_error = 1;
                         return TYPE_ERROR;
                     }
                     return TYPE_VOID;
@@ -349,14 +275,14 @@ SymbolType check_types(Tree *node){
         case NODE_METHOD_CALL: {
             Symbol *method_sym = node->left->sym;
             if (!method_sym) {
-                yyerrorf(node->lineno,"Llamada a método no declarada");
-                semantic_error = 1;
+                yyerrorf(ctx, node->lineno,"Llamada a método no declarada");
+                ctx->semantic_error = 1;
                 return TYPE_ERROR;
             }
 
             if ( !method_sym->node) {
-                yyerrorf(node->lineno,"Símbolo de método '%s' no tiene nodo asociado", method_sym->name);
-                semantic_error = 1;
+                yyerrorf(ctx, node->lineno,"Símbolo de método '%s' no tiene nodo asociado", method_sym->name);
+                ctx->semantic_error = 1;
                 return TYPE_ERROR;  // o lo que uses como valor de error
             }
 
@@ -376,11 +302,10 @@ SymbolType check_types(Tree *node){
 
                 if (c->left->sym == NULL) {
                     // todavía no se resolvió → buscá el tipo con check_types
-                    t_call = check_types(c->left);
+                    t_call = check_types(ctx, c->left);
 
                     if (t_call == TYPE_ERROR) {
-                        printf("Error: expresión inválida en llamada a método\n");
-                        semantic_error = 1;
+                        yyerrorf(ctx, node->lineno,"Expresión inválida en llamada a '%s'", method_sym->name);
                         return TYPE_ERROR;
                     }
                 } else {
@@ -389,8 +314,8 @@ SymbolType check_types(Tree *node){
                 }
 
                 if (t_decl != t_call) {
-                    yyerrorf(node->lineno,"Parámetros con tipos distintos en llamada a '%s'", method_sym->name);
-                    semantic_error = 1;
+                    yyerrorf(ctx, node->lineno,"Parámetros con tipos distintos en llamada a '%s'", method_sym->name);
+                    ctx->semantic_error = 1;
                     return TYPE_ERROR;
                 }
 
@@ -400,8 +325,8 @@ SymbolType check_types(Tree *node){
 
             // Si alguna lista todavía tiene elementos -> error de cantidad
             if (d || c) {
-                yyerrorf(node->lineno,"Cantidad de parámetros distinta en llamada a '%s'", method_sym->name);
-                semantic_error = 1;
+                yyerrorf(ctx, node->lineno,"Cantidad de parámetros distinta en llamada a '%s'", method_sym->name);
+                ctx->semantic_error = 1;
                 return TYPE_ERROR;
             }
 
@@ -411,48 +336,48 @@ SymbolType check_types(Tree *node){
 
 
         case NODE_UMINUS: {
-                SymbolType expr_type = check_types(node->left);
+                SymbolType expr_type = check_types(ctx, node->left);
                 if (expr_type != TYPE_INT) {
-                    yyerrorf(node->lineno,"Operador unario menos espera entero (encontrado %d)", expr_type);
-                    semantic_error = 1;
+                    yyerrorf(ctx, node->lineno,"Operador unario menos espera entero (encontrado %d)", expr_type);
+                    ctx->semantic_error = 1;
                     return TYPE_ERROR;
                 }
                 return TYPE_INT;
             }
 
         case NODE_IF: {
-                    SymbolType cond_type = check_types(node->left);
+                    SymbolType cond_type = check_types(ctx, node->left);
                     if (cond_type != TYPE_BOOL) {
-                        yyerrorf(node->lineno,"Condición de IF debe ser booleano (encontrado %d)", cond_type);
-                        semantic_error = 1;
+                        yyerrorf(ctx, node->lineno,"Condición de IF debe ser booleano (encontrado %d)", cond_type);
+                        ctx->semantic_error = 1;
                         return TYPE_ERROR;
                     }
-                    check_types(node->right); // cuerpo del if
+                    check_types(ctx, node->right); // cuerpo del if
                     return TYPE_VOID;
             }
 
         case NODE_IF_ELSE: {
-                SymbolType cond_type = check_types(node->left);
+                SymbolType cond_type = check_types(ctx, node->left);
                 if (cond_type != TYPE_BOOL) {
-                    yyerrorf(node->lineno,"Condición de IF debe ser booleano (encontrado %d)", cond_type);
-                    semantic_error = 1;
+                    yyerrorf(ctx, node->lineno,"Condición de IF debe ser booleano (encontrado %d)", cond_type);
+                    ctx->semantic_error = 1;
                     return TYPE_ERROR;
                 }
                 // cuerpo del if
-                check_types(node->right->left);
+                check_types(ctx, node->right->left);
                 // cuerpo del else
-                check_types(node->right->right);
+                check_types(ctx, node->right->right);
                 return TYPE_VOID;
             }
 
         case NODE_WHILE: {
-                SymbolType cond_type = check_types(node->left);
+                SymbolType cond_type = check_types(ctx, node->left);
                 if (cond_type != TYPE_BOOL) {
-                    yyerrorf(node->lineno,"Condición de WHILE debe ser booleano (encontrado %d)", cond_type);
-                    semantic_error = 1;
+                    yyerrorf(ctx, node->lineno,"Condición de WHILE debe ser booleano (encontrado %d)", cond_type);
+                    ctx->semantic_error = 1;
                     return TYPE_ERROR;
                 }
-                check_types(node->right); // cuerpo del while
+                check_types(ctx, node->right); // cuerpo del while
                 return TYPE_VOID;
             }
 
@@ -460,11 +385,11 @@ SymbolType check_types(Tree *node){
             SymbolType var_type = node->sym ? node->sym->type : TYPE_ERROR;
 
             if (node->right) {  // solo chequea si hay inicialización
-                SymbolType init_type = check_types(node->right);
+                SymbolType init_type = check_types(ctx, node->right);
                 if (var_type != init_type) {
-                    yyerrorf(node->lineno,"Declaración con tipo incompatible en variable '%s' (esperado %d, encontrado %d)",
+                    yyerrorf(ctx, node->lineno,"Declaración con tipo incompatible en variable '%s' (esperado %d, encontrado %d)",
                      node->sym->name, node->sym->type, init_type);
-                    semantic_error = 1;
+                    ctx->semantic_error = 1;
                     return TYPE_ERROR;
                 }
             }
@@ -475,14 +400,14 @@ SymbolType check_types(Tree *node){
         
         case NODE_ARGS:
             // chequeo de argumentos en llamadas
-            check_types(node->left);
-            check_types(node->right);
+            check_types(ctx, node->left);
+            check_types(ctx, node->right);
             return TYPE_VOID;
         
         case NODE_METHOD_HEADER:
             // chequeo de la cabecera del método
-            check_types(node->left);  // tipo de retorno
-            check_types(node->right); // parámetros
+            check_types(ctx, node->left);  // tipo de retorno
+            check_types(ctx, node->right); // parámetros
             return TYPE_VOID;
         
         case NODE_T_INT: return TYPE_INT;
@@ -492,8 +417,8 @@ SymbolType check_types(Tree *node){
         case NODE_T_VOID: return TYPE_VOID;
 
         default: {
-                yyerrorf(node->lineno,"Nodo de tipo desconocido en check_types");
-                semantic_error = 1;
+                yyerrorf(ctx, node->lineno,"Nodo de tipo desconocido en check_types");
+                ctx->semantic_error = 1;
                 return TYPE_ERROR;
             }
     }
@@ -501,132 +426,132 @@ SymbolType check_types(Tree *node){
 
 
 
-void check_scopes(Tree *node) {
+void check_scopes(CompilerContext *ctx, Tree *node) {
     if (!node) return;
 
     switch (node->tipo) {
         case NODE_PROGRAM:
             // Scope global
-            pushScope(&scope_Stack, createTable());
-            check_scopes(node->left);   // tipo o declaraciones globales
-            check_scopes(node->right);  // resto del programa
-            popScope(&scope_Stack);
+            pushScope(&ctx->scopes, createTable());
+            check_scopes(ctx, node->left);   // tipo o declaraciones globales
+            check_scopes(ctx, node->right);  // resto del programa
+            popScope(&ctx->scopes);
             break;
 
         case NODE_BLOCK:
-            pushScope(&scope_Stack, createTable());
-            check_scopes(node->left);   // declaraciones / params
-            check_scopes(node->right);  // cuerpo
-            popScope(&scope_Stack);
+            pushScope(&ctx->scopes, createTable());
+            check_scopes(ctx, node->left);   // declaraciones / params
+            check_scopes(ctx, node->right);  // cuerpo
+            popScope(&ctx->scopes);
             break;
         case NODE_METHOD:
             // Nuevo scope
-            SymbolTable *current = peekScope(&scope_Stack);
+            SymbolTable *current = peekScope(&ctx->scopes);
             Symbol *sym; 
             if (lookupSymbol(current, node->sym->name)) {
-                    yyerrorf(node->lineno,"Redeclaración de método: '%s'", node->sym->name);
-                    semantic_error = 1;
+                    yyerrorf(ctx, node->lineno,"Redeclaración de método: '%s'", node->sym->name);
+                    ctx->semantic_error = 1;
                 } else {
-                    sym = insertSymbol(current, node->sym->name, node->sym->type, node->sym->valor);
+                    sym = declareInScope(&ctx->scopes, node->sym->name, node->sym->type, node->sym->valor);
                 }
 
-            if (strcmp(node->sym->name, "main") == 0) {main_decl = 1;} // Exactamente debe encontrar "main"
+            if (strcmp(node->sym->name, "main") == 0) {ctx->main_decl = 1;} // Exactamente debe encontrar "main"
 
             if (sym) {
                 sym->node = node;
                 node->sym = sym;  // opcional, por si querés que apunten al mismo
             }
-            pushScope(&scope_Stack, createTable());
-            check_scopes(node->left);   // declaraciones / params
-            check_scopes(node->right);  // cuerpo
-            popScope(&scope_Stack);
+            pushScope(&ctx->scopes, createTable());
+            check_scopes(ctx, node->left);   // declaraciones / params
+            check_scopes(ctx, node->right);  // cuerpo
+            popScope(&ctx->scopes);
             break;
 
         case NODE_DECLARATION:
             if (node->sym) {
-                SymbolTable *current = peekScope(&scope_Stack);
+                SymbolTable *current = peekScope(&ctx->scopes);
                 if (lookupSymbol(current, node->sym->name)) {
-                    yyerrorf(node->lineno,"Redeclaración de '%s'", node->sym->name);
-                    semantic_error = 1;
+                    yyerrorf(ctx, node->lineno,"Redeclaración de '%s'", node->sym->name);
+                    ctx->semantic_error = 1;
                 } else {
-                    Symbol *inserted_sym = insertSymbol(current, node->sym->name, node->sym->type, node->sym->valor);
+                    Symbol *inserted_sym = declareInScope(&ctx->scopes, node->sym->name, node->sym->type, node->sym->valor);
         
                     node->sym = inserted_sym;
                     /* Si es el scope global y hay inicializacion,
                     solo permitimos un literal */
-                    if (scope_Stack.top == 0 && node->right) {
+                    if (ctx->scopes.top == 0 && node->right) {
                         if (!(node->right->tipo == NODE_INT ||
                                 node->right->tipo == NODE_TRUE ||
                                 node->right->tipo == NODE_FALSE)) {
-                            yyerrorf(node->lineno,
+                            yyerrorf(ctx, node->lineno,
                             "La inicialización de variable global '%s' debe ser un literal constante",
                             node->sym->name);
-                            semantic_error = 1;
+                            ctx->semantic_error = 1;
                         }
                     }
                     // Scope global y se quiere declarar despues de la funcion main
-                    if(scope_Stack.top == 0 && main_decl == 1) {
-                        yyerrorf(node->lineno,
+                    if(ctx->scopes.top == 0 && ctx->main_decl == 1) {
+                        yyerrorf(ctx, node->lineno,
                                 "La variable global '%s' no puede ser declarada/inicializada despues de main ",
                                 node->sym->name);
-                        semantic_error = 1;
+                        ctx->semantic_error = 1;
                     }
                 }
             }
-            check_scopes(node->left);
-            check_scopes(node->right);
+            check_scopes(ctx, node->left);
+            check_scopes(ctx, node->right);
             break;
 
         case NODE_ID:
             if (node->sym) {
-                Symbol *s = lookupInScopes(&scope_Stack, node->sym->name);
+                Symbol *s = lookupInScopes(&ctx->scopes, node->sym->name);
                 if (!s) {
-                    yyerrorf(node->lineno,"Variable '%s' no declarada", node->sym->name);
-                    semantic_error = 1;
+                    yyerrorf(ctx, node->lineno,"Variable '%s' no declarada", node->sym->name);
+                    ctx->semantic_error = 1;
                 } else {
                     // linkear el símbolo encontrado
                     node->sym = s;
                 }
             }
-            check_scopes(node->left);
-            check_scopes(node->right);
+            check_scopes(ctx, node->left);
+            check_scopes(ctx, node->right);
             break;
         
         case NODE_METHOD_CALL:
             if (node->sym) {
-                Symbol *s = lookupInScopes(&scope_Stack, node->sym->name);
+                Symbol *s = lookupInScopes(&ctx->scopes, node->sym->name);
                 if (!s) {
-                    yyerrorf(node->lineno,"Llamada a método '%s' no declarado", node->sym->name);
-                    semantic_error = 1;
+                    yyerrorf(ctx, node->lineno,"Llamada a método '%s' no declarado", node->sym->name);
+                    ctx->semantic_error = 1;
                 } else {
                     node->sym = s;                // linkear el método
                     node->left->sym = s;          // linkear el ID dentro del call
                 }
             }
-            check_scopes(node->left);
-            check_scopes(node->right);
+            check_scopes(ctx, node->left);
+            check_scopes(ctx, node->right);
             break;
         
         case NODE_ASSIGN: 
             if (node->sym) {
-                Symbol *s = lookupInScopes(&scope_Stack, node->sym->name);
+                Symbol *s = lookupInScopes(&ctx->scopes, node->sym->name);
                 if (!s) {
-                    yyerrorf(node->lineno,"Variable '%s' no declarada", node->sym->name);
-                    semantic_error = 1;
+                    yyerrorf(ctx, node->lineno,"Variable '%s' no declarada", node->sym->name);
+                    ctx->semantic_error = 1;
                 } else {
                     node->sym = s;                // linkear la variable
                     
                 }
             }
-            check_scopes(node->left);
-            check_scopes(node->right);
+            check_scopes(ctx, node->left);
+            check_scopes(ctx, node->right);
             break;
 
 
 
         default:
-            check_scopes(node->left);
-            check_scopes(node->right);
+            check_scopes(ctx, node->left);
+            check_scopes(ctx, node->right);
             break;
     }
 }
@@ -27,18 +27,24 @@
 #include "Tree.h"
 #include "SymbolTable.h"
 #include "Error.h"
+#include "Context.h"
 
-extern FILE *yyin;
-extern int yylineno;
+/* Línea actual del lexer reentrante (los nodos y los errores la guardan) */
+#define CURRENT_LINE yyget_lineno(scanner)
 
-ScopeStack scope_stack;
-Tree *ast_root;
+/* Las listas (código, sentencias, parámetros) son recursivas a derecha y
+   apilan un elemento por ítem: la pila crece a pedido hasta este tope */
+#define YYMAXDEPTH 10000000
 
-int had_error = 0;
+%}
 
-int yylex(void);
+%code requires {
+struct CompilerContext;
+}
 
-%}
+%code {
+int yylex(YYSTYPE *lval, void *scanner);
+}
 
 %union {
     int num;               /* para INT */
@@ -47,6 +53,9 @@ int yylex(void);
     struct Symbol* sym; /* para la tabla de simbolos*/
 }
 %define parse.trace
+%define api.pure full
+%lex-param   { void *scanner }
+%parse-param { void *scanner } { struct CompilerContext *ctx }
 
 
 
@@ -70,33 +79,33 @@ int yylex(void);
 %type <node> program code var_decl method_decl params all_types block block_decl block_statement statement method_call args expr block_item
 %%
 program : PROGRAM '{' code '}'  {
-                                    ast_root = $3;
+                                    ctx->ast_root = $3;
                                 }
         ;
 
-code: var_decl code { $$ = createNode(NODE_CODE, NULL,$1, $2); }
-    | method_decl code { $$ = createNode(NODE_CODE, NULL, $1, $2); }
+code: var_decl code { $$ = createNode(NODE_CODE, NULL,$1, $2, CURRENT_LINE); }
+    | method_decl code { $$ = createNode(NODE_CODE, NULL, $1, $2, CURRENT_LINE); }
     | /* vacío */ { $$ = NULL; }
     ;
 
 var_decl: all_types ID '=' expr ';' {
             if ($1->tipo == NODE_T_VOID) {
-                yyerrorf(yylineno,"No se puede declarar variable '%s' de tipo void");
+                yyerrorf(ctx, CURRENT_LINE, "No se puede declarar variable '%s' de tipo void");
                 $$ = NULL;  // opcional: seguir parseando
             } else {
                 Valores v = {0};
                 Symbol *s = createSymbol($2,$1,VAR,v);
-                $$ = createNode(NODE_DECLARATION, s, $1, $4);
+                $$ = createNode(NODE_DECLARATION, s, $1, $4, CURRENT_LINE);
             }
         }
         | all_types ID ';' { 
             if ($1->tipo == NODE_T_VOID) {
-                yyerrorf(yylineno,"No se puede declarar variable '%s' de tipo void",$2);
+                yyerrorf(ctx, CURRENT_LINE, "No se puede declarar variable '%s' de tipo void",$2);
                 $$ = NULL;
             } else {
                 Valores v = {0};
                 Symbol *s = createSymbol($2,$1,VAR,v);
-                $$ = createNode(NODE_DECLARATION, s, $1, NULL);
+                $$ = createNode(NODE_DECLARATION, s, $1, NULL, CURRENT_LINE);
             }
         }
         ;
@@ -105,15 +114,15 @@ method_decl : all_types ID '(' params ')' block {
                 Valores v = {0};
                 Symbol *s = createSymbol($2,$1,FUNC,v);
                 Tree *methodInfo;
-                methodInfo = createNode(NODE_METHOD_HEADER, 0, createNode(NODE_ID, s, $1, NULL), createNode(NODE_ARGS, 0, $4, NULL));
-                $$ = createNode(NODE_METHOD, s, methodInfo, $6);
+                methodInfo = createNode(NODE_METHOD_HEADER, 0, createNode(NODE_ID, s, $1, NULL, CURRENT_LINE), createNode(NODE_ARGS, 0, $4, NULL, CURRENT_LINE), CURRENT_LINE);
+                $$ = createNode(NODE_METHOD, s, methodInfo, $6, CURRENT_LINE);
                 s->node =$$;
             }
             | all_types ID '(' params ')' EXTERN ';' {
                 Valores v = {0};
                 Symbol *s = createSymbol($2,$1,FUNC,v);
-                Tree *methodInfo = createNode(NODE_METHOD_HEADER, 0, createNode(NODE_ID, s, $1, NULL), createNode(NODE_ARGS, 0, $4, NULL));
-                $$ = createNode(NODE_METHOD, s, methodInfo, NULL);
+                Tree *methodInfo = createNode(NODE_METHOD_HEADER, 0, createNode(NODE_ID, s, $1, NULL, CURRENT_LINE), createNode(NODE_ARGS, 0, $4, NULL, CURRENT_LINE), CURRENT_LINE);
+                $$ = createNode(NODE_METHOD, s, methodInfo, NULL, CURRENT_LINE);
                 s->node = $$;
             }
             ;
@@ -121,44 +130,44 @@ method_decl : all_types ID '(' params ')' block {
 
 params  : all_types ID ',' params {
             if ($1->tipo == NODE_T_VOID) {
-                yyerrorf(yylineno,"No se puede declarar parámetro '%s' de tipo void", $2);
+                yyerrorf(ctx, CURRENT_LINE, "No se puede declarar parámetro '%s' de tipo void", $2);
                 $$ = $4;  // ignoramos este parámetro y seguimos
             } else {
                 Valores v = {0};
                 Symbol *s = createSymbol($2,$1,VAR,v);
-                $$ = createNode(NODE_LIST, 0, createNode(NODE_DECLARATION, s, $1, NULL), $4);
+                $$ = createNode(NODE_LIST, 0, createNode(NODE_DECLARATION, s, $1, NULL, CURRENT_LINE), $4, CURRENT_LINE);
             }
         }
         | all_types ID  { 
             if ($1->tipo == NODE_T_VOID) {
-                yyerrorf(yylineno,"No se puede declarar parámetro '%s' de tipo void", $2);
+                yyerrorf(ctx, CURRENT_LINE, "No se puede declarar parámetro '%s' de tipo void", $2);
                 $$ = NULL;
             } else {
                 Valores v = {0};
                 Symbol *s = createSymbol($2,$1,VAR,v);
-                Tree *decl = createNode(NODE_DECLARATION, s, $1, NULL);
-                $$ = createNode(NODE_LIST, 0, decl, NULL);
+                Tree *decl = createNode(NODE_DECLARATION, s, $1, NULL, CURRENT_LINE);
+                $$ = createNode(NODE_LIST, 0, decl, NULL, CURRENT_LINE);
             }
         }
         | /* vacío */ { $$ = NULL; }
         ;
 
 
-all_types   : T_INT { $$ = createNode(NODE_T_INT, 0, NULL, NULL); }
-            | T_BOOL { $$ = createNode(NODE_T_BOOL, 0, NULL, NULL); }
-            | T_VOID { $$ = createNode(NODE_T_VOID, 0, NULL, NULL); }
+all_types   : T_INT { $$ = createNode(NODE_T_INT, 0, NULL, NULL, CURRENT_LINE); }
+            | T_BOOL { $$ = createNode(NODE_T_BOOL, 0, NULL, NULL, CURRENT_LINE); }
+            | T_VOID { $$ = createNode(NODE_T_VOID, 0, NULL, NULL, CURRENT_LINE); }
             ;
 
 block   : '{' block_decl block_statement '}' {
-            $$ = createNode(NODE_BLOCK, 0, $2, $3);
+            $$ = createNode(NODE_BLOCK, 0, $2, $3, CURRENT_LINE);
         }
         ;
 
-block_decl  : var_decl block_decl { $$ = createNode(NODE_LIST, 0, $1, $2); }
+block_decl  : var_decl block_decl { $$ = createNode(NODE_LIST, 0, $1, $2, CURRENT_LINE); }
                 | /* vacío */ { $$ = NULL; }
             ;
 
-block_statement : block_item block_statement { $$ = createNode(NODE_LIST, 0, $1, $2); }
+block_statement : block_item block_statement { $$ = createNode(NODE_LIST, 0, $1, $2, CURRENT_LINE); }
                 | /* vacío */ { $$ = NULL; }
                 ;
     
@@ -169,14 +178,14 @@ block_item  : statement
     /*sentencias*/
 statement   : ID '=' expr ';' {
                 Symbol *s = createSymbolCall($1,VAR);
-                $$ = createNode(NODE_ASSIGN, s, $3, NULL);
+                $$ = createNode(NODE_ASSIGN, s, $3, NULL, CURRENT_LINE);
             }
             | method_call ';' { $$ = $1; }
-            | IF '(' expr ')' THEN block {$$ = createNode(NODE_IF, 0, $3, $6);}
-            | IF '(' expr ')' THEN block ELSE block { $$ = createNode(NODE_IF_ELSE, 0, $3, createNode(NODE_LIST, 0, $6, $8)); }
-            | WHILE expr block { $$ = createNode(NODE_WHILE, 0, $2, $3); }
-            | RETURN ';' { $$ = createNode(NODE_RETURN, 0, NULL, NULL); }
-            | RETURN expr ';' { $$ = createNode(NODE_RETURN, 0, $2, NULL); }
+            | IF '(' expr ')' THEN block {$$ = createNode(NODE_IF, 0, $3, $6, CURRENT_LINE);}
+            | IF '(' expr ')' THEN block ELSE block { $$ = createNode(NODE_IF_ELSE, 0, $3, createNode(NODE_LIST, 0, $6, $8, CURRENT_LINE), CURRENT_LINE); }
+            | WHILE expr block { $$ = createNode(NODE_WHILE, 0, $2, $3, CURRENT_LINE); }
+            | RETURN ';' { $$ = createNode(NODE_RETURN, 0, NULL, NULL, CURRENT_LINE); }
+            | RETURN expr ';' { $$ = createNode(NODE_RETURN, 0, $2, NULL, CURRENT_LINE); }
             | block { $$ = $1; }
             | ';' { $$ = NULL; }
         ;
@@ -184,54 +193,54 @@ statement   : ID '=' expr ';' {
 method_call : ID '(' args ')' { 
                 Symbol *s = createSymbolCall($1,FUNC);
                 // Creamos el nodo del identificador
-                Tree *idNode = createNode(NODE_ID, s, NULL, NULL);
+                Tree *idNode = createNode(NODE_ID, s, NULL, NULL, CURRENT_LINE);
 
                 // Creamos el nodo de argumentos (puede ser NULL si no hay)
-                Tree *argsNode = createNode(NODE_ARGS, 0, $3, NULL);
+                Tree *argsNode = createNode(NODE_ARGS, 0, $3, NULL, CURRENT_LINE);
 
                 // Nodo final del método
-                $$ = createNode(NODE_METHOD_CALL, s, idNode, argsNode);
+                $$ = createNode(NODE_METHOD_CALL, s, idNode, argsNode, CURRENT_LINE);
             }
             ;
     
-args: expr ',' args { $$ = createNode(NODE_LIST, 0, $1, $3); }
-    | expr { $$ = createNode(NODE_LIST, 0, $1, NULL); }
+args: expr ',' args { $$ = createNode(NODE_LIST, 0, $1, $3, CURRENT_LINE); }
+    | expr { $$ = createNode(NODE_LIST, 0, $1, NULL, CURRENT_LINE); }
     | /* vacío */ { $$ = NULL; }
     ;
 
 expr: ID {
         Symbol *s = createSymbolCall($1,VAR);
-        $$ = createNode(NODE_ID, s, NULL, NULL);
+        $$ = createNode(NODE_ID, s, NULL, NULL, CURRENT_LINE);
     }
     | method_call {$$ = $1;}
     | INT {
         Symbol *s = createLiteralSymbol($1, TYPE_INT);
-        $$ = createNode(NODE_INT, s, NULL, NULL);
+        $$ = createNode(NODE_INT, s, NULL, NULL, CURRENT_LINE);
     }
     | TRUE {
         Symbol *s = createLiteralSymbol(1, TYPE_BOOL);
-        $$ = createNode(NODE_TRUE, s, NULL, NULL);
+        $$ = createNode(NODE_TRUE, s, NULL, NULL, CURRENT_LINE);
     }
     | FALSE {
         Symbol *s = createLiteralSymbol(0, TYPE_BOOL);
-        $$ = createNode(NODE_FALSE, s, NULL, NULL);
+        $$ = createNode(NODE_FALSE, s, NULL, NULL, CURRENT_LINE);
     }
-    | expr '+' expr { $$ = createNode(NODE_SUM,0,$1,$3); }
-    | expr '-' expr { $$ = createNode(NODE_RES,0,$1,$3); }
-    | expr '*' expr { $$ = createNode(NODE_MUL,0,$1,$3); }
-    | expr '/' expr { $$ = createNode(NODE_DIV,0,$1,$3); }
-    | expr '%' expr { $$ = createNode(NODE_MOD,0,$1,$3); }
-    | expr EQ expr  { $$ = createNode(NODE_EQ,0,$1,$3); }
-    | expr NEQ expr { $$ = createNode(NODE_NEQ,0,$1,$3); }
-    | expr '<' expr { $$ = createNode(NODE_LT,0,$1,$3); }
-    | expr '>' expr { $$ = createNode(NODE_GT,0,$1,$3); }
-    | expr LE expr  { $$ = createNode(NODE_LE,0,$1,$3); }
-    | expr GE expr  { $$ = createNode(NODE_GE,0,$1,$3); }
-    | expr AND expr { $$ = createNode(NODE_AND,0,$1,$3); }
-    | expr OR expr  { $$ = createNode(NODE_OR,0,$1,$3); }
-    | '-' expr %prec UMINUS { $$ = createNode(NODE_UMINUS, 0, $2, NULL); } 
-    | '!' expr %prec UMINUS { $$ = createNode(NODE_NOT,0,$2,NULL); }
-    | '(' expr ')' { $$ = createNode(NODE_PARENS,0,$2,NULL); }
+    | expr '+' expr { $$ = createNode(NODE_SUM,0,$1,$3, CURRENT_LINE); }
+    | expr '-' expr { $$ = createNode(NODE_RES,0,$1,$3, CURRENT_LINE); }
+    | expr '*' expr { $$ = createNode(NODE_MUL,0,$1,$3, CURRENT_LINE); }
+    | expr '/' expr { $$ = createNode(NODE_DIV,0,$1,$3, CURRENT_LINE); }
+    | expr '%' expr { $$ = createNode(NODE_MOD,0,$1,$3, CURRENT_LINE); }
+    | expr EQ expr  { $$ = createNode(NODE_EQ,0,$1,$3, CURRENT_LINE); }
+    | expr NEQ expr { $$ = createNode(NODE_NEQ,0,$1,$3, CURRENT_LINE); }
+    | expr '<' expr { $$ = createNode(NODE_LT,0,$1,$3, CURRENT_LINE); }
+    | expr '>' expr { $$ = createNode(NODE_GT,0,$1,$3, CURRENT_LINE); }
+    | expr LE expr  { $$ = createNode(NODE_LE,0,$1,$3, CURRENT_LINE); }
+    | expr GE expr  { $$ = createNode(NODE_GE,0,$1,$3, CURRENT_LINE); }
+    | expr AND expr { $$ = createNode(NODE_AND,0,$1,$3, CURRENT_LINE); }
+    | expr OR expr  { $$ = createNode(NODE_OR,0,$1,$3, CURRENT_LINE); }
+    | '-' expr %prec UMINUS { $$ = createNode(NODE_UMINUS, 0, $2, NULL, CURRENT_LINE); } 
+    | '!' expr %prec UMINUS { $$ = createNode(NODE_NOT,0,$2,NULL, CURRENT_LINE); }
+    | '(' expr ')' { $$ = createNode(NODE_PARENS,0,$2,NULL, CURRENT_LINE); }
     ;
 
 %%  
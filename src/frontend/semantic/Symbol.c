@@ -2,13 +2,10 @@
 #include <string.h>
 #include "Symbol.h"
 #include "Tree.h"
+#include "Arena.h"
 
-Symbol* createSymbol(const char *name, struct Tree *typeNode, SymbolKind kind, Valores valor) {
-    Symbol *s = malloc(sizeof(Symbol));
-    if (!s) {
-        perror("malloc");
-        exit(1);
-    }
+Symbol* createSymbol(char *name, struct Tree *typeNode, SymbolKind kind, Valores valor) {
+    Symbol *s = ARENA_NEW(ARENA_SYMBOLS, Symbol);
 
     // traducir nodo a SymbolType
     SymbolType t;
@@ -22,13 +19,8 @@ Symbol* createSymbol(const char *name, struct Tree *typeNode, SymbolKind kind, V
     s->type = t;
     s->kind = kind;
 
-    // copiamos el nombre
-    s->name = strdup(name);
-    if (!s->name) {
-        perror("strdup");
-        free(s);
-        exit(1);
-    }
+    // el lexer ya lo internó: se guarda el mismo puntero
+    s->name = name;
 
     s->valor = valor;
     s->node = NULL; // lo podés linkear después si necesitás
@@ -37,17 +29,13 @@ Symbol* createSymbol(const char *name, struct Tree *typeNode, SymbolKind kind, V
 }
 
 
-Symbol *createSymbolCall(const char *name, SymbolKind kind) {
-    Symbol *sym = malloc(sizeof(Symbol));
-    if (!sym) {
-        fprintf(stderr, "Error: no se pudo asignar memoria para Symbol\n");
-        exit(EXIT_FAILURE);
-    }
+Symbol *createSymbolCall(char *name, SymbolKind kind) {
+    Symbol *sym = ARENA_NEW(ARENA_SYMBOLS, Symbol);
 
     // Inicializamos con valores neutros / desconocidos
     sym->type = TYPE_ERROR;    // tipo desconocido por ahora
     sym->kind = kind;           
-    sym->name = strdup(name);  // copiamos el nombre
+    sym->name = name;          // ya internado por el lexer
     Valores v = {0};
     sym->valor = v;  // nada asignado todavía
     sym->node = NULL;          // no hay nodo asociado aún
@@ -62,11 +50,7 @@ Symbol *createSymbolCall(const char *name, SymbolKind kind) {
  * @return Un puntero al nuevo Symbol.
  */
 Symbol* createLiteralSymbol(int value, SymbolType type) {
-    Symbol *s = malloc(sizeof(Symbol));
-    if (!s) {
-        fprintf(stderr, "Error: sin memoria para símbolo literal\n");
-        exit(1);
-    }
+    Symbol *s = ARENA_NEW(ARENA_SYMBOLS, Symbol);
 
     s->name = NULL;         // Los literales no tienen nombre.
     s->type = type;
@@ -1,64 +1,102 @@
 #include <stdlib.h>
 #include <string.h>
 #include "SymbolTable.h"
+#include "SymbolMap.h"
+#include "Arena.h"
 
 SymbolTable* createTable() {
     SymbolTable *t = malloc(sizeof(SymbolTable));
     t->size = 0;
     t->capacity = 16;
     t->symbols = malloc(sizeof(Symbol*) * t->capacity);
+    t->names = malloc(sizeof(char*) * t->capacity);
+    t->slot_capacity = 32;
+    t->slots = malloc(sizeof(int) * t->slot_capacity);
+    memset(t->slots, -1, sizeof(int) * t->slot_capacity);
     return t;
 }
 
-Symbol* insertSymbol(SymbolTable *table, const char *name, SymbolType type, Valores value ) {
+/* Slot de 'key' (nombre internado), o el libre donde insertarlo */
+static int *find_slot(SymbolTable *table, const char *key) {
+    unsigned mask = table->slot_capacity - 1;
+    unsigned i = hash_ptr(key) & mask;
+    while (table->slots[i] >= 0 && table->names[table->slots[i]] != key) i = (i + 1) & mask;
+    return &table->slots[i];
+}
+
+static void grow_slots(SymbolTable *table) {
+    free(table->slots);
+    table->slot_capacity *= 2;
+    table->slots = malloc(sizeof(int) * table->slot_capacity);
+    memset(table->slots, -1, sizeof(int) * table->slot_capacity);
+    for (int i = 0; i < table->size; i++) *find_slot(table, table->names[i]) = i;
+}
+
+/* Agrega una posición nueva para 'key' y la devuelve */
+static int add_entry(SymbolTable *table, const char *key, Symbol *sym) {
+    if (table->size == table->capacity) {
+        table->capacity *= 2;
+        table->symbols = realloc(table->symbols, sizeof(Symbol*) * table->capacity);
+        table->names = realloc(table->names, sizeof(char*) * table->capacity);
+    }
+    if ((table->size + 1) * 2 > table->slot_capacity) grow_slots(table);
+
+    int pos = table->size++;
+    table->symbols[pos] = sym;
+    table->names[pos] = key;
+    *find_slot(table, key) = pos;
+    return pos;
+}
+
+Symbol* insertSymbol(SymbolTable *table, char *name, SymbolType type, Valores value ) {
     if (!name) {
     fprintf(stderr, "Error: insertSymbol recibió un nombre NULL\n");
     return NULL;
     }
     // Chequear duplicados
-    for (int i = 0; i < table->size; i++) {
-        if (table->symbols[i] && table->symbols[i]->name) {
-            if (strcmp(table->symbols[i]->name, name) == 0) {
-                return table->symbols[i]; // ya existe
-            }
-        }
-    }
-
-    if (table->size == table->capacity) {
-        table->capacity *= 2;
-        table->symbols = realloc(table->symbols, sizeof(Symbol*) * table->capacity);
+    int slot = *find_slot(table, name);
+    if (slot >= 0 && table->symbols[slot]) {
+        return table->symbols[slot]; // ya existe
     }
 
-    Symbol *s = malloc(sizeof(Symbol));
-    s->name = strdup(name);
+    Symbol *s = ARENA_NEW(ARENA_SYMBOLS, Symbol);
+    s->name = name;
     s->type = type;
     if (type == TYPE_INT )
     {
-        s->valor.value = value.value;    
+        s->valor.value = value.value;
     } else if (type == TYPE_BOOL)
     {
         s->valor.value = value.value;
     }
 
-    table->symbols[table->size++] = s;
+    if (slot >= 0) table->symbols[slot] = s;
+    else add_entry(table, name, s);
     return s;
 }
 
 Symbol* lookupSymbol(SymbolTable *table, const char *name) {
-    if (table == NULL || table->symbols == NULL) return NULL;
+    if (table == NULL || table->symbols == NULL || name == NULL) return NULL;
+    int slot = *find_slot(table, name);
+    return slot >= 0 ? table->symbols[slot] : NULL;
+}
 
-    for (int i = 0; i < table->size; i++) {
-        if (table->symbols[i] && strcmp(table->symbols[i]->name, name) == 0) {
-            return table->symbols[i];
-        }
+Symbol* bindSymbol(SymbolTable *table, const char *name, Symbol *sym) {
+    int slot = *find_slot(table, name);
+    if (slot < 0) {
+        if (sym) add_entry(table, name, sym);
+        return NULL;
     }
-    return NULL;
+    Symbol *prev = table->symbols[slot];
+    table->symbols[slot] = sym;
+    return prev;
 }
 
 void printSymbolTable(SymbolTable *table) {
     printf("Tabla de símbolos:\n");
     for (int i = 0; i < table->size; i++) {
         Symbol *s = table->symbols[i];
+        if (!s) continue;
         printf("  %s = %d (tipo: %d)\n", s->name, s->valor.value, s->type);
     }
 }
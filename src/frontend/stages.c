@@ -1,76 +1,348 @@
-#include "Stages.h"
-
-int run_scan_stage(FILE *f, bool debug) {
-    int tok;
-    int lexico_valido = 1;
-
-    while ((tok = yylex()) != 0) {
-        if (tok == UNKNOW) {
-            fprintf(stderr, "Error léxico: '%s'\n", yytext);
-            lexico_valido = 0;
-            break;
-        }
-        if (debug) PRINT_TOKEN(tok);
-    }
-
-    printf(lexico_valido ? "Léxico válido ✔️\n" : "Léxico inválido ⚠️\n");
-    return lexico_valido ? 0 : 1;
-}
-
-int run_parse_stage(Config *cfg) {
-    if (cfg->debug) yydebug = 1;
-
-    if (yyparse() != 0) {
-        fprintf(stderr, "Error en el parseo ❌\n");
-        return 1;
-    }
-
-    if (had_error || !ast_root) {
-        fprintf(stderr, "Se detectaron errores. No se ejecutará el AST.\n");
-        return 1;
-    }
-
-    if (strcasecmp(cfg->target, "parse") == 0) {
-        printf("Árbol antes de ejecutar asignaciones:\n");
-        printTree(ast_root, 0);
-    }
-
-    check_scopes(ast_root);
-    check_types(ast_root);
-
-    if (main_decl == 0) {
-        fprintf(stderr, "Error semántico: no se encontró definido el método main\n");
-        return 2;
-    }
-    if (semantic_error) {
-        fprintf(stderr, "Error semántico\n");
-        return 2;
-    }
-
-    return 0;
-}
-
-int run_codinter_stage(void) {
-    IRList list;
-    ir_init(&list);
-    gen_code(ast_root, &list);
-    ir_print(&list);
-    return 0;
-}
-
-int run_assembly_stage(FILE *f, bool debug) {
-    if (debug) printf("[DEBUG] Calculando offsets...\n");
-    calculate_offsets(ast_root);
-    if (debug) printf("[DEBUG] Offsets calculados correctamente\n");
-
-    IRList list;
-    ir_init(&list);
-    gen_code(ast_root, &list);
-    offset_temps(&list);
-
-    if (debug) printf("[DEBUG] Generando código assembly...\n");
-    generateAssembly(&list);
-
-    //printf("Código assembly generado correctamente ✔️\n");
-    return 0;
-}
+#include <time.h>
+#include "Stages.h"
+
+int run_scan_stage(CompilerContext *ctx, FILE *f, bool debug) {
+    int tok;
+    int lexico_valido = 1;
+    YYSTYPE lval;
+
+    while ((tok = yylex(&lval, ctx->scanner)) != 0) {
+        if (tok == UNKNOW) {
+            fprintf(ctx->err, "Error léxico: '%s'\n", yyget_text(ctx->scanner));
+            lexico_valido = 0;
+            break;
+        }
+        if (debug) PRINT_TOKEN(tok, yyget_text(ctx->scanner));
+    }
+
+    printf(lexico_valido ? "Léxico válido ✔️\n" : "Léxico inválido ⚠️\n");
+    return lexico_valido ? 0 : 1;
+}
+
+/* yyparse pide los tokens al lexer: a la fase de parseo se le descuenta lo que midió yylex */
+static void exclude_lex(TimeReport *report, PhaseStats *lex_before) {
+    PhaseStats *parse = &report->phases[PHASE_PARSE];
+    PhaseStats *lex = &report->phases[PHASE_LEX];
+    parse->wall_ms -= lex->wall_ms - lex_before->wall_ms;
+    parse->cpu_ms -= lex->cpu_ms - lex_before->cpu_ms;
+    parse->allocs -= lex->allocs - lex_before->allocs;
+    parse->bytes -= lex->bytes - lex_before->bytes;
+}
+
+int run_parse_stage(CompilerContext *ctx, Config *cfg) {
+    if (cfg->debug) yydebug = 1;
+
+    PhaseTimer timer;
+    PhaseStats lex_before = ctx->report ? ctx->report->phases[PHASE_LEX] : (PhaseStats){ 0 };
+    report_start(ctx->report, &timer);
+    int parsed = yyparse(ctx->scanner, ctx);
+    report_stop(ctx->report, PHASE_PARSE, &timer);
+    if (ctx->report) exclude_lex(ctx->report, &lex_before);
+
+    if (parsed != 0) {
+        fprintf(ctx->err, "Error en el parseo ❌\n");
+        return 1;
+    }
+
+    if (ctx->had_error || !ctx->ast_root) {
+        fprintf(ctx->err, "Se detectaron errores. No se ejecutará el AST.\n");
+        return 1;
+    }
+
+    if (strcasecmp(cfg->target, "parse") == 0) {
+        printf("Árbol antes de ejecutar asignaciones:\n");
+        printTree(ctx->ast_root, 0);
+    }
+
+    report_start(ctx->report, &timer);
+    check_scopes(ctx, ctx->ast_root);
+    check_types(ctx, ctx->ast_root);
+    report_stop(ctx->report, PHASE_SEMANTIC, &timer);
+    if (ctx->report) {
+        ctx->report->ast_nodes = arena_objects(ARENA_AST);
+        ctx->report->symbols = arena_objects(ARENA_SYMBOLS);
+    }
+
+    if (ctx->main_decl == 0) {
+        fprintf(ctx->err, "Error semántico: no se encontró definido el método main\n");
+        return 2;
+    }
+    if (ctx->semantic_error) {
+        fprintf(ctx->err, "Error semántico\n");
+        return 2;
+    }
+
+    return 0;
+}
+
+/* Los pases de optimización de una unidad; corre en el hilo que la toma */
+static void optimize_unit(IRUnit *unit, void *arg) {
+    Config *cfg = arg;
+    run_optimizations(&unit->ctx, &unit->list, cfg->debug);
+    if (unit->ctx.report) unit->ctx.report->ir_optimized += unit->list.size;
+}
+
+/*
+ * Offsets de parámetros y locales, y el código intermedio de todo el
+ * archivo. gen_code necesita distinguir globales y parámetros (lo marca
+ * calculate_offsets) para elegir el tipo de cada operando.
+ */
+static void lower_ast(CompilerContext *ctx, IRList *list) {
+    PhaseTimer timer;
+    report_start(ctx->report, &timer);
+    calculate_offsets(ctx->ast_root);
+    report_stop(ctx->report, PHASE_OFFSETS, &timer);
+    report_start(ctx->report, &timer);
+    gen_code(ctx, ctx->ast_root, list);
+    report_stop(ctx->report, PHASE_GEN_CODE, &timer);
+    if (ctx->report) ctx->report->ir_instructions = list->size;
+}
+
+int run_codinter_stage(CompilerContext *ctx, Config *cfg) {
+    IRList list;
+    ir_init(&list);
+    lower_ast(ctx, &list);
+    if (!cfg->optimization) {
+        ir_print(ctx, &list);
+        ir_free(&list);
+        return 0;
+    }
+
+    // Cada método se optimiza por separado y se vuelven a juntar en orden
+    IRUnits units;
+    IRList optimized;
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    units_split(ctx, &list, &units);
+    units_run(ctx, &units, optimize_unit, cfg);
+    if (ctx->report) ctx->report->units_wall_ms += elapsed_ms(&start);
+    ir_init(&optimized);
+    units_join(&units, &optimized);
+    ir_print(ctx, &optimized);
+
+    ir_free(&optimized);
+    units_free(&units);
+    ir_free(&list);
+    return 0;
+}
+
+typedef struct {
+    Config *cfg;
+    unsigned peephole_rules;
+    bool machine_code;          // a ctx->mc_out (X86.h) en lugar de assembly
+} LowerArgs;
+
+/* Optimiza una unidad, le asigna registros y slots y la traduce a assembly o a código máquina */
+static void lower_unit(IRUnit *unit, void *arg) {
+    LowerArgs *args = arg;
+    bool debug = args->cfg->debug;
+    TimeReport *report = unit->ctx.report;
+    PhaseTimer timer;
+
+    if (args->cfg->optimization) run_optimizations(&unit->ctx, &unit->list, debug);
+    if (report) report->ir_optimized += unit->list.size;
+
+    if (optimization_enabled("regalloc")) {
+        report_start(report, &timer);
+        allocate_registers(&unit->ctx, &unit->list, debug);
+        report_stop(report, PHASE_REGALLOC, &timer);
+    }
+
+    report_start(report, &timer);
+    offset_temps(&unit->ctx, &unit->list, optimization_enabled("slots"));
+    report_stop(report, PHASE_OFFSET_TEMPS, &timer);
+
+    report_start(report, &timer);
+    if (args->machine_code) {
+        generateUnitMachineCode(&unit->ctx, &unit->list);
+        report_stop(report, PHASE_MACHINE_CODE, &timer);
+        return;
+    }
+    generateUnitAssembly(&unit->ctx, &unit->list, args->peephole_rules);
+    report_stop(report, PHASE_ASSEMBLY, &timer);
+    if (report) report->asm_lines += asm_line_count(&unit->ctx.asm_out);
+}
+
+int run_assembly_stage(CompilerContext *ctx, FILE *f, Config *cfg) {
+    bool debug = cfg->debug;
+    if (debug) printf("[DEBUG] Calculando offsets y código intermedio...\n");
+    IRList list;
+    ir_init(&list);
+    lower_ast(ctx, &list);
+
+    LowerArgs args = { cfg, 0, false };
+    if (optimization_enabled("peep-mov")) args.peephole_rules |= PEEP_MOVES;
+    if (optimization_enabled("peep-jmp")) args.peephole_rules |= PEEP_JUMPS;
+    if (optimization_enabled("peep-cmp")) args.peephole_rules |= PEEP_BRANCHES;
+    if (optimization_enabled("peep-shl")) args.peephole_rules |= PEEP_SHIFTS;
+
+    // Desde acá cada método sigue por su cuenta, en paralelo si hay pool
+    if (debug) printf("[DEBUG] Generando código assembly...\n");
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    IRUnits units;
+    units_split(ctx, &list, &units);
+    units_run(ctx, &units, lower_unit, &args);
+    double units_ms = elapsed_ms(&start);
+    if (ctx->report) ctx->report->units_wall_ms += units_ms;
+    if (debug) {
+        printf("[DEBUG] %d unidad(es), %d método(s), %s: %.3f ms\n", units.count, units.methods,
+               ctx->pool ? "en paralelo" : "en orden", units_ms);
+    }
+
+    PhaseTimer timer;
+    report_start(ctx->report, &timer);
+    int written = generateAssembly(ctx, &units, f);
+    report_stop(ctx->report, PHASE_OUTPUT, &timer);
+    units_free(&units);
+    ir_free(&list);
+    if (written != 0) return 1;
+
+    //printf("Código assembly generado correctamente ✔️\n");
+    return 0;
+}
+
+/* Como run_assembly_stage hasta la traducción: deja en 'text' el código máquina de todas las unidades */
+static void lower_machine_code(CompilerContext *ctx, Config *cfg, X86Code *text) {
+    IRList list;
+    ir_init(&list);
+    lower_ast(ctx, &list);
+
+    LowerArgs args = { cfg, 0, true };
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    IRUnits units;
+    units_split(ctx, &list, &units);
+    units_run(ctx, &units, lower_unit, &args);
+    if (ctx->report) ctx->report->units_wall_ms += elapsed_ms(&start);
+
+    x86_init(text);
+    for (int i = 0; i < units.count; i++) {
+        collect_globals(ctx, &units.units[i].list);
+        x86_append(text, &units.units[i].ctx.mc_out);
+    }
+    units_free(&units);
+    ir_free(&list);
+}
+
+int run_interpret_stage(CompilerContext *ctx) {
+    // El intérprete ubica parámetros y locales en el marco con los offsets del backend
+    PhaseTimer timer;
+    report_start(ctx->report, &timer);
+    calculate_offsets(ctx->ast_root);
+    report_stop(ctx->report, PHASE_OFFSETS, &timer);
+
+    report_start(ctx->report, &timer);
+    int status = interpret(ctx);
+    report_stop(ctx->report, PHASE_RUN, &timer);
+    return status;
+}
+
+/* El caché va junto al fuente: prog.ctds -> prog.tbc */
+static void cache_path(const char *input, char *path, size_t size) {
+    size_t len = strlen(input);
+    if (len > 5 && strcmp(input + len - 5, ".ctds") == 0) len -= 5;
+    snprintf(path, size, "%.*s.tbc", (int)len, input);
+}
+
+/* Todo el fuente, para el hash; deja 'in' al principio para el parser */
+static char *read_source(FILE *in, size_t *size) {
+    size_t capacity = 4096;
+    char *source = malloc(capacity);
+    *size = 0;
+    size_t n;
+    while ((n = fread(source + *size, 1, capacity - *size, in)) > 0) {
+        *size += n;
+        if (*size == capacity) source = realloc(source, capacity *= 2);
+    }
+    rewind(in);
+    return source;
+}
+
+/* Parseo, código intermedio (optimizado por método si hay -opt) y bytecode */
+static int compile_bytecode(CompilerContext *ctx, Config *cfg, BcProgram *prog) {
+    int result = run_parse_stage(ctx, cfg);
+    if (result != 0) return result;
+
+    IRList list;
+    ir_init(&list);
+    lower_ast(ctx, &list);
+
+    PhaseTimer timer;
+    if (cfg->optimization) {
+        IRUnits units;
+        IRList optimized;
+        units_split(ctx, &list, &units);
+        units_run(ctx, &units, optimize_unit, cfg);
+        ir_init(&optimized);
+        units_join(&units, &optimized);
+        report_start(ctx->report, &timer);
+        bc_compile(ctx, &optimized, prog);
+        report_stop(ctx->report, PHASE_BYTECODE, &timer);
+        ir_free(&optimized);
+        units_free(&units);
+    } else {
+        report_start(ctx->report, &timer);
+        bc_compile(ctx, &list, prog);
+        report_stop(ctx->report, PHASE_BYTECODE, &timer);
+    }
+    ir_free(&list);
+    return 0;
+}
+
+int run_vm_stage(CompilerContext *ctx, Config *cfg, FILE *in) {
+    size_t size;
+    char *source = read_source(in, &size);
+    uint64_t hash = bc_source_hash(source, size, cfg->optimization);
+    free(source);
+    char path[4096];
+    cache_path(cfg->input_file, path, sizeof(path));
+
+    // Si el caché es de este mismo fuente y opciones no hace falta ni parsear
+    BcProgram prog;
+    PhaseTimer timer;
+    report_start(ctx->report, &timer);
+    bool cached = bc_load(&prog, hash, path);
+    report_stop(ctx->report, PHASE_BYTECODE, &timer);
+    if (cfg->debug) printf("[DEBUG] Bytecode %s %s\n", cached ? "cargado de" : "no está al día en", path);
+
+    if (!cached) {
+        int result = compile_bytecode(ctx, cfg, &prog);
+        if (result != 0) return result;
+        if (!bc_save(&prog, hash, path))
+            fprintf(ctx->err, "Aviso: no se pudo guardar el bytecode en %s\n", path);
+    }
+    if (cfg->debug) bc_print(&prog, stdout);
+
+    report_start(ctx->report, &timer);
+    int status = vm_run(&prog, ctx->err);
+    report_stop(ctx->report, PHASE_RUN, &timer);
+    bc_free(&prog);
+    return status;
+}
+
+int run_jit_stage(CompilerContext *ctx, Config *cfg) {
+    X86Code text;
+    lower_machine_code(ctx, cfg, &text);
+    if (cfg->debug) printf("[DEBUG] %d bytes de código máquina, %d reubicaciones\n", text.size, text.reloc_count);
+
+    PhaseTimer timer;
+    report_start(ctx->report, &timer);
+    int status = jit_run(ctx, &text);
+    report_stop(ctx->report, PHASE_RUN, &timer);
+    x86_free(&text);
+    return status;
+}
+
+int run_object_stage(CompilerContext *ctx, FILE *f, Config *cfg) {
+    X86Code text;
+    lower_machine_code(ctx, cfg, &text);
+    if (cfg->debug) printf("[DEBUG] %d bytes de código máquina, %d reubicaciones\n", text.size, text.reloc_count);
+
+    PhaseTimer timer;
+    report_start(ctx->report, &timer);
+    int written = elf_write_object(ctx, &text, f);
+    report_stop(ctx->report, PHASE_OUTPUT, &timer);
+    x86_free(&text);
+    return written != 0 ? 1 : 0;
+}
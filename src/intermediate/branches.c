@@ -0,0 +1,78 @@
+#include "Optimizer.h"
+#include "CFG.h"
+
+/*
+ * Pase 'branches': fusiona comparaciones con el salto que las consume.
+ *
+ *     LT a, b, t          ->      JGE a, b, L
+ *     GOTO t, L
+ *
+ * El GOTO condicional salta cuando la condición es falsa, por eso el salto
+ * fusionado usa la comparación inversa. Solo se fusiona si el temporal de
+ * la comparación no tiene otra lectura en el método: el booleano deja de
+ * existir y el backend emite un único cmpq + jcc.
+ */
+
+/* Salto que se toma cuando la comparación 'op' es falsa */
+static IRInstr inverse_jump(IRInstr op) {
+    switch (op) {
+        case IR_EQ:  return IR_JNE;
+        case IR_NEQ: return IR_JEQ;
+        case IR_LT:  return IR_JGE;
+        case IR_LE:  return IR_JGT;
+        case IR_GT:  return IR_JLE;
+        case IR_GE:  return IR_JLT;
+        default:     return IR_NOP;
+    }
+}
+
+static bool branches_method(IRList *list, int start, int end) {
+    IROperand uses[2];
+    IRValueRange range;
+    bool changed = false;
+
+    // Lecturas de cada temporal del método
+    ir_value_range(list, start, end, &range);
+    int *reads = calloc(range.temps > 0 ? range.temps : 1, sizeof(int));
+    for (int i = start; i <= end; i++) {
+        int n = ir_uses(&list->codes[i], uses);
+        for (int k = 0; k < n; k++) {
+            if (uses[k].kind == IRO_TEMP) reads[ir_value_index(&range, uses[k])]++;
+        }
+    }
+
+    for (int i = start; i <= end; i++) {
+        IRCode *cmp = &list->codes[i];
+        IRInstr jump = inverse_jump(cmp->op);
+        if (jump == IR_NOP || cmp->result.kind != IRO_TEMP) continue;
+
+        int next = i + 1;
+        while (next <= end && list->codes[next].op == IR_NOP) next++;
+        if (next > end) continue;
+
+        IRCode *go = &list->codes[next];
+        if (go->op != IR_GOTO || !ir_same(go->arg1, cmp->result)) continue;
+        if (reads[ir_value_index(&range, cmp->result)] != 1) continue;
+
+        go->op = jump;
+        go->arg1 = cmp->arg1;
+        go->arg2 = cmp->arg2;
+        cmp->op = IR_NOP;
+        changed = true;
+    }
+    free(reads);
+    return changed;
+}
+
+bool opt_branches(CompilerContext *ctx, IRList *list) {
+    (void)ctx;  // no crea temporales ni etiquetas
+    bool changed = false;
+
+    for (int i = 0; i < list->size; i++) {
+        if (list->codes[i].op != IR_METHOD) continue;
+        int end = ir_method_end(list, i);
+        if (branches_method(list, i, end)) changed = true;
+        i = end;
+    }
+    return changed;
+}
@@ -0,0 +1,294 @@
+#include "CFG.h"
+
+int ir_method_end(IRList *list, int start) {
+    int i = start;
+    while (i < list->size && list->codes[i].op != IR_FMETHOD) i++;
+    return i;
+}
+
+static bool ends_block(IRCode *code) {
+    return ir_is_jump(code->op) || code->op == IR_RETURN;
+}
+
+static void add_pred(BasicBlock *block, int pred) {
+    block->preds = realloc(block->preds, (block->npreds + 1) * sizeof(int));
+    block->preds[block->npreds++] = pred;
+}
+
+/* Parte el método en bloques básicos y arma las aristas */
+static void build_blocks(CFG *cfg) {
+    IRList *list = cfg->list;
+    int max_label = -1;
+
+    cfg->nblocks = 0;
+    cfg->blocks = NULL;
+    cfg->block_of = malloc((cfg->end - cfg->start + 1) * sizeof(int));
+    for (int i = cfg->start; i <= cfg->end; i++) {
+        IRCode *code = &list->codes[i];
+        bool leader = i == cfg->start || code->op == IR_LABEL || ends_block(&list->codes[i - 1]);
+        if (leader) {
+            cfg->blocks = realloc(cfg->blocks, (cfg->nblocks + 1) * sizeof(BasicBlock));
+            cfg->blocks[cfg->nblocks] = (BasicBlock){ .first = i };
+            cfg->nblocks++;
+        }
+        cfg->blocks[cfg->nblocks - 1].last = i;
+        cfg->block_of[i - cfg->start] = cfg->nblocks - 1;
+        if (code->op == IR_LABEL && code->result.id > max_label)
+            max_label = code->result.id;
+    }
+
+    // etiqueta -> bloque que empieza con ella
+    int *label_block = malloc((max_label + 2) * sizeof(int));
+    for (int b = 0; b < cfg->nblocks; b++) {
+        IRCode *code = &list->codes[cfg->blocks[b].first];
+        if (code->op == IR_LABEL) label_block[code->result.id] = b;
+    }
+
+    for (int b = 0; b < cfg->nblocks; b++) {
+        BasicBlock *block = &cfg->blocks[b];
+        IRCode *last = &list->codes[block->last];
+        int fall = (b + 1 < cfg->nblocks) ? b + 1 : -1;
+        block->succ[0] = block->succ[1] = -1;
+
+        if (ir_is_jump(last->op)) {
+            block->succ[0] = label_block[last->result.id];
+            if (ir_is_conditional(last) && fall != block->succ[0]) block->succ[1] = fall;
+        } else if (last->op != IR_RETURN) {
+            block->succ[0] = fall;
+        }
+        for (int s = 0; s < 2; s++)
+            if (block->succ[s] >= 0) add_pred(&cfg->blocks[block->succ[s]], b);
+    }
+    free(label_block);
+}
+
+/* DFS iterativo desde la entrada; deja los alcanzables en reverse postorder */
+static void compute_rpo(CFG *cfg) {
+    int n = cfg->nblocks;
+    int *stack = malloc(n * sizeof(int));
+    int *next_succ = calloc(n, sizeof(int));
+    bool *visited = calloc(n, sizeof(bool));
+    int *post = malloc(n * sizeof(int));
+    int npost = 0, top = 0;
+
+    for (int b = 0; b < n; b++) cfg->blocks[b].rpo = -1;
+
+    visited[0] = true;
+    stack[top++] = 0;
+    while (top > 0) {
+        int b = stack[top - 1];
+        if (next_succ[b] < 2) {
+            int s = cfg->blocks[b].succ[next_succ[b]++];
+            if (s >= 0 && !visited[s]) {
+                visited[s] = true;
+                stack[top++] = s;
+            }
+        } else {
+            post[npost++] = b;
+            top--;
+        }
+    }
+
+    cfg->nreachable = npost;
+    cfg->order = malloc((npost > 0 ? npost : 1) * sizeof(int));
+    for (int k = 0; k < npost; k++) {
+        int b = post[npost - 1 - k];
+        cfg->order[k] = b;
+        cfg->blocks[b].rpo = k;
+    }
+    free(stack);
+    free(next_succ);
+    free(visited);
+    free(post);
+}
+
+static int intersect(CFG *cfg, int a, int b) {
+    while (a != b) {
+        while (cfg->blocks[a].rpo > cfg->blocks[b].rpo) a = cfg->blocks[a].idom;
+        while (cfg->blocks[b].rpo > cfg->blocks[a].rpo) b = cfg->blocks[b].idom;
+    }
+    return a;
+}
+
+/*
+ * Dominadores inmediatos con el algoritmo iterativo de Cooper, Harvey y
+ * Kennedy sobre el reverse postorder; después se arma el árbol y se numera.
+ */
+static void compute_dominators(CFG *cfg) {
+    for (int b = 0; b < cfg->nblocks; b++) {
+        cfg->blocks[b].idom = -1;
+        cfg->blocks[b].dom_child = cfg->blocks[b].dom_sibling = -1;
+    }
+    cfg->blocks[0].idom = 0;
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int k = 1; k < cfg->nreachable; k++) {
+            BasicBlock *block = &cfg->blocks[cfg->order[k]];
+            int idom = -1;
+            for (int p = 0; p < block->npreds; p++) {
+                int pred = block->preds[p];
+                if (cfg->blocks[pred].idom < 0) continue;   // aún sin procesar o inalcanzable
+                idom = idom < 0 ? pred : intersect(cfg, pred, idom);
+            }
+            if (idom != block->idom) {
+                block->idom = idom;
+                changed = true;
+            }
+        }
+    }
+    cfg->blocks[0].idom = -1;
+
+    // Hijos en orden inverso para que la lista quede en reverse postorder
+    for (int k = cfg->nreachable - 1; k > 0; k--) {
+        int b = cfg->order[k];
+        BasicBlock *parent = &cfg->blocks[cfg->blocks[b].idom];
+        cfg->blocks[b].dom_sibling = parent->dom_child;
+        parent->dom_child = b;
+    }
+
+    // Numeración pre/post del árbol: a domina a b sii pre(a) <= pre(b) && post(b) <= post(a)
+    int *stack = malloc((cfg->nreachable > 0 ? cfg->nreachable : 1) * sizeof(int));
+    int *child = malloc(cfg->nblocks * sizeof(int));
+    int top = 0, counter = 0;
+    stack[top++] = 0;
+    cfg->blocks[0].dom_pre = counter++;
+    child[0] = cfg->blocks[0].dom_child;
+    while (top > 0) {
+        int b = stack[top - 1];
+        int c = child[b];
+        if (c >= 0) {
+            child[b] = cfg->blocks[c].dom_sibling;
+            cfg->blocks[c].dom_pre = counter++;
+            child[c] = cfg->blocks[c].dom_child;
+            stack[top++] = c;
+        } else {
+            cfg->blocks[b].dom_post = counter++;
+            top--;
+        }
+    }
+    free(stack);
+    free(child);
+}
+
+bool cfg_dominates(CFG *cfg, int a, int b) {
+    if (!CFG_REACHABLE(cfg, a) || !CFG_REACHABLE(cfg, b)) return false;
+    BasicBlock *x = &cfg->blocks[a], *y = &cfg->blocks[b];
+    return x->dom_pre <= y->dom_pre && y->dom_post <= x->dom_post;
+}
+
+int cfg_block_of(CFG *cfg, int i) {
+    return cfg->block_of[i - cfg->start];
+}
+
+static int compare_loop_size(const void *a, const void *b) {
+    const CFGLoop *x = a, *y = b;
+    return y->size - x->size;
+}
+
+/*
+ * Lazos naturales: cada arista b -> h con h dominando a b es un arco de
+ * retorno; el cuerpo son los bloques que llegan a b sin pasar por h. Los
+ * arcos con la misma cabecera forman un único lazo. Procesando del más
+ * grande al más chico, cada bloque termina apuntando a su lazo más interno.
+ */
+static void compute_loops(CFG *cfg) {
+    int n = cfg->nblocks;
+    int *header_loop = malloc(n * sizeof(int));
+    for (int b = 0; b < n; b++) {
+        header_loop[b] = -1;
+        cfg->blocks[b].loop = -1;
+        cfg->blocks[b].loop_depth = 0;
+    }
+
+    cfg->nloops = 0;
+    cfg->loops = NULL;
+    Bitset *bodies = NULL;
+    int words = BITSET_WORDS(n);
+    int *work = malloc(n * sizeof(int));
+
+    for (int b = 0; b < n; b++) {
+        for (int s = 0; s < 2; s++) {
+            int h = cfg->blocks[b].succ[s];
+            if (h < 0 || !cfg_dominates(cfg, h, b)) continue;
+
+            int l = header_loop[h];
+            if (l < 0) {
+                l = header_loop[h] = cfg->nloops++;
+                cfg->loops = realloc(cfg->loops, cfg->nloops * sizeof(CFGLoop));
+                bodies = realloc(bodies, cfg->nloops * sizeof(Bitset));
+                cfg->loops[l] = (CFGLoop){ h, -1, 0, 1 };
+                bodies[l] = calloc(words, sizeof(uint64_t));
+                BITSET_SET(bodies[l], h);
+            }
+
+            // Recorrido hacia atrás desde el origen del arco de retorno
+            int top = 0;
+            if (!BITSET_TEST(bodies[l], b)) {
+                BITSET_SET(bodies[l], b);
+                cfg->loops[l].size++;
+                work[top++] = b;
+            }
+            while (top > 0) {
+                BasicBlock *block = &cfg->blocks[work[--top]];
+                for (int p = 0; p < block->npreds; p++) {
+                    int pred = block->preds[p];
+                    if (!CFG_REACHABLE(cfg, pred) || BITSET_TEST(bodies[l], pred)) continue;
+                    BITSET_SET(bodies[l], pred);
+                    cfg->loops[l].size++;
+                    work[top++] = pred;
+                }
+            }
+        }
+    }
+
+    // Ordenar por tamaño decreciente, llevando los cuerpos junto con los lazos
+    int *index = malloc((cfg->nloops > 0 ? cfg->nloops : 1) * sizeof(int));
+    for (int l = 0; l < cfg->nloops; l++) {
+        index[l] = l;
+        cfg->loops[l].parent = l;      // temporalmente: índice original
+    }
+    qsort(cfg->loops, cfg->nloops, sizeof(CFGLoop), compare_loop_size);
+    for (int l = 0; l < cfg->nloops; l++) index[l] = cfg->loops[l].parent;
+
+    for (int l = 0; l < cfg->nloops; l++) {
+        CFGLoop *loop = &cfg->loops[l];
+        loop->parent = cfg->blocks[loop->header].loop;
+        loop->depth = loop->parent < 0 ? 1 : cfg->loops[loop->parent].depth + 1;
+        for (int b = 0; b < n; b++) {
+            if (!BITSET_TEST(bodies[index[l]], b)) continue;
+            cfg->blocks[b].loop = l;
+            cfg->blocks[b].loop_depth = loop->depth;
+        }
+    }
+
+    for (int l = 0; l < cfg->nloops; l++) free(bodies[l]);
+    free(bodies);
+    free(index);
+    free(work);
+    free(header_loop);
+}
+
+CFG *cfg_build(IRList *list, int start, int end) {
+    CFG *cfg = calloc(1, sizeof(CFG));
+    cfg->list = list;
+    cfg->start = start;
+    cfg->end = end;
+
+    build_blocks(cfg);
+    compute_rpo(cfg);
+    compute_dominators(cfg);
+    compute_loops(cfg);
+    return cfg;
+}
+
+void cfg_free(CFG *cfg) {
+    if (!cfg) return;
+    for (int b = 0; b < cfg->nblocks; b++) free(cfg->blocks[b].preds);
+    free(cfg->blocks);
+    free(cfg->block_of);
+    free(cfg->order);
+    free(cfg->loops);
+    free(cfg);
+}
@@ -0,0 +1,97 @@
+#include "Optimizer.h"
+#include "Liveness.h"
+
+/*
+ * Pase 'dce': eliminación de código muerto.
+ *
+ * Método por método, sobre el análisis de variables vivas:
+ * - Los bloques a los que no se llega desde la entrada (código después de
+ *   un RETURN o de un GOTO incondicional) se borran completos.
+ * - Una instrucción que define un temporal o una variable local que no se
+ *   vuelve a leer se borra, salvo que tenga efectos: los CALL se conservan
+ *   siempre y DIV/MOD también (mantienen el error de división por cero).
+ * Las globales no son valores analizados, así que sus STORE nunca se tocan.
+ * Las instrucciones borradas quedan como IR_NOP y el driver compacta la lista.
+ */
+
+static bool removable(IRInstr op) {
+    switch (op) {
+        case IR_LOAD: case IR_STORE: case IR_STORAGE:
+        case IR_ADD: case IR_SUB: case IR_MUL:
+        case IR_AND: case IR_OR: case IR_NOT: case IR_UMINUS:
+        case IR_EQ: case IR_NEQ: case IR_LT: case IR_LE: case IR_GT: case IR_GE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/* Borra los bloques a los que no se llega desde la entrada del método */
+static bool remove_unreachable(CFG *cfg) {
+    bool changed = false;
+    for (int b = 0; b < cfg->nblocks; b++) {
+        if (CFG_REACHABLE(cfg, b)) continue;
+        for (int i = cfg->blocks[b].first; i <= cfg->blocks[b].last; i++) {
+            IRCode *code = &cfg->list->codes[i];
+            // El cierre del método se conserva aunque termine con un RETURN
+            if (code->op == IR_FMETHOD || code->op == IR_NOP) continue;
+            code->op = IR_NOP;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+/* Recorre el bloque hacia atrás borrando las definiciones que nadie lee */
+static bool remove_dead_defs(Liveness *lv, int b, Bitset live, IROperand *uses) {
+    BasicBlock *block = &lv->cfg->blocks[b];
+    bool changed = false;
+
+    for (int w = 0; w < lv->words; w++) live[w] = lv->blocks[b].out[w];
+    for (int i = block->last; i >= block->first; i--) {
+        IRCode *code = &lv->list->codes[i];
+        int d = liveness_id(lv, ir_def(code));
+        if (d >= 0) {
+            if (!BITSET_TEST(live, d) && removable(code->op)) {
+                // Sus operandos no pasan a estar vivos: las cadenas de copias caen juntas
+                code->op = IR_NOP;
+                changed = true;
+                continue;
+            }
+            BITSET_CLEAR(live, d);
+        }
+        int n = liveness_uses(lv, i, uses);
+        for (int k = 0; k < n; k++) {
+            int id = liveness_id(lv, uses[k]);
+            if (id >= 0) BITSET_SET(live, id);
+        }
+    }
+    return changed;
+}
+
+static bool dce_method(CompilerContext *ctx, IRList *list, int start, int end) {
+    Liveness *lv = liveness_compute(ctx, list, start, end);
+    Bitset live = calloc(lv->words > 0 ? lv->words : 1, sizeof(uint64_t));
+    IROperand *uses = malloc(liveness_max_uses(lv) * sizeof(IROperand));
+
+    bool changed = remove_unreachable(lv->cfg);
+    for (int b = 0; b < lv->nblocks; b++) {
+        if (CFG_REACHABLE(lv->cfg, b) && remove_dead_defs(lv, b, live, uses)) changed = true;
+    }
+
+    free(uses);
+    free(live);
+    liveness_free(lv);
+    return changed;
+}
+
+bool opt_dce(CompilerContext *ctx, IRList *list) {
+    bool changed = false;
+    for (int i = 0; i < list->size; i++) {
+        if (list->codes[i].op != IR_METHOD) continue;
+        int end = ir_method_end(list, i);
+        if (dce_method(ctx, list, i, end)) changed = true;
+        i = end;
+    }
+    return changed;
+}
@@ -0,0 +1,290 @@
+#include <limits.h>
+#include "Optimizer.h"
+
+/*
+ * Pase 'fold': plegado y propagación de constantes.
+ *
+ * Recorre el código en orden llevando los valores constantes conocidos de
+ * temporales y variables. El conocimiento solo fluye por la ejecución
+ * secuencial: se descarta en cada LABEL (punto de unión de varios caminos)
+ * y al entrar a un método. Un STORE con valor desconocido mata la variable
+ * y un CALL mata todas las globales (el método invocado pudo modificarlas).
+ */
+
+/*
+ * Constantes conocidas: una entrada por temporal y variable local de la
+ * unidad (IRValueRange) y una por global que aparece en ella (de
+ * global_base en adelante). Una entrada vale si se escribió
+ * en la generación actual, así que olvidar todo es pasar a la siguiente;
+ * las globales llevan además su propia generación, que avanza en cada CALL.
+ */
+typedef struct {
+    int value;
+    unsigned gen;
+    unsigned globals_gen;
+} KnownEntry;
+
+typedef struct {
+    IRValueRange range;
+    int global_base, nglobals;
+    KnownEntry *entries;
+    unsigned gen, globals_gen;
+} Known;
+
+static void known_init(Known *k, IRList *list) {
+    ir_value_range(list, 0, list->size - 1, &k->range);
+    int lo = 0, hi = -1;
+    for (int i = 0; i < list->size; i++) {
+        IRCode *code = &list->codes[i];
+        IROperand ops[3] = { code->arg1, code->arg2, code->result };
+        for (int j = 0; j < 3; j++) {
+            if (ops[j].kind != IRO_GLOBAL) continue;
+            if (hi < lo) lo = hi = ops[j].id;
+            else if (ops[j].id < lo) lo = ops[j].id;
+            else if (ops[j].id > hi) hi = ops[j].id;
+        }
+    }
+    k->global_base = lo;
+    k->nglobals = hi - lo + 1;
+    int n = ir_value_count(&k->range) + k->nglobals;
+    k->entries = calloc(n > 0 ? n : 1, sizeof(KnownEntry));
+    k->gen = k->globals_gen = 1;
+}
+
+static KnownEntry *known_entry(Known *k, IROperand v) {
+    if (v.kind == IRO_GLOBAL) return &k->entries[ir_value_count(&k->range) + v.id - k->global_base];
+    int index = ir_value_index(&k->range, v);
+    return index < 0 ? NULL : &k->entries[index];
+}
+
+static bool known_get(Known *k, IROperand v, int *value) {
+    KnownEntry *e = known_entry(k, v);
+    if (!e || e->gen != k->gen || (v.kind == IRO_GLOBAL && e->globals_gen != k->globals_gen)) return false;
+    if (value) *value = e->value;
+    return true;
+}
+
+static void known_set(Known *k, IROperand v, int value) {
+    KnownEntry *e = known_entry(k, v);
+    if (e) *e = (KnownEntry){ value, k->gen, k->globals_gen };
+}
+
+static void known_remove(Known *k, IROperand v) {
+    KnownEntry *e = known_entry(k, v);
+    if (e) e->gen = 0;
+}
+
+/* Se olvida todo (punto de unión o entrada a un método) */
+static void known_clear(Known *k) {
+    k->gen++;
+}
+
+/* Un CALL puede modificar cualquier global: se olvidan todas */
+static void forget_globals(Known *k) {
+    k->globals_gen++;
+}
+
+/**
+ * Evalúa 'a op b' en tiempo de compilación.
+ * Devuelve false si la operación no debe plegarse (división por cero,
+ * o resultado fuera del rango de un literal).
+ */
+static bool eval_binary(IRInstr op, int a, int b, int *out) {
+    long long r;
+    switch (op) {
+        case IR_ADD: r = (long long)a + b; break;
+        case IR_SUB: r = (long long)a - b; break;
+        case IR_MUL: r = (long long)a * b; break;
+        case IR_DIV:
+            if (b == 0) return false;       // se conserva el chequeo en tiempo de ejecución
+            r = (long long)a / b;
+            break;
+        case IR_MOD:
+            if (b == 0) return false;
+            r = (long long)a % b;
+            break;
+        case IR_AND: r = a && b; break;
+        case IR_OR:  r = a || b; break;
+        case IR_EQ:  r = a == b; break;
+        case IR_NEQ: r = a != b; break;
+        case IR_LT:  r = a <  b; break;
+        case IR_LE:  r = a <= b; break;
+        case IR_GT:  r = a >  b; break;
+        case IR_GE:  r = a >= b; break;
+        default: return false;
+    }
+    if (r < INT_MIN || r > INT_MAX) return false;
+    *out = (int)r;
+    return true;
+}
+
+/* Reemplaza la instrucción por 'STORAGE value, result' */
+static void make_storage(IRCode *code, int value) {
+    code->op = IR_STORAGE;
+    code->arg1 = ir_imm(value);
+    code->arg2 = ir_none();
+}
+
+/* Reemplaza la instrucción por la copia 'STORE src, result' */
+static void make_copy(IRCode *code, IROperand src) {
+    code->op = IR_STORE;
+    code->arg1 = src;
+    code->arg2 = ir_none();
+}
+
+/**
+ * Simplificaciones algebraicas con un solo operando constante
+ * (x+0, x-0, x*1, x/1, x*0, true&&x, false||x...).
+ */
+static bool simplify_identity(IRCode *code, bool ka, int a, bool kb, int b) {
+    switch (code->op) {
+        case IR_ADD:
+            if (kb && b == 0) { make_copy(code, code->arg1); return true; }
+            if (ka && a == 0) { make_copy(code, code->arg2); return true; }
+            break;
+        case IR_SUB:
+            if (kb && b == 0) { make_copy(code, code->arg1); return true; }
+            break;
+        case IR_MUL:
+            if ((ka && a == 0) || (kb && b == 0)) { make_storage(code, 0); return true; }
+            if (kb && b == 1) { make_copy(code, code->arg1); return true; }
+            if (ka && a == 1) { make_copy(code, code->arg2); return true; }
+            break;
+        case IR_DIV:
+            if (kb && b == 1) { make_copy(code, code->arg1); return true; }
+            break;
+        case IR_AND:
+            if ((ka && a == 0) || (kb && b == 0)) { make_storage(code, 0); return true; }
+            if (ka) { make_copy(code, code->arg2); return true; }
+            if (kb) { make_copy(code, code->arg1); return true; }
+            break;
+        case IR_OR:
+            if ((ka && a) || (kb && b)) { make_storage(code, 1); return true; }
+            if (ka) { make_copy(code, code->arg2); return true; }
+            if (kb) { make_copy(code, code->arg1); return true; }
+            break;
+        default:
+            break;
+    }
+    return false;
+}
+
+bool opt_fold(CompilerContext *ctx, IRList *list) {
+    (void)ctx;  // no crea temporales ni etiquetas
+    Known known;
+    known_init(&known, list);
+    bool changed = false;
+
+    for (int i = 0; i < list->size; i++) {
+        IRCode *code = &list->codes[i];
+        int a = 0, b = 0, v;
+        bool ka, kb;
+
+        switch (code->op) {
+            case IR_METHOD:
+            case IR_FMETHOD:
+            case IR_LABEL:
+                known_clear(&known);
+                break;
+
+            case IR_STORAGE:
+                known_set(&known, code->result, code->arg1.id);
+                break;
+
+            case IR_LOAD:
+                if (known_get(&known, code->arg1, &v)) {
+                    make_storage(code, v);
+                    known_set(&known, code->result, v);
+                    changed = true;
+                } else {
+                    known_remove(&known, code->result);
+                }
+                break;
+
+            case IR_STORE:
+                if (known_get(&known, code->arg1, &v))
+                    known_set(&known, code->result, v);
+                else
+                    known_remove(&known, code->result);
+                break;
+
+            case IR_ADD: case IR_SUB: case IR_MUL: case IR_DIV: case IR_MOD:
+            case IR_AND: case IR_OR:
+            case IR_EQ: case IR_NEQ: case IR_LT: case IR_LE: case IR_GT: case IR_GE:
+                ka = known_get(&known, code->arg1, &a);
+                kb = known_get(&known, code->arg2, &b);
+                if (ka && kb && eval_binary(code->op, a, b, &v)) {
+                    make_storage(code, v);
+                    known_set(&known, code->result, v);
+                    changed = true;
+                } else if (simplify_identity(code, ka, a, kb, b)) {
+                    changed = true;
+                    if (code->op == IR_STORAGE)
+                        known_set(&known, code->result, code->arg1.id);
+                    else if (known_get(&known, code->arg1, &v))
+                        known_set(&known, code->result, v);
+                    else
+                        known_remove(&known, code->result);
+                } else {
+                    known_remove(&known, code->result);
+                }
+                break;
+
+            case IR_UMINUS:
+            case IR_NOT:
+                if (known_get(&known, code->arg1, &a)) {
+                    v = (code->op == IR_UMINUS) ? -a : !a;
+                    if (code->op == IR_UMINUS && a == INT_MIN) {
+                        known_remove(&known, code->result);
+                        break;
+                    }
+                    make_storage(code, v);
+                    known_set(&known, code->result, v);
+                    changed = true;
+                } else {
+                    known_remove(&known, code->result);
+                }
+                break;
+
+            case IR_GOTO:
+                // GOTO condicional: salta cuando la condición es falsa
+                if (ir_has(code->arg1) && known_get(&known, code->arg1, &v)) {
+                    if (v == 1) {
+                        code->op = IR_NOP;      // nunca salta
+                    } else {
+                        code->arg1 = ir_none(); // siempre salta
+                    }
+                    changed = true;
+                }
+                break;
+
+            case IR_JEQ: case IR_JNE: case IR_JLT: case IR_JLE: case IR_JGT: case IR_JGE:
+                if (known_get(&known, code->arg1, &a) && known_get(&known, code->arg2, &b) &&
+                    eval_binary(IR_EQ + (code->op - IR_JEQ), a, b, &v)) {
+                    if (v) {
+                        code->op = IR_GOTO;     // siempre salta
+                        code->arg1 = code->arg2 = ir_none();
+                    } else {
+                        code->op = IR_NOP;      // nunca salta
+                    }
+                    changed = true;
+                }
+                break;
+
+            case IR_CALL:
+                forget_globals(&known);
+                known_remove(&known, code->result);
+                break;
+
+            case IR_SAVE_PARAM:
+                known_remove(&known, code->arg1);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    free(known.entries);
+    return changed;
+}
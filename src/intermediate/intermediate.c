@@ -1,627 +1,893 @@
-#include "Tree.h"
-#include "Intermediate.h"
-
-
-
-// DEBE COINCIDIR EN POSICION CON EL ENUM IRInstr
-static const char *ir_names[] = {
-    "LOAD","DECL", "STORE","STORAGE", "ADD","SUB", "UMINUS", "MUL","DIV","MOD",
-    "AND","OR","NOT",
-    "EQ","NEQ","LT","LE","GT","GE",
-    "LABEL","GOTO", "RET", "PARAM", "CALL", "METHOD", "F_METHOD", "METH_EXT",
-    "PRINT", "SAVE_PARAM"
-};
-
-static int tempCount = 0;
-static int labelCount = 0;
-
-Symbol* newTempSymbol() {
-    Symbol *s = malloc(sizeof(Symbol));
-    char buf[16];
-    sprintf(buf, "t%d", tempCount++);
-    s->name = strdup(buf);
-    s->type = TYPE_INT;  
-    s->is_global = 0;
-    s->is_temp = 1;
-    s->offset = 0;
-    return s;
-}
-
-Symbol* newLabel() {
-    Symbol *s = malloc(sizeof(Symbol));
-    char buf[16];
-    sprintf(buf, "L%d", labelCount++);
-    s->name = strdup(buf);
-    s->type = TYPE_LABEL;
-    return s;
-}
-
-int param = 0;
-int index_param = 0;
-
-
-/**
- * @brief Genera el código para los argumentos de un método en orden inverso (R->L)
- * y emite las instrucciones IR_PARAM con el índice correcto (L->R).
- * * @param arg_list_node El nodo 'NODE_LIST' que empieza la lista de argumentos.
- * @param list La lista de IR.
- * @param current_index El índice del parámetro actual (empezando en 0 para el de más a la izquierda).
- */
-static void gen_method_args(Tree *arg_list_node, IRList *list, int current_index) {
-    if (!arg_list_node) {
-        return; // Fin de la lista de argumentos
-    }
-
-    // IR AL FONDO DE LA LISTA PRIMERO (DERECHA a IZQUIERDA)
-    gen_method_args(arg_list_node->right, list, current_index + 1);
-
-    // PROCESAR EL NODO ACTUAL (IZQUIERDA)
-    // Evalúa los argumentos de derecha a izquierda.
-    Symbol *arg_value_temp = gen_code(arg_list_node->left, list);
-
-    // Crea un símbolo "dummy" solo para pasar el índice del parámetro
-    Symbol *param_index_sym = malloc(sizeof(Symbol));
-    param_index_sym->name = NULL;
-    param_index_sym->type = TYPE_INT;
-    param_index_sym->valor.value = current_index;
-
-    // Emitir la instrucción IR_PARAM
-    ir_emit(list, IR_PARAM, arg_value_temp, param_index_sym, NULL);
-}
-
-
-Symbol* gen_code(Tree *node, IRList *list) {
-    if (!node) return NULL;
-
-    if (node->sym == NULL && 
-        (node->tipo == NODE_ID || node->tipo == NODE_ASSIGN || node->tipo == NODE_METHOD_CALL)) {
-        fprintf(stderr, "Error: nodo tipo %d sin símbolo\n", node->tipo);
-        return NULL;
-    }
-
-    
-    switch (node->tipo) {
-        case NODE_T_INT:
-        case NODE_T_BOOL:
-        case NODE_T_VOID:
-            return NULL;
-
-        case NODE_INT:
-        case NODE_TRUE:
-        case NODE_FALSE: {
-
-            
-            
-
-            // 1. Crear un nuevo símbolo temporal para guardar el valor del literal.
-            Symbol *temp_sym = newTempSymbol();
-
-            // 2. Crear un símbolo simple para encapsular el valor del literal.
-            //    Este no es un temporal en la pila, solo un portador del valor.
-            Symbol *literal_val_sym = malloc(sizeof(Symbol));
-            if (node->tipo == NODE_INT) {
-                literal_val_sym->valor.value = node->sym->valor.value;
-            } else {
-                literal_val_sym->valor.value = (node->tipo == NODE_TRUE) ? 1 : 0;
-            }
-            literal_val_sym->name = NULL;
-            literal_val_sym->is_param = 0; // Importante: Limpiar este flag
-            // 3. Emitir una instrucción para ALMACENAR el valor literal en el temporal.
-            //    Esta es la clave: le decimos al generador que mueva el número a la pila.
-            
-            ir_emit(list, IR_STORAGE, literal_val_sym, NULL, temp_sym);
-
-            // 4. Devolver el símbolo temporal, que ahora contiene el valor.
-            return temp_sym;
-        }
-
-        case NODE_ID: {
-            Symbol *t = newTempSymbol();
-            ir_emit(list, IR_LOAD, node->sym, NULL, t);
-            return t;
-        }
-
-        case NODE_SUM: {
-            Symbol *l = gen_code(node->left, list);
-            Symbol *r = gen_code(node->right, list);
-            Symbol *t = newTempSymbol();
-            ir_emit(list, IR_ADD, l, r, t);
-            return t;
-        }
-
-        case NODE_RES: {
-            Symbol *l = gen_code(node->left, list);
-            Symbol *r = gen_code(node->right, list);
-            Symbol *t = newTempSymbol();
-            ir_emit(list, IR_SUB, l, r, t);
-            return t;
-        }
-
-        case NODE_DIV: {
-            Symbol *l = gen_code(node->left, list);
-            Symbol *r = gen_code(node->right, list);
-            Symbol *t = newTempSymbol();
-            ir_emit(list, IR_DIV, l, r, t);
-            return t;
-        }
-
-        case NODE_MUL: {
-            Symbol *l = gen_code(node->left, list);
-            Symbol *r = gen_code(node->right, list);
-            Symbol *t = newTempSymbol();
-            ir_emit(list, IR_MUL, l, r, t);
-            return t;
-        }
-
-        case NODE_MOD: {
-            Symbol *l = gen_code(node->left, list);
-            Symbol *r = gen_code(node->right, list);
-            Symbol *t = newTempSymbol();
-            ir_emit(list, IR_MOD, l, r, t);
-            return t;
-        }
-
-        case NODE_NOT: {
-            Symbol *l = gen_code(node->left, list);
-            Symbol *t = newTempSymbol();
-            ir_emit(list, IR_NOT, l, NULL, t);
-            return t;
-        }
-
-        case NODE_AND: {
-            Symbol *l = gen_code(node->left, list);
-            Symbol *r = gen_code(node->right, list);
-            Symbol *t = newTempSymbol();
-            ir_emit(list, IR_AND, l, r, t);
-            return t;
-
-        }
-
-        case NODE_OR: {
-            Symbol *l = gen_code(node->left, list);
-            Symbol *r = gen_code(node->right, list);
-            Symbol *t = newTempSymbol();
-            ir_emit(list, IR_OR, l, r, t);
-            return t;
-        }
-
-        case NODE_EQ: {
-            Symbol *l = gen_code(node->left, list);
-            Symbol *r = gen_code(node->right, list);
-            Symbol *t = newTempSymbol();
-            ir_emit(list, IR_EQ, l, r, t);
-            return t;
-        }
-
-        case NODE_NEQ: {
-            Symbol *l = gen_code(node->left, list);
-            Symbol *r = gen_code(node->right, list);
-            Symbol *t = newTempSymbol();
-            ir_emit(list, IR_NEQ, l, r, t);
-            return t;
-        }
-
-        case NODE_LT: {
-            Symbol *l = gen_code(node->left, list);
-            Symbol *r = gen_code(node->right, list);
-            Symbol *t = newTempSymbol();
-            ir_emit(list, IR_LT, l, r, t);
-            return t;
-        }
-
-        case NODE_GT: {
-            Symbol *l = gen_code(node->left, list);
-            Symbol *r = gen_code(node->right, list);
-            Symbol *t = newTempSymbol();
-            ir_emit(list, IR_GT, l, r, t);
-            return t;
-        }
-
-        case NODE_LE: {
-            Symbol *l = gen_code(node->left, list);
-            Symbol *r = gen_code(node->right, list);
-            Symbol *t = newTempSymbol();
-            ir_emit(list, IR_LE, l, r, t);
-            return t;
-        }
-
-        case NODE_GE: {
-            Symbol *l = gen_code(node->left, list);
-            Symbol *r = gen_code(node->right, list);
-            Symbol *t = newTempSymbol();
-            ir_emit(list, IR_GE, l, r, t);
-            return t;
-        }
-
-
-        case NODE_UMINUS: {
-            Symbol *val = gen_code(node->left, list);
-            Symbol *t = newTempSymbol();
-            ir_emit(list, IR_UMINUS, val, NULL, t);
-            return t;
-        }
-
-        case NODE_DECLARATION: {
-            // node->sym es la variable que se declara
-            // node->right es el inicializador (ej. '100' o 'a+b' o NULL)
-
-            if (!node->right)
-            {
-                // Caso: Sin inicialización
-                
-                // Emitir IR_DECL con valor NULL.
-                // 'collect_globals' lo verá y 'print_globals_data'
-                // lo interpretará como '.quad 0'.
-                ir_emit(list, IR_DECL, NULL, NULL, node->sym);
-            }
-            else
-            {
-                // Caso: Con inicialización
-                // Comprobar si es una inicialización constante
-                bool is_static_const = (node->right->tipo == NODE_INT ||
-                                        node->right->tipo == NODE_TRUE ||
-                                        node->right->tipo == NODE_FALSE);
-
-                // Comprobar si la variable es global
-                bool is_global = node->sym->is_global;
-
-                if (is_global && is_static_const)
-                {
-                    // Inicialización Estática Global
-
-                    // Crear un Símbolo Constante para el valor.
-                    Symbol *const_val = malloc(sizeof(Symbol));
-                    if (!const_val) {
-                        fprintf(stderr, "Error de memoria en DECL\n");
-                        break;
-                    }
-
-                    const_val->name = NULL; // Es un literal, no tiene nombre
-                    const_val->type = (node->right->tipo == NODE_INT) ? TYPE_INT : TYPE_BOOL;
-                    const_val->is_param = 0;
-
-                    if (node->right->tipo == NODE_INT)
-                    {
-                        const_val->valor.value = node->right->sym->valor.value;
-                    }
-                    else if (node->right->tipo == NODE_TRUE)
-                    {
-                        const_val->valor.value = 1;
-                    }
-                    else
-                    { // NODE_FALSE
-                        const_val->valor.value = 0;
-                    }
-
-                    // Emitir IR_DECL con el valor constante (en arg1).
-                    //    'collect_globals' usará 'const_val'
-                    ir_emit(list, IR_DECL, const_val, NULL, node->sym);
-                }
-                else
-                {
-                    // Inicialización Dinámica o Local
-
-                    // Si es una variable global dinámica (ej. g = a+b),
-                    //    primero debemos declararla en .data con 0.
-                    if (is_global)
-                    {
-                        // 'collect_globals' lo pondrá en .data como '.quad 0'
-                        ir_emit(list, IR_DECL, NULL, NULL, node->sym);
-                    }
-
-                    // Generar el código para la expresión
-                    Symbol *rhs = gen_code(node->right, list);
-
-                    // Emitir un IR_STORE para asignar el valor.
-                    ir_emit(list, IR_STORE, rhs, NULL, node->sym);
-                }
-            }
-            break;
-        }
-
-        case NODE_ASSIGN: {
-            Symbol *l = gen_code(node->left, list);
-            Symbol *r = gen_code(node->right, list);
-            ir_emit(list, IR_STORE, l, r, node->sym);
-            return node->sym;
-        }
-
-        case NODE_METHOD_CALL: {
-
-
-            // El AST parece ser: node->right (NODE_ARGS) -> left (NODE_LIST)
-            Tree *args_node = node->right;
-            Tree *arg_list = (args_node && args_node->left) ? args_node->left : NULL;
-
-            // 1. Generar código para todos los argumentos.
-            //    Esta función los evaluará de DERECHA a IZQUIERDA
-            //    y emitirá las instrucciones IR_PARAM en ese orden.
-            gen_method_args(arg_list, list, 0); // Empezar con índice 0
-
-            // Crea un temporal para el valor de retorno de la función
-            Symbol *t = newTempSymbol();
-
-            // Emitir la llamada a la función
-            ir_emit(list, IR_CALL, node->sym, NULL, t);
-
-            // Devolver el temporal que contendrá el resultado
-            return t;
-        }
-
-        case NODE_PROGRAM:
-        case NODE_CODE:
-        case NODE_BLOCK:
-        case NODE_LIST:
-        case NODE_ARGS: {
-            gen_code(node->left, list);
-            gen_code(node->right, list);
-            break;
-        }
-
-        case NODE_METHOD: {
-
-
-            // ES UN METODO EXTERNO
-            if (node->right == NULL) {
-                ir_emit(list, IR_METH_EXT, NULL, NULL, node->sym);
-            } else {
-                // Etiqueta para inicio del método
-                if (node->sym) {
-                    ir_emit(list, IR_METHOD, NULL, NULL, node->sym);
-                }
-
-                Tree *method_decl = node->left;                             // NODE_METHOD_HEADER
-                Tree *args_node = method_decl ? method_decl->right : NULL;  // ARGS
-                Tree *param_list = (args_node && args_node->left) ? args_node->left : NULL;  // Primer LIST
-                
-                while (param_list) {
-                    Tree *param_decl = param_list->left;
-                    if (param_decl && param_decl->sym) {
-                        Symbol *param_sym = param_decl->sym;
-                        
-                        // Solo necesitamos guardar los que vienen por registro (0-5)
-                        if (param_sym->is_param && param_sym->param_index < 6) {
-                            // Usamos arg1 para pasar el símbolo del parámetro
-                            ir_emit(list, IR_SAVE_PARAM, param_sym, NULL, NULL); 
-                        }
-                    }
-                    param_list = param_list->right; // Siguiente parámetro
-                }
-
-                // Cuerpo del método
-                gen_code(node->right, list);
-                ir_emit(list, IR_FMETHOD, NULL, NULL, node->sym);
-            }
-            break;
-        }
-
-        case NODE_IF: {
-            Symbol *cond = gen_code(node->left, list); // condición
-            Symbol *label_end = newLabel();
-            //GOTO SALTA SI ES FALSO, SINO CONTINUA LA EJECUCION SECUENCIAL//
-            ir_emit(list, IR_GOTO, cond, NULL, label_end);
-            gen_code(node->right, list); // cuerpo del if
-            ir_emit(list, IR_LABEL, NULL, NULL, label_end);
-            break;
-        }
-
-        case NODE_IF_ELSE: {
-            Symbol *cond = gen_code(node->left, list); // condición
-            Symbol *label_else = newLabel();
-            Symbol *label_end = newLabel();
-            ir_emit(list, IR_GOTO, cond, NULL, label_else);
-            gen_code(node->right->left, list); // cuerpo del if (then)
-            ir_emit(list, IR_GOTO, NULL, NULL, label_end);
-            ir_emit(list, IR_LABEL, NULL, NULL, label_else);
-            gen_code(node->right->right, list); // cuerpo del else
-            ir_emit(list, IR_LABEL, NULL, NULL, label_end);
-            break;
-        }
-
-        case NODE_RETURN: {
-            // no es un return void
-            if (node->left != NULL){
-                Symbol *l = gen_code(node->left, list);
-                ir_emit(list, IR_RETURN, l, NULL, NULL);
-                return NULL;
-            }
-            ir_emit(list, IR_RETURN, NULL, NULL, NULL);
-            break;
-        }
-
-        case NODE_WHILE: {
-            Symbol *label_start = newLabel();
-            Symbol *label_end = newLabel();
-            ir_emit(list, IR_LABEL, NULL, NULL, label_start);
-            Symbol *cond = gen_code(node->left, list);
-            ir_emit(list, IR_GOTO, cond, NULL, label_end);
-            gen_code(node->right, list);
-            ir_emit(list, IR_GOTO, NULL, NULL, label_start);
-            ir_emit(list, IR_LABEL, NULL, NULL, label_end);
-            break;
-        }
-
-        case NODE_PARENS: return gen_code(node->left, list);
-
-
-        case NODE_METHOD_HEADER: break;
-
-        default:
-            // Para depuración: nodo no manejado
-            fprintf(stderr, "Nodo no soportado en gen_code: %d\n", node->tipo);
-            break;
-
-        
-    }
-    return NULL;
-}
-
-
-
-void ir_init(IRList *list) {
-    list->codes = NULL;
-    list->size = 0;
-    list->capacity = 0;
-}
-
-
-
-void ir_emit(IRList *list, IRInstr op, Symbol *arg1, Symbol *arg2, Symbol *result) {
-    // redimensionar si no hay lugar
-    if (list->size >= list->capacity) {
-        list->capacity = (list->capacity == 0) ? 4 : list->capacity * 2;
-        list->codes = realloc(list->codes, list->capacity * sizeof(IRCode));
-    }
-
-    // agregar nueva instrucción
-    IRCode *code = &list->codes[list->size++];
-    code->op = op;
-    code->arg1 = arg1;
-    code->arg2 = arg2;
-    code->result = result;
-}
-
-
-
-void ir_print(IRList *list) {
-    for (int i = 0; i < list->size; i++) {
-        IRCode *code = &list->codes[i];
-        if (strcmp(ir_names[code->op], "METH_EXT") == 0)
-        {
-            printf("EXTERN");    
-        } else {
-            printf("%s", ir_names[code->op]);
-        }
-
-        switch (code->op){
-            
-            case IR_ADD:
-            case IR_SUB:
-            case IR_MUL:
-            case IR_DIV:
-            case IR_MOD:
-            case IR_AND:
-            case IR_OR:
-            case IR_EQ:
-            case IR_NEQ:
-            case IR_LT:
-            case IR_LE:
-            case IR_GT:
-            case IR_GE:
-                if (code->arg1) {
-                    if (code->arg1->name)
-                        printf(" %s", code->arg1->name);
-                    else
-                        printf(" %d", code->arg1->valor.value);
-                }
-                if (code->arg2) {
-                    if (code->arg2->name)
-                        printf(", %s", code->arg2->name);
-                    else
-                        printf(", %d", code->arg2->valor.value);
-                }
-                if (code->result) {
-                    if (code->result->name)
-                        printf(", %s", code->result->name);
-                    else
-                        printf(", %d", code->result->valor.value);
-                }
-                break;
-            case IR_STORE:
-            case IR_STORAGE:
-            case IR_SAVE_PARAM:
-            case IR_LOAD:
-            case IR_CALL:
-            case IR_NOT:
-            case IR_UMINUS:
-            case IR_GOTO:
-                if (code->arg1) {
-                    if (code->arg1->name)
-                        printf(" %s", code->arg1->name);
-                    else
-                        printf(" %d", code->arg1->valor.value);
-                }
-                if (code->arg2) {
-                    if (code->arg2->name)
-                        printf(", %s", code->arg2->name);
-                    else
-                        printf(", %d", code->arg2->valor.value);
-                }
-                if (code->result) {
-                    if (code->result->name)
-                        printf(", %s", code->result->name);
-                    else
-                        printf(", %d", code->result->valor.value);
-                }
-                break;
-            case IR_LABEL:
-            case IR_METH_EXT:
-            case IR_DECL:
-                printf(" %s", code->result->name);
-                break;
-
-            case IR_METHOD:
-            case IR_FMETHOD:
-                printf(": %s", code->result->name);
-                break;
-
-            case IR_RETURN:
-                if (code->arg1) {
-                    printf(" %s", code->arg1->name);
-                }
-                break;
-            
-            case IR_PARAM:
-            case IR_PRINT:
-
-
-                /* code */
-                break;
-            
-            default:
-                printf("CASO DEFAULT");
-                break;
-        }
-        printf("\n");
-    }
-}
-
-void ir_free(IRList *list) {
-    free(list->codes);
-    list->codes = NULL;
-    list->size = 0;
-    list->capacity = 0;
-}
-
-void offset_temps(IRList *list) {
-    int temp_offset = 0;            // Offset para temporales (negativo)
-    Symbol *current_method = NULL;
-
-    for (int i = 0; i < list->size; i++) {
-        IRCode *code = &list->codes[i];
-
-        if (code->op == IR_METHOD) {
-            // Entramos a un método
-            current_method = code->result;
-            if (current_method) {
-                // Empieza el offset de temporales justo después de los locals
-                temp_offset = (-current_method->total_stack_space) - 8;
-            }
-            continue;
-        }
-
-        if (code->op == IR_FMETHOD) {
-            // Guardar total de stack incluyendo temporales
-            if (current_method)
-                current_method->total_stack_space = -temp_offset - 8;
-            current_method = NULL;
-            continue;
-        }
-
-        // Asignar offset a los temporales dentro del método
-        if (current_method && code->result && code->result->is_temp && code->result->offset == 0) {
-            code->result->offset = temp_offset;
-            temp_offset -= 8;
-        }
-    }
-}
+#include <string.h>
+#include "Tree.h"
+#include "Intermediate.h"
+#include "Liveness.h"
+
+
+
+// DEBE COINCIDIR EN POSICION CON EL ENUM IRInstr
+static const char *ir_names[] = {
+    "LOAD","DECL", "STORE","STORAGE", "ADD","SUB", "UMINUS", "MUL","DIV","MOD",
+    "AND","OR","NOT",
+    "EQ","NEQ","LT","LE","GT","GE",
+    "LABEL","GOTO", "RET", "PARAM", "CALL", "METHOD", "F_METHOD", "METH_EXT",
+    "PRINT", "SAVE_PARAM",
+    "JEQ", "JNE", "JLT", "JLE", "JGT", "JGE", "NOP"
+};
+
+IROperand newTemp(CompilerContext *ctx) {
+    return (IROperand){ .kind = IRO_TEMP, .id = ctx->temp_count++ };
+}
+
+IROperand newLabel(CompilerContext *ctx) {
+    // Las que crean los pases dentro de una unidad (Units.h) llevan su número
+    return (IROperand){ .kind = IRO_LABEL, .unit = ctx->unit, .id = ctx->label_count++ };
+}
+
+// =============================
+// Variables y métodos
+// =============================
+
+static IRSymbols *symbols_of(CompilerContext *ctx, IROperandKind kind) {
+    switch (kind) {
+        case IRO_LOCAL:  return &ctx->ir_locals;
+        case IRO_GLOBAL: return &ctx->ir_globals;
+        case IRO_METHOD: return &ctx->ir_methods;
+        default:         return NULL;
+    }
+}
+
+/* Los símbolos que declara el scope no guardan si son métodos: lo dice quien pide el operando */
+static IROperand operand_of(CompilerContext *ctx, Symbol *sym, IROperandKind kind) {
+    if (sym->ir_id == 0) {
+        IRSymbols *table = symbols_of(ctx, kind);
+        if (table->count == table->capacity) {
+            table->capacity = table->capacity ? table->capacity * 2 : 64;
+            table->items = realloc(table->items, table->capacity * sizeof(Symbol *));
+        }
+        table->items[table->count++] = sym;
+        sym->ir_id = table->count;
+    }
+    return (IROperand){ .kind = kind, .id = sym->ir_id - 1 };
+}
+
+IROperand ir_symbol_operand(CompilerContext *ctx, Symbol *sym) {
+    return operand_of(ctx, sym, sym->is_global ? IRO_GLOBAL : IRO_LOCAL);
+}
+
+IROperand ir_method_operand(CompilerContext *ctx, Symbol *sym) {
+    return operand_of(ctx, sym, IRO_METHOD);
+}
+
+Symbol *ir_symbol(CompilerContext *ctx, IROperand v) {
+    IRSymbols *table = symbols_of(ctx, v.kind);
+    return table ? table->items[v.id] : NULL;
+}
+
+const char *ir_name(CompilerContext *ctx, IROperand v, char *buf, size_t size) {
+    switch (v.kind) {
+        case IRO_TEMP:
+            snprintf(buf, size, "t%d", v.id);
+            return buf;
+        case IRO_IMM:
+            snprintf(buf, size, "%d", v.id);
+            return buf;
+        case IRO_LABEL:
+            if (v.unit > 0) snprintf(buf, size, "L%d_%u", v.id, (unsigned)v.unit);
+            else snprintf(buf, size, "L%d", v.id);
+            return buf;
+        case IRO_NONE:
+            return "";
+        default:
+            return ir_symbol(ctx, v)->name;
+    }
+}
+
+// =============================
+// Tablas de la unidad
+// =============================
+
+static IRValueTable *table_of(CompilerContext *ctx, IROperand v) {
+    if (v.kind == IRO_TEMP) return &ctx->temps;
+    if (v.kind == IRO_LOCAL) return &ctx->locals;
+    return NULL;
+}
+
+IRValueInfo *ir_value_find(CompilerContext *ctx, IROperand v) {
+    IRValueTable *t = table_of(ctx, v);
+    if (!t) return NULL;
+    int k = v.id - t->base;
+    return k >= 0 && k < t->size ? &t->items[k] : NULL;
+}
+
+IRValueInfo *ir_value_info(CompilerContext *ctx, IROperand v) {
+    IRValueTable *t = table_of(ctx, v);
+    if (!t) return NULL;
+    if (t->size == 0) t->base = v.id;
+
+    // La tabla arranca en el primer id que se pidió; si aparece uno menor se corre
+    if (v.id < t->base) {
+        int shift = t->base - v.id;
+        t->items = realloc(t->items, (t->size + shift) * sizeof(IRValueInfo));
+        memmove(t->items + shift, t->items, t->size * sizeof(IRValueInfo));
+        memset(t->items, 0, shift * sizeof(IRValueInfo));
+        t->base = v.id;
+        t->size += shift;
+    }
+    int k = v.id - t->base;
+    if (k >= t->size) {
+        int size = t->size * 2 > k + 1 ? t->size * 2 : k + 1;
+        t->items = realloc(t->items, size * sizeof(IRValueInfo));
+        memset(t->items + t->size, 0, (size - t->size) * sizeof(IRValueInfo));
+        t->size = size;
+    }
+    return &t->items[k];
+}
+
+const char *ir_value_reg(CompilerContext *ctx, IROperand v) {
+    IRValueInfo *info = ir_value_find(ctx, v);
+    return info ? info->reg : NULL;
+}
+
+// =============================
+// Rangos de valores
+// =============================
+
+static void widen(int *base, int *count, int id) {
+    if (*count == 0) {
+        *base = id;
+        *count = 1;
+    } else if (id < *base) {
+        *count += *base - id;
+        *base = id;
+    } else if (id >= *base + *count) {
+        *count = id - *base + 1;
+    }
+}
+
+static void range_add(IRValueRange *r, IROperand v) {
+    if (v.kind == IRO_TEMP) widen(&r->temp_base, &r->temps, v.id);
+    else if (v.kind == IRO_LOCAL) widen(&r->local_base, &r->locals, v.id);
+}
+
+void ir_value_range(IRList *list, int start, int end, IRValueRange *range) {
+    *range = (IRValueRange){ 0 };
+    for (int i = start; i <= end && i < list->size; i++) {
+        IRCode *code = &list->codes[i];
+        range_add(range, code->arg1);
+        range_add(range, code->arg2);
+        range_add(range, code->result);
+    }
+}
+
+
+/**
+ * @brief Genera el código para los argumentos de un método en orden inverso (R->L)
+ * y emite las instrucciones IR_PARAM con el índice correcto (L->R).
+ * * @param ctx Contexto de la compilación (numera los temporales).
+ * @param arg_list_node El nodo 'NODE_LIST' que empieza la lista de argumentos.
+ * @param list La lista de IR.
+ * @param current_index El índice del parámetro actual (empezando en 0 para el de más a la izquierda).
+ */
+static void gen_method_args(CompilerContext *ctx, Tree *arg_list_node, IRList *list, int current_index) {
+    if (!arg_list_node) {
+        return; // Fin de la lista de argumentos
+    }
+
+    // IR AL FONDO DE LA LISTA PRIMERO (DERECHA a IZQUIERDA)
+    gen_method_args(ctx, arg_list_node->right, list, current_index + 1);
+
+    // PROCESAR EL NODO ACTUAL (IZQUIERDA)
+    // Evalúa los argumentos de derecha a izquierda.
+    IROperand arg_value_temp = gen_code(ctx, arg_list_node->left, list);
+
+    // Emitir la instrucción IR_PARAM (el índice va como inmediato)
+    ir_emit(list, IR_PARAM, arg_value_temp, ir_imm(current_index), ir_none());
+}
+
+
+/* Carga un literal entero en dst */
+static void emit_literal(IRList *list, int value, IROperand dst) {
+    ir_emit(list, IR_STORAGE, ir_imm(value), ir_none(), dst);
+}
+
+/* Comparación del AST -> salto que se toma cuando la comparación es verdadera (o falsa) */
+static IRInstr compare_jump(typeTree tipo, bool when) {
+    static const IRInstr taken[]   = { IR_JEQ, IR_JNE, IR_JLT, IR_JGT, IR_JLE, IR_JGE };
+    static const IRInstr inverse[] = { IR_JNE, IR_JEQ, IR_JGE, IR_JLE, IR_JGT, IR_JLT };
+    int k;
+    switch (tipo) {
+        case NODE_EQ:  k = 0; break;
+        case NODE_NEQ: k = 1; break;
+        case NODE_LT:  k = 2; break;
+        case NODE_GT:  k = 3; break;
+        case NODE_LE:  k = 4; break;
+        case NODE_GE:  k = 5; break;
+        default: return IR_NOP;
+    }
+    return when ? taken[k] : inverse[k];
+}
+
+/**
+ * Código de salto para una condición (evaluación en cortocircuito):
+ * salta a 'target' cuando la condición vale 'when' y si no sigue de largo.
+ * El operando derecho de && y || solo se evalúa si hace falta, y las
+ * comparaciones saltan directamente sin materializar el booleano.
+ */
+static void gen_jump(CompilerContext *ctx, Tree *node, IRList *list, IROperand target, bool when) {
+    switch (node->tipo) {
+        case NODE_PARENS:
+            gen_jump(ctx, node->left, list, target, when);
+            return;
+
+        case NODE_NOT:
+            gen_jump(ctx, node->left, list, target, !when);
+            return;
+
+        case NODE_AND:
+        case NODE_OR: {
+            // && corta con el izquierdo falso, || con el izquierdo verdadero
+            bool shortcut = node->tipo == NODE_OR;
+            if (when == shortcut) {
+                gen_jump(ctx, node->left, list, target, when);
+                gen_jump(ctx, node->right, list, target, when);
+            } else {
+                IROperand skip = newLabel(ctx);
+                gen_jump(ctx, node->left, list, skip, shortcut);
+                gen_jump(ctx, node->right, list, target, when);
+                ir_emit(list, IR_LABEL, ir_none(), ir_none(), skip);
+            }
+            return;
+        }
+
+        case NODE_EQ: case NODE_NEQ: case NODE_LT: case NODE_GT: case NODE_LE: case NODE_GE: {
+            IROperand l = gen_code(ctx, node->left, list);
+            IROperand r = gen_code(ctx, node->right, list);
+            ir_emit(list, compare_jump(node->tipo, when), l, r, target);
+            return;
+        }
+
+        default: {
+            // GOTO condicional: salta si el valor no es 1
+            IROperand cond = gen_code(ctx, node, list);
+            if (when) {
+                IROperand t = newTemp(ctx);
+                ir_emit(list, IR_NOT, cond, ir_none(), t);
+                cond = t;
+            }
+            ir_emit(list, IR_GOTO, cond, ir_none(), target);
+            return;
+        }
+    }
+}
+
+/* && y || como valor: t = 0; si la condición es falsa salta; t = 1 */
+static IROperand gen_logical_value(CompilerContext *ctx, Tree *node, IRList *list) {
+    IROperand t = newTemp(ctx);
+    IROperand label_end = newLabel(ctx);
+    emit_literal(list, 0, t);
+    gen_jump(ctx, node, list, label_end, false);
+    emit_literal(list, 1, t);
+    ir_emit(list, IR_LABEL, ir_none(), ir_none(), label_end);
+    return t;
+}
+
+IROperand gen_code(CompilerContext *ctx, Tree *node, IRList *list) {
+    if (!node) return ir_none();
+
+    if (node->sym == NULL && 
+        (node->tipo == NODE_ID || node->tipo == NODE_ASSIGN || node->tipo == NODE_METHOD_CALL)) {
+        fprintf(ctx->err, "Error: nodo tipo %d sin símbolo\n", node->tipo);
+        return ir_none();
+    }
+
+    
+    switch (node->tipo) {
+        case NODE_T_INT:
+        case NODE_T_BOOL:
+        case NODE_T_VOID:
+            return ir_none();
+
+        case NODE_INT:
+        case NODE_TRUE:
+        case NODE_FALSE: {
+
+            
+            
+
+            // 1. Crear un nuevo temporal para guardar el valor del literal.
+            IROperand temp_sym = newTemp(ctx);
+
+            // 2. El valor del literal va inline en la instrucción.
+            int value;
+            if (node->tipo == NODE_INT) {
+                value = node->sym->valor.value;
+            } else {
+                value = (node->tipo == NODE_TRUE) ? 1 : 0;
+            }
+            // 3. Emitir una instrucción para ALMACENAR el valor literal en el temporal.
+            //    Esta es la clave: le decimos al generador que mueva el número a la pila.
+            
+            ir_emit(list, IR_STORAGE, ir_imm(value), ir_none(), temp_sym);
+
+            // 4. Devolver el temporal, que ahora contiene el valor.
+            return temp_sym;
+        }
+
+        case NODE_ID: {
+            IROperand t = newTemp(ctx);
+            ir_emit(list, IR_LOAD, ir_symbol_operand(ctx, node->sym), ir_none(), t);
+            return t;
+        }
+
+        case NODE_SUM: {
+            IROperand l = gen_code(ctx, node->left, list);
+            IROperand r = gen_code(ctx, node->right, list);
+            IROperand t = newTemp(ctx);
+            ir_emit(list, IR_ADD, l, r, t);
+            return t;
+        }
+
+        case NODE_RES: {
+            IROperand l = gen_code(ctx, node->left, list);
+            IROperand r = gen_code(ctx, node->right, list);
+            IROperand t = newTemp(ctx);
+            ir_emit(list, IR_SUB, l, r, t);
+            return t;
+        }
+
+        case NODE_DIV: {
+            IROperand l = gen_code(ctx, node->left, list);
+            IROperand r = gen_code(ctx, node->right, list);
+            IROperand t = newTemp(ctx);
+            ir_emit(list, IR_DIV, l, r, t);
+            return t;
+        }
+
+        case NODE_MUL: {
+            IROperand l = gen_code(ctx, node->left, list);
+            IROperand r = gen_code(ctx, node->right, list);
+            IROperand t = newTemp(ctx);
+            ir_emit(list, IR_MUL, l, r, t);
+            return t;
+        }
+
+        case NODE_MOD: {
+            IROperand l = gen_code(ctx, node->left, list);
+            IROperand r = gen_code(ctx, node->right, list);
+            IROperand t = newTemp(ctx);
+            ir_emit(list, IR_MOD, l, r, t);
+            return t;
+        }
+
+        case NODE_NOT: {
+            IROperand l = gen_code(ctx, node->left, list);
+            IROperand t = newTemp(ctx);
+            ir_emit(list, IR_NOT, l, ir_none(), t);
+            return t;
+        }
+
+        case NODE_AND:
+        case NODE_OR:
+            return gen_logical_value(ctx, node, list);
+
+        case NODE_EQ: {
+            IROperand l = gen_code(ctx, node->left, list);
+            IROperand r = gen_code(ctx, node->right, list);
+            IROperand t = newTemp(ctx);
+            ir_emit(list, IR_EQ, l, r, t);
+            return t;
+        }
+
+        case NODE_NEQ: {
+            IROperand l = gen_code(ctx, node->left, list);
+            IROperand r = gen_code(ctx, node->right, list);
+            IROperand t = newTemp(ctx);
+            ir_emit(list, IR_NEQ, l, r, t);
+            return t;
+        }
+
+        case NODE_LT: {
+            IROperand l = gen_code(ctx, node->left, list);
+            IROperand r = gen_code(ctx, node->right, list);
+            IROperand t = newTemp(ctx);
+            ir_emit(list, IR_LT, l, r, t);
+            return t;
+        }
+
+        case NODE_GT: {
+            IROperand l = gen_code(ctx, node->left, list);
+            IROperand r = gen_code(ctx, node->right, list);
+            IROperand t = newTemp(ctx);
+            ir_emit(list, IR_GT, l, r, t);
+            return t;
+        }
+
+        case NODE_LE: {
+            IROperand l = gen_code(ctx, node->left, list);
+            IROperand r = gen_code(ctx, node->right, list);
+            IROperand t = newTemp(ctx);
+            ir_emit(list, IR_LE, l, r, t);
+            return t;
+        }
+
+        case NODE_GE: {
+            IROperand l = gen_code(ctx, node->left, list);
+            IROperand r = gen_code(ctx, node->right, list);
+            IROperand t = newTemp(ctx);
+            ir_emit(list, IR_GE, l, r, t);
+            return t;
+        }
+
+
+        case NODE_UMINUS: {
+            IROperand val = gen_code(ctx, node->left, list);
+            IROperand t = newTemp(ctx);
+            ir_emit(list, IR_UMINUS, val, ir_none(), t);
+            return t;
+        }
+
+        case NODE_DECLARATION: {
+            // node->sym es la variable que se declara
+            // node->right es el inicializador (ej. '100' o 'a+b' o NULL)
+
+            if (!node->right)
+            {
+                // Caso: Sin inicialización
+                
+                // Emitir IR_DECL con valor 0.
+                // 'collect_globals' lo verá y 'print_globals_data'
+                // lo interpretará como '.quad 0'.
+                ir_emit(list, IR_DECL, ir_none(), ir_none(), ir_symbol_operand(ctx, node->sym));
+            }
+            else
+            {
+                // Caso: Con inicialización
+                // Comprobar si es una inicialización constante
+                bool is_static_const = (node->right->tipo == NODE_INT ||
+                                        node->right->tipo == NODE_TRUE ||
+                                        node->right->tipo == NODE_FALSE);
+
+                // Comprobar si la variable es global
+                bool is_global = node->sym->is_global;
+
+                if (is_global && is_static_const)
+                {
+                    // Inicialización Estática Global
+
+                    int value;
+                    if (node->right->tipo == NODE_INT)
+                    {
+                        value = node->right->sym->valor.value;
+                    }
+                    else if (node->right->tipo == NODE_TRUE)
+                    {
+                        value = 1;
+                    }
+                    else
+                    { // NODE_FALSE
+                        value = 0;
+                    }
+
+                    // Emitir IR_DECL con el valor constante como inmediato.
+                    //    'collect_globals' lo usará como valor inicial
+                    ir_emit(list, IR_DECL, ir_imm(value), ir_none(), ir_symbol_operand(ctx, node->sym));
+                }
+                else
+                {
+                    // Inicialización Dinámica o Local
+
+                    // Si es una variable global dinámica (ej. g = a+b),
+                    //    primero debemos declararla en .data con 0.
+                    if (is_global)
+                    {
+                        // 'collect_globals' lo pondrá en .data como '.quad 0'
+                        ir_emit(list, IR_DECL, ir_none(), ir_none(), ir_symbol_operand(ctx, node->sym));
+                    }
+
+                    // Generar el código para la expresión
+                    IROperand rhs = gen_code(ctx, node->right, list);
+
+                    // Emitir un IR_STORE para asignar el valor.
+                    ir_emit(list, IR_STORE, rhs, ir_none(), ir_symbol_operand(ctx, node->sym));
+                }
+            }
+            break;
+        }
+
+        case NODE_ASSIGN: {
+            IROperand l = gen_code(ctx, node->left, list);
+            IROperand r = gen_code(ctx, node->right, list);
+            IROperand var = ir_symbol_operand(ctx, node->sym);
+            ir_emit(list, IR_STORE, l, r, var);
+            return var;
+        }
+
+        case NODE_METHOD_CALL: {
+
+
+            // El AST parece ser: node->right (NODE_ARGS) -> left (NODE_LIST)
+            Tree *args_node = node->right;
+            Tree *arg_list = (args_node && args_node->left) ? args_node->left : NULL;
+
+            // 1. Generar código para todos los argumentos.
+            //    Esta función los evaluará de DERECHA a IZQUIERDA
+            //    y emitirá las instrucciones IR_PARAM en ese orden.
+            gen_method_args(ctx, arg_list, list, 0); // Empezar con índice 0
+
+            // Crea un temporal para el valor de retorno de la función
+            IROperand t = newTemp(ctx);
+
+            // Emitir la llamada a la función
+            ir_emit(list, IR_CALL, ir_method_operand(ctx, node->sym), ir_none(), t);
+
+            // Devolver el temporal que contendrá el resultado
+            return t;
+        }
+
+        case NODE_PROGRAM:
+        case NODE_CODE:
+        case NODE_BLOCK:
+        case NODE_LIST:
+        case NODE_ARGS: {
+            gen_code(ctx, node->left, list);
+            gen_code(ctx, node->right, list);
+            break;
+        }
+
+        case NODE_METHOD: {
+
+
+            // ES UN METODO EXTERNO
+            if (node->right == NULL) {
+                ir_emit(list, IR_METH_EXT, ir_none(), ir_none(), ir_method_operand(ctx, node->sym));
+            } else {
+                // Etiqueta para inicio del método
+                if (node->sym) {
+                    ir_emit(list, IR_METHOD, ir_none(), ir_none(), ir_method_operand(ctx, node->sym));
+                }
+
+                Tree *method_decl = node->left;                             // NODE_METHOD_HEADER
+                Tree *args_node = method_decl ? method_decl->right : NULL;  // ARGS
+                Tree *param_list = (args_node && args_node->left) ? args_node->left : NULL;  // Primer LIST
+                
+                while (param_list) {
+                    Tree *param_decl = param_list->left;
+                    if (param_decl && param_decl->sym) {
+                        Symbol *param_sym = param_decl->sym;
+                        
+                        // Solo necesitamos guardar los que vienen por registro (0-5)
+                        if (param_sym->is_param && param_sym->param_index < 6) {
+                            // Usamos arg1 para pasar el símbolo del parámetro
+                            ir_emit(list, IR_SAVE_PARAM, ir_symbol_operand(ctx, param_sym), ir_none(), ir_none()); 
+                        }
+                    }
+                    param_list = param_list->right; // Siguiente parámetro
+                }
+
+                // Cuerpo del método
+                gen_code(ctx, node->right, list);
+                ir_emit(list, IR_FMETHOD, ir_none(), ir_none(), ir_method_operand(ctx, node->sym));
+            }
+            break;
+        }
+
+        case NODE_IF: {
+            IROperand label_end = newLabel(ctx);
+            //SALTA SI LA CONDICION ES FALSA, SINO CONTINUA LA EJECUCION SECUENCIAL//
+            gen_jump(ctx, node->left, list, label_end, false);
+            gen_code(ctx, node->right, list); // cuerpo del if
+            ir_emit(list, IR_LABEL, ir_none(), ir_none(), label_end);
+            break;
+        }
+
+        case NODE_IF_ELSE: {
+            IROperand label_else = newLabel(ctx);
+            IROperand label_end = newLabel(ctx);
+            gen_jump(ctx, node->left, list, label_else, false); // condición
+            gen_code(ctx, node->right->left, list); // cuerpo del if (then)
+            ir_emit(list, IR_GOTO, ir_none(), ir_none(), label_end);
+            ir_emit(list, IR_LABEL, ir_none(), ir_none(), label_else);
+            gen_code(ctx, node->right->right, list); // cuerpo del else
+            ir_emit(list, IR_LABEL, ir_none(), ir_none(), label_end);
+            break;
+        }
+
+        case NODE_RETURN: {
+            // no es un return void
+            if (node->left != NULL){
+                IROperand l = gen_code(ctx, node->left, list);
+                ir_emit(list, IR_RETURN, l, ir_none(), ir_none());
+                return ir_none();
+            }
+            ir_emit(list, IR_RETURN, ir_none(), ir_none(), ir_none());
+            break;
+        }
+
+        case NODE_WHILE: {
+            IROperand label_start = newLabel(ctx);
+            IROperand label_end = newLabel(ctx);
+            ir_emit(list, IR_LABEL, ir_none(), ir_none(), label_start);
+            gen_jump(ctx, node->left, list, label_end, false);
+            gen_code(ctx, node->right, list);
+            ir_emit(list, IR_GOTO, ir_none(), ir_none(), label_start);
+            ir_emit(list, IR_LABEL, ir_none(), ir_none(), label_end);
+            break;
+        }
+
+        case NODE_PARENS: return gen_code(ctx, node->left, list);
+
+
+        case NODE_METHOD_HEADER: break;
+
+        default:
+            // Para depuración: nodo no manejado
+            fprintf(ctx->err, "Nodo no soportado en gen_code: %d\n", node->tipo);
+            break;
+
+        
+    }
+    return ir_none();
+}
+
+
+
+
+
+
+void ir_init(IRList *list) {
+    list->codes = NULL;
+    list->size = 0;
+    list->capacity = 0;
+}
+
+
+
+void ir_emit(IRList *list, IRInstr op, IROperand arg1, IROperand arg2, IROperand result) {
+    // redimensionar si no hay lugar
+    if (list->size >= list->capacity) {
+        list->capacity = (list->capacity == 0) ? 4 : list->capacity * 2;
+        list->codes = realloc(list->codes, list->capacity * sizeof(IRCode));
+    }
+
+    // agregar nueva instrucción
+    IRCode *code = &list->codes[list->size++];
+    code->op = op;
+    code->arg1 = arg1;
+    code->arg2 = arg2;
+    code->result = result;
+}
+
+void ir_append(IRList *list, IRCode *code) {
+    IRCode copy = *code;    // 'code' puede estar en la misma lista
+    ir_emit(list, copy.op, copy.arg1, copy.arg2, copy.result);
+}
+
+
+/* Un operando, si está, precedido de 'sep' */
+static void print_operand(CompilerContext *ctx, IROperand v, const char *sep) {
+    char buf[32];
+    if (ir_has(v)) printf("%s%s", sep, ir_name(ctx, v, buf, sizeof(buf)));
+}
+
+void ir_print(CompilerContext *ctx, IRList *list) {
+    char buf[32];
+    for (int i = 0; i < list->size; i++) {
+        IRCode *code = &list->codes[i];
+        if (code->op == IR_METH_EXT)
+        {
+            printf("EXTERN");    
+        } else {
+            printf("%s", ir_names[code->op]);
+        }
+
+        switch (code->op){
+            
+            case IR_ADD:
+            case IR_SUB:
+            case IR_MUL:
+            case IR_DIV:
+            case IR_MOD:
+            case IR_AND:
+            case IR_OR:
+            case IR_EQ:
+            case IR_NEQ:
+            case IR_LT:
+            case IR_LE:
+            case IR_GT:
+            case IR_GE:
+            case IR_JEQ:
+            case IR_JNE:
+            case IR_JLT:
+            case IR_JLE:
+            case IR_JGT:
+            case IR_JGE:
+            case IR_STORE:
+            case IR_SAVE_PARAM:
+            case IR_LOAD:
+            case IR_CALL:
+            case IR_NOT:
+            case IR_UMINUS:
+            case IR_GOTO:
+                print_operand(ctx, code->arg1, " ");
+                print_operand(ctx, code->arg2, ", ");
+                print_operand(ctx, code->result, ", ");
+                break;
+            case IR_STORAGE:
+                printf(" %d, %s", code->arg1.id, ir_name(ctx, code->result, buf, sizeof(buf)));
+                break;
+            case IR_LABEL:
+            case IR_METH_EXT:
+            case IR_DECL:
+                printf(" %s", ir_name(ctx, code->result, buf, sizeof(buf)));
+                break;
+
+            case IR_METHOD:
+            case IR_FMETHOD:
+                printf(": %s", ir_name(ctx, code->result, buf, sizeof(buf)));
+                break;
+
+            case IR_RETURN:
+                print_operand(ctx, code->arg1, " ");
+                break;
+            
+            case IR_PARAM:
+            case IR_PRINT:
+            case IR_NOP:
+
+
+                /* code */
+                break;
+            
+            default:
+                printf("CASO DEFAULT");
+                break;
+        }
+        printf("\n");
+    }
+}
+
+void ir_free(IRList *list) {
+    free(list->codes);
+    list->codes = NULL;
+    list->size = 0;
+    list->capacity = 0;
+}
+
+/**
+ * Elimina de la lista las instrucciones marcadas como IR_NOP,
+ * conservando el orden del resto.
+ */
+void ir_compact(IRList *list) {
+    int j = 0;
+    for (int i = 0; i < list->size; i++) {
+        if (list->codes[i].op != IR_NOP)
+            list->codes[j++] = list->codes[i];
+    }
+    list->size = j;
+}
+
+int ir_uses(IRCode *code, IROperand *uses) {
+    int n = 0;
+    switch (code->op) {
+        case IR_ADD: case IR_SUB: case IR_MUL: case IR_DIV: case IR_MOD:
+        case IR_AND: case IR_OR:
+        case IR_EQ: case IR_NEQ: case IR_LT: case IR_LE: case IR_GT: case IR_GE:
+        case IR_JEQ: case IR_JNE: case IR_JLT: case IR_JLE: case IR_JGT: case IR_JGE:
+            uses[n++] = code->arg1;
+            uses[n++] = code->arg2;
+            break;
+        case IR_LOAD:
+        case IR_STORE:
+        case IR_UMINUS:
+        case IR_NOT:
+        case IR_PARAM:
+            uses[n++] = code->arg1;
+            break;
+        case IR_GOTO:
+        case IR_RETURN:
+            if (ir_has(code->arg1)) uses[n++] = code->arg1;
+            break;
+        default:
+            break;
+    }
+    return n;
+}
+
+IROperand ir_def(IRCode *code) {
+    switch (code->op) {
+        case IR_LOAD: case IR_STORE: case IR_STORAGE:
+        case IR_ADD: case IR_SUB: case IR_MUL: case IR_DIV: case IR_MOD:
+        case IR_AND: case IR_OR: case IR_NOT: case IR_UMINUS:
+        case IR_EQ: case IR_NEQ: case IR_LT: case IR_LE: case IR_GT: case IR_GE:
+        case IR_CALL:
+            return code->result;
+        case IR_SAVE_PARAM:
+            return code->arg1;   // el parámetro se define al entrar al método
+        default:
+            return ir_none();
+    }
+}
+
+bool ir_is_jump(IRInstr op) {
+    return op == IR_GOTO || (op >= IR_JEQ && op <= IR_JGE);
+}
+
+bool ir_is_conditional(IRCode *code) {
+    return (code->op == IR_GOTO && ir_has(code->arg1)) || (code->op >= IR_JEQ && code->op <= IR_JGE);
+}
+
+/**
+ * Asigna slots a los temporales del método [start, end] reutilizando los de
+ * temporales cuyos intervalos de vida no se solapan (coloreo greedy de un
+ * grafo de intervalos). Devuelve cuántos slots de 8 bytes hicieron falta.
+ */
+static int share_temp_slots(CompilerContext *ctx, IRList *list, int start, int end, int first_offset) {
+    Liveness *lv = liveness_compute(ctx, list, start, end);
+    LiveInterval *ivs;
+    int n = liveness_intervals(lv, &ivs);
+
+    int *slot_end = malloc((n > 0 ? n : 1) * sizeof(int));   // última instrucción que ocupa cada slot
+    int slots = 0;
+
+    for (int k = 0; k < n; k++) {
+        if (ivs[k].value.kind != IRO_TEMP) continue;
+        IRValueInfo *info = ir_value_info(ctx, ivs[k].value);
+        if (info->reg || info->offset != 0) continue;
+
+        int slot = 0;
+        while (slot < slots && slot_end[slot] >= ivs[k].start) slot++;
+        if (slot == slots) slots++;
+        slot_end[slot] = ivs[k].end;
+        info->offset = first_offset - slot * 8;
+    }
+
+    free(slot_end);
+    free(ivs);
+    liveness_free(lv);
+    return slots;
+}
+
+void offset_temps(CompilerContext *ctx, IRList *list, bool share_slots) {
+    int temp_offset = 0;            // Offset para temporales (negativo)
+    Symbol *current_method = NULL;
+
+    for (int i = 0; i < list->size; i++) {
+        IRCode *code = &list->codes[i];
+
+        if (code->op == IR_METHOD && share_slots) {
+            Symbol *method = ir_symbol(ctx, code->result);
+            int end = ir_method_end(list, i);
+            int slots = share_temp_slots(ctx, list, i, end, -method->total_stack_space - 8);
+            method->total_stack_space += slots * 8;
+            i = end;
+            continue;
+        }
+
+        if (code->op == IR_METHOD) {
+            // Entramos a un método
+            current_method = ir_symbol(ctx, code->result);
+            if (current_method) {
+                // Empieza el offset de temporales justo después de los locals
+                temp_offset = (-current_method->total_stack_space) - 8;
+            }
+            continue;
+        }
+
+        if (code->op == IR_FMETHOD) {
+            // Guardar total de stack incluyendo temporales
+            if (current_method)
+                current_method->total_stack_space = -temp_offset - 8;
+            current_method = NULL;
+            continue;
+        }
+
+        // Asignar offset a los temporales dentro del método (salvo los que quedaron en registro)
+        if (!current_method || code->result.kind != IRO_TEMP) continue;
+        IRValueInfo *info = ir_value_info(ctx, code->result);
+        if (info->offset == 0 && !info->reg) {
+            info->offset = temp_offset;
+            temp_offset -= 8;
+        }
+    }
+}
@@ -0,0 +1,225 @@
+#include "Liveness.h"
+
+static Bitset bitset_new(int words) {
+    return calloc(words > 0 ? words : 1, sizeof(uint64_t));
+}
+
+/* Asigna un id denso al operando si es un valor analizado */
+static void number_value(Liveness *lv, IROperand v) {
+    int k = ir_value_index(&lv->range, v);
+    if (k < 0 || lv->ids[k] >= 0) return;
+    lv->ids[k] = lv->nvalues;
+    lv->values[lv->nvalues++] = v;
+}
+
+int liveness_id(Liveness *lv, IROperand v) {
+    int k = ir_value_index(&lv->range, v);
+    return k < 0 ? -1 : lv->ids[k];
+}
+
+/**
+ * Empareja cada IR_PARAM con el IR_CALL que lo consume. Los argumentos se
+ * evalúan de derecha a izquierda y una llamada anidada emite sus PARAM
+ * después de los de la externa, así que alcanza con una pila.
+ */
+static void match_params(Liveness *lv) {
+    int n = lv->end - lv->start + 1;
+    int *stack = malloc(n * sizeof(int));
+    int top = 0;
+
+    lv->param_next = malloc(n * sizeof(int));
+    lv->call_params = malloc(n * sizeof(int));
+    for (int k = 0; k < n; k++) lv->param_next[k] = lv->call_params[k] = -1;
+
+    for (int i = lv->start; i <= lv->end; i++) {
+        IRCode *code = &lv->list->codes[i];
+        if (code->op == IR_PARAM) {
+            stack[top++] = i;
+        } else if (code->op == IR_CALL) {
+            int count = ir_symbol(lv->ctx, code->arg1)->param_count;
+            int prev = -1;
+            // El último PARAM apilado es el argumento 0: queda primero en la cadena
+            for (int k = 0; k < count && top > 0; k++) {
+                int p = stack[--top];
+                if (prev < 0) lv->call_params[i - lv->start] = p;
+                else lv->param_next[prev - lv->start] = p;
+                prev = p;
+            }
+        }
+    }
+    free(stack);
+}
+
+int liveness_uses(Liveness *lv, int i, IROperand *uses) {
+    IRCode *code = &lv->list->codes[i];
+    if (code->op == IR_PARAM) return 0;
+    if (code->op == IR_CALL) {
+        int n = 0;
+        for (int p = lv->call_params[i - lv->start]; p >= 0; p = lv->param_next[p - lv->start])
+            uses[n++] = lv->list->codes[p].arg1;
+        return n;
+    }
+    return ir_uses(code, uses);
+}
+
+int liveness_max_uses(Liveness *lv) {
+    int max = 2;
+    for (int i = lv->start; i <= lv->end; i++) {
+        IRCode *code = &lv->list->codes[i];
+        if (code->op == IR_CALL && ir_symbol(lv->ctx, code->arg1)->param_count > max)
+            max = ir_symbol(lv->ctx, code->arg1)->param_count;
+    }
+    return max;
+}
+
+Liveness *liveness_compute(CompilerContext *ctx, IRList *list, int start, int end) {
+    Liveness *lv = calloc(1, sizeof(Liveness));
+    lv->ctx = ctx;
+    lv->list = list;
+    lv->start = start;
+    lv->end = end;
+
+    ir_value_range(list, start, end, &lv->range);
+    int count = ir_value_count(&lv->range);
+    lv->ids = malloc((count > 0 ? count : 1) * sizeof(int));
+    lv->values = malloc((count > 0 ? count : 1) * sizeof(IROperand));
+    for (int k = 0; k < count; k++) lv->ids[k] = -1;
+
+    match_params(lv);
+
+    int max_uses = liveness_max_uses(lv);
+    IROperand *uses = malloc(max_uses * sizeof(IROperand));
+
+    for (int i = start; i <= end; i++) {
+        int n = liveness_uses(lv, i, uses);
+        for (int k = 0; k < n; k++) number_value(lv, uses[k]);
+        number_value(lv, ir_def(&list->codes[i]));
+    }
+    lv->words = BITSET_WORDS(lv->nvalues);
+
+    lv->cfg = cfg_build(list, start, end);
+    lv->nblocks = lv->cfg->nblocks;
+    lv->blocks = calloc(lv->nblocks, sizeof(LiveBlock));
+
+    // use/def locales de cada bloque
+    for (int b = 0; b < lv->nblocks; b++) {
+        BasicBlock *bb = &lv->cfg->blocks[b];
+        LiveBlock *block = &lv->blocks[b];
+        block->use = bitset_new(lv->words);
+        block->def = bitset_new(lv->words);
+        block->in = bitset_new(lv->words);
+        block->out = bitset_new(lv->words);
+
+        for (int i = bb->first; i <= bb->last; i++) {
+            int n = liveness_uses(lv, i, uses);
+            for (int k = 0; k < n; k++) {
+                int id = liveness_id(lv, uses[k]);
+                if (id >= 0 && !BITSET_TEST(block->def, id)) BITSET_SET(block->use, id);
+            }
+            int d = liveness_id(lv, ir_def(&list->codes[i]));
+            if (d >= 0) BITSET_SET(block->def, d);
+        }
+    }
+    free(uses);
+
+    // in = use U (out - def), out = U in(sucesores); hasta punto fijo.
+    // Se recorren los bloques alcanzables en postorder (el sentido del análisis);
+    // los inalcanzables quedan con in/out vacíos y no influyen en el resto.
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int k = lv->cfg->nreachable - 1; k >= 0; k--) {
+            int b = lv->cfg->order[k];
+            BasicBlock *bb = &lv->cfg->blocks[b];
+            LiveBlock *block = &lv->blocks[b];
+            for (int w = 0; w < lv->words; w++) {
+                uint64_t out = 0;
+                for (int s = 0; s < 2; s++)
+                    if (bb->succ[s] >= 0) out |= lv->blocks[bb->succ[s]].in[w];
+                uint64_t in = block->use[w] | (out & ~block->def[w]);
+                if (out != block->out[w] || in != block->in[w]) changed = true;
+                block->out[w] = out;
+                block->in[w] = in;
+            }
+        }
+    }
+    return lv;
+}
+
+void liveness_free(Liveness *lv) {
+    if (!lv) return;
+    for (int b = 0; b < lv->nblocks; b++) {
+        free(lv->blocks[b].use);
+        free(lv->blocks[b].def);
+        free(lv->blocks[b].in);
+        free(lv->blocks[b].out);
+    }
+    free(lv->blocks);
+    free(lv->values);
+    free(lv->param_next);
+    free(lv->call_params);
+    free(lv->ids);
+    cfg_free(lv->cfg);
+    free(lv);
+}
+
+static void extend(LiveInterval *iv, int pos) {
+    if (iv->start < 0 || pos < iv->start) iv->start = pos;
+    if (pos > iv->end) iv->end = pos;
+}
+
+static int compare_start(const void *a, const void *b) {
+    const LiveInterval *x = a, *y = b;
+    if (x->start != y->start) return x->start - y->start;
+    return x->end - y->end;
+}
+
+int liveness_intervals(Liveness *lv, LiveInterval **out) {
+    LiveInterval *ivs = malloc((lv->nvalues > 0 ? lv->nvalues : 1) * sizeof(LiveInterval));
+    for (int v = 0; v < lv->nvalues; v++) {
+        ivs[v].value = lv->values[v];
+        ivs[v].start = -1;
+        ivs[v].end = -1;
+        ivs[v].crosses_call = false;
+    }
+
+    Bitset live = bitset_new(lv->words);
+    IROperand *uses = malloc(liveness_max_uses(lv) * sizeof(IROperand));
+
+    for (int b = 0; b < lv->nblocks; b++) {
+        BasicBlock *bb = &lv->cfg->blocks[b];
+        LiveBlock *block = &lv->blocks[b];
+        for (int v = 0; v < lv->nvalues; v++) {
+            if (BITSET_TEST(block->in, v)) extend(&ivs[v], bb->first);
+            if (BITSET_TEST(block->out, v)) extend(&ivs[v], bb->last);
+        }
+
+        // Recorrido hacia atrás para marcar los valores vivos a través de cada CALL
+        for (int w = 0; w < lv->words; w++) live[w] = block->out[w];
+        for (int i = bb->last; i >= bb->first; i--) {
+            IRCode *code = &lv->list->codes[i];
+            int d = liveness_id(lv, ir_def(code));
+            if (d >= 0) {
+                extend(&ivs[d], i);
+                BITSET_CLEAR(live, d);
+            }
+            if (code->op == IR_CALL) {
+                for (int v = 0; v < lv->nvalues; v++)
+                    if (BITSET_TEST(live, v)) ivs[v].crosses_call = true;
+            }
+            int n = liveness_uses(lv, i, uses);
+            for (int k = 0; k < n; k++) {
+                int id = liveness_id(lv, uses[k]);
+                if (id < 0) continue;
+                extend(&ivs[id], i);
+                BITSET_SET(live, id);
+            }
+        }
+    }
+    free(live);
+    free(uses);
+
+    qsort(ivs, lv->nvalues, sizeof(LiveInterval), compare_start);
+    *out = ivs;
+    return lv->nvalues;
+}
@@ -0,0 +1,165 @@
+#include <time.h>
+#include <strings.h>
+#include "Optimizer.h"
+
+static bool opt_jumps(CompilerContext *ctx, IRList *list);
+
+/*
+ * Registro de pases, en el orden en que se ejecutan.
+ * Para agregar un pase basta con sumarlo a esta tabla.
+ */
+static const OptPass passes[] = {
+    { "ssa",   "pasa a SSA, propaga copias y vuelve (parte las variables en versiones)", opt_ssa, true },
+    { "fold",  "plegado y propagación de constantes", opt_fold, false },
+    { "dce",   "elimina código inalcanzable y definiciones que no se leen", opt_dce, false },
+    { "branches", "fusiona comparaciones con el salto condicional que las consume", opt_branches, false },
+    { "jumps", "elimina saltos a la instrucción siguiente y etiquetas sin uso", opt_jumps, false },
+    // Pases del backend: los consulta la etapa assembly con optimization_enabled()
+    { "regalloc", "asignación de registros (linear scan)", NULL, false },
+    { "slots", "temporales sin solapamiento comparten slot en la pila", NULL, false },
+    { "peep-mov", "peephole: movq redundantes y lecturas de valores conocidos", NULL, false },
+    { "peep-jmp", "peephole: saltos a la etiqueta siguiente", NULL, false },
+    { "peep-cmp", "peephole: setcc + cmpq $1 + jne se fusionan en un jcc", NULL, false },
+    { "peep-shl", "peephole: imulq por potencia de 2 como salq", NULL, false },
+};
+
+#define PASS_COUNT ((int)(sizeof(passes) / sizeof(passes[0])))
+
+static bool selected[PASS_COUNT];
+
+static int find_pass(const char *name, size_t len) {
+    for (int i = 0; i < PASS_COUNT; i++) {
+        if (strlen(passes[i].name) == len && strncasecmp(passes[i].name, name, len) == 0)
+            return i;
+    }
+    return -1;
+}
+
+bool optimizer_configure(const char *spec) {
+    for (int i = 0; i < PASS_COUNT; i++) selected[i] = false;
+    if (!spec) return true;
+
+    if (strcasecmp(spec, "all") == 0) {
+        for (int i = 0; i < PASS_COUNT; i++) selected[i] = true;
+        return true;
+    }
+
+    const char *p = spec;
+    while (*p) {
+        const char *end = strchr(p, ',');
+        size_t len = end ? (size_t)(end - p) : strlen(p);
+        if (len > 0) {
+            int idx = find_pass(p, len);
+            if (idx < 0) {
+                fprintf(stderr, "Error: optimización desconocida '%.*s'\n", (int)len, p);
+                print_optimizations();
+                return false;
+            }
+            selected[idx] = true;
+        }
+        if (!end) break;
+        p = end + 1;
+    }
+    return true;
+}
+
+bool optimization_enabled(const char *name) {
+    int idx = find_pass(name, strlen(name));
+    return idx >= 0 && selected[idx];
+}
+
+void print_optimizations(void) {
+    printf("Optimizaciones disponibles (-opt all o lista separada por comas):\n");
+    for (int i = 0; i < PASS_COUNT; i++)
+        printf("  %-10s %s\n", passes[i].name, passes[i].description);
+}
+
+void run_optimizations(CompilerContext *ctx, IRList *list, bool debug) {
+    bool changed = true;
+    int iter;
+    PhaseTimer total;
+    report_start(ctx->report, &total);
+
+    for (iter = 1; changed && iter <= OPT_MAX_ITERATIONS; iter++) {
+        changed = false;
+        for (int i = 0; i < PASS_COUNT; i++) {
+            if (!selected[i] || !passes[i].run || (passes[i].once && iter > 1)) continue;
+
+            int before = list->size;
+            struct timespec start;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            PhaseTimer timer;
+            report_start(ctx->report, &timer);
+
+            bool pass_changed = passes[i].run(ctx, list);
+            ir_compact(list);
+            report_stop_pass(ctx->report, i, passes[i].name, &timer);
+
+            if (debug) {
+                printf("[DEBUG] Pase '%s' (vuelta %d): %d -> %d instrucciones (%+d), %.3f ms%s\n",
+                       passes[i].name, iter, before, list->size, list->size - before,
+                       elapsed_ms(&start), pass_changed ? "" : ", sin cambios");
+            }
+            changed |= pass_changed;
+        }
+    }
+
+    report_stop(ctx->report, PHASE_OPTIMIZE, &total);
+
+    if (debug) {
+        if (changed)
+            printf("[DEBUG] Optimizaciones: se alcanzó el límite de %d vueltas\n", OPT_MAX_ITERATIONS);
+        else
+            printf("[DEBUG] Optimizaciones: punto fijo en %d vuelta(s)\n", iter - 1);
+    }
+}
+
+// =============================
+// Pase 'jumps'
+// =============================
+
+/**
+ * Elimina los saltos cuando la siguiente instrucción es 'LABEL L' (la
+ * condición no tiene efectos, así que también se van los condicionales)
+ * y luego las etiquetas que ningún salto referencia.
+ */
+static bool opt_jumps(CompilerContext *ctx, IRList *list) {
+    (void)ctx;  // no crea temporales ni etiquetas
+    bool changed = false;
+
+    for (int i = 0; i < list->size; i++) {
+        IRCode *code = &list->codes[i];
+        if (!ir_is_jump(code->op)) continue;
+
+        int next = i + 1;
+        while (next < list->size && list->codes[next].op == IR_NOP) next++;
+        if (next < list->size && list->codes[next].op == IR_LABEL &&
+            ir_same(list->codes[next].result, code->result)) {
+            code->op = IR_NOP;
+            changed = true;
+        }
+    }
+
+    // Marcar las etiquetas referenciadas por algún salto
+    int max_label = -1;
+    for (int i = 0; i < list->size; i++) {
+        IRCode *code = &list->codes[i];
+        if ((code->op == IR_LABEL || ir_is_jump(code->op)) && code->result.id > max_label)
+            max_label = code->result.id;
+    }
+    bool *used = calloc(max_label + 1, sizeof(bool));
+    for (int i = 0; i < list->size; i++) {
+        if (ir_is_jump(list->codes[i].op))
+            used[list->codes[i].result.id] = true;
+    }
+
+    for (int i = 0; i < list->size; i++) {
+        IRCode *code = &list->codes[i];
+        if (code->op == IR_LABEL && !used[code->result.id]) {
+            code->op = IR_NOP;
+            changed = true;
+        }
+    }
+    free(used);
+    return changed;
+}
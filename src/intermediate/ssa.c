@@ -0,0 +1,630 @@
+#include "SSA.h"
+#include "Optimizer.h"
+
+/* Nueva versión de una variable: para el backend es un temporal más */
+static IROperand new_version(SSAForm *ssa) {
+    IROperand v = newTemp(ssa->ctx);
+    // Se crean seguidas al renombrar: alcanza con el id de la primera
+    if (ssa->nversions++ == 0) ssa->first_version = v.id;
+    return v;
+}
+
+/*
+ * Índice denso de un valor del método: primero los del código original
+ * (lv->range) y después las versiones. -1 si no es un valor del método.
+ */
+static int value_slot(SSAForm *ssa, IROperand v) {
+    int k = ir_value_index(&ssa->lv->range, v);
+    if (k >= 0) return k;
+    k = v.id - ssa->first_version;
+    if (v.kind != IRO_TEMP || k < 0 || k >= ssa->nversions) return -1;
+    return ir_value_count(&ssa->lv->range) + k;
+}
+
+static int value_slots(SSAForm *ssa) {
+    return ir_value_count(&ssa->lv->range) + ssa->nversions;
+}
+
+/* Posición del bloque p en la lista de predecesores de s */
+static int pred_index(CFG *cfg, int s, int p) {
+    BasicBlock *block = &cfg->blocks[s];
+    for (int j = 0; j < block->npreds; j++)
+        if (block->preds[j] == p) return j;
+    return -1;
+}
+
+// =============================
+// Construcción
+// =============================
+
+/* DF(b): bloques donde deja de valer la dominancia de b (Cooper, Harvey y Kennedy) */
+static Bitset *dominance_frontiers(CFG *cfg) {
+    int words = BITSET_WORDS(cfg->nblocks);
+    Bitset *df = malloc(cfg->nblocks * sizeof(Bitset));
+    for (int b = 0; b < cfg->nblocks; b++) df[b] = calloc(words, sizeof(uint64_t));
+
+    for (int b = 0; b < cfg->nblocks; b++) {
+        BasicBlock *block = &cfg->blocks[b];
+        if (!CFG_REACHABLE(cfg, b) || block->npreds < 2) continue;
+        for (int p = 0; p < block->npreds; p++) {
+            int runner = block->preds[p];
+            if (!CFG_REACHABLE(cfg, runner)) continue;
+            while (runner != block->idom) {
+                BITSET_SET(df[runner], b);
+                runner = cfg->blocks[runner].idom;
+            }
+        }
+    }
+    return df;
+}
+
+static void add_phi(SSAForm *ssa, int b, IROperand var) {
+    SSABlock *block = &ssa->blocks[b];
+    block->phis = realloc(block->phis, (block->nphis + 1) * sizeof(PhiNode));
+    // calloc deja los argumentos en IRO_NONE
+    block->phis[block->nphis++] = (PhiNode){
+        ir_none(), var, calloc(ssa->cfg->blocks[b].npreds, sizeof(IROperand)), false
+    };
+}
+
+/*
+ * Inserta las phi en la frontera de dominancia iterada de los bloques que
+ * definen cada valor, solo donde el valor está vivo a la entrada (SSA podada).
+ */
+static void insert_phis(SSAForm *ssa, Bitset *df) {
+    Liveness *lv = ssa->lv;
+    CFG *cfg = ssa->cfg;
+    int n = lv->nvalues, nb = cfg->nblocks;
+
+    // Bloques que definen cada valor
+    int **sites = calloc(n > 0 ? n : 1, sizeof(int *));
+    int *nsites = calloc(n > 0 ? n : 1, sizeof(int));
+    for (int b = 0; b < nb; b++) {
+        if (!CFG_REACHABLE(cfg, b)) continue;
+        for (int i = cfg->blocks[b].first; i <= cfg->blocks[b].last; i++) {
+            int d = liveness_id(lv, ir_def(&cfg->list->codes[i]));
+            if (d < 0 || (nsites[d] > 0 && sites[d][nsites[d] - 1] == b)) continue;
+            sites[d] = realloc(sites[d], (nsites[d] + 1) * sizeof(int));
+            sites[d][nsites[d]++] = b;
+        }
+    }
+
+    // Marcas por valor (v + 1) para no reinicializar los arreglos en cada vuelta
+    int *has_phi = calloc(nb, sizeof(int));
+    int *queued = calloc(nb, sizeof(int));
+    int *work = malloc((nb > 0 ? nb : 1) * sizeof(int));
+
+    for (int v = 0; v < n; v++) {
+        int top = 0;
+        for (int k = 0; k < nsites[v]; k++) {
+            queued[sites[v][k]] = v + 1;
+            work[top++] = sites[v][k];
+        }
+        while (top > 0) {
+            int b = work[--top];
+            for (int f = 0; f < nb; f++) {
+                if (!BITSET_TEST(df[b], f) || has_phi[f] == v + 1) continue;
+                if (!BITSET_TEST(lv->blocks[f].in, v)) continue;
+                add_phi(ssa, f, lv->values[v]);
+                has_phi[f] = v + 1;
+                if (queued[f] != v + 1) {
+                    queued[f] = v + 1;
+                    work[top++] = f;
+                }
+            }
+        }
+        free(sites[v]);
+    }
+    free(sites);
+    free(nsites);
+    free(has_phi);
+    free(queued);
+    free(work);
+}
+
+typedef struct {
+    IROperand *items;
+    int top, capacity;
+} VersionStack;
+
+typedef struct {
+    SSAForm *ssa;
+    VersionStack *stacks;   // por valor: versiones vigentes
+    int *log;               // valores apilados, para desapilar al salir de un bloque
+    int nlog, log_capacity;
+    bool *original_used;    // la versión original ya fue asignada a una definición
+} Renamer;
+
+static IROperand current_version(Renamer *r, IROperand value) {
+    int v = liveness_id(r->ssa->lv, value);
+    if (v < 0 || r->stacks[v].top == 0) return value;
+    return r->stacks[v].items[r->stacks[v].top - 1];
+}
+
+static void push_version(Renamer *r, int v, IROperand version) {
+    VersionStack *stack = &r->stacks[v];
+    if (stack->top == stack->capacity) {
+        stack->capacity = stack->capacity ? stack->capacity * 2 : 4;
+        stack->items = realloc(stack->items, stack->capacity * sizeof(IROperand));
+    }
+    stack->items[stack->top++] = version;
+
+    if (r->nlog == r->log_capacity) {
+        r->log_capacity = r->log_capacity ? r->log_capacity * 2 : 64;
+        r->log = realloc(r->log, r->log_capacity * sizeof(int));
+    }
+    r->log[r->nlog++] = v;
+}
+
+/*
+ * Versión para una nueva definición de v. La primera puede quedarse con el
+ * operando original si nadie lee el valor que v tenía al entrar al método
+ * (temporales, y los parámetros, que define IR_SAVE_PARAM).
+ */
+static IROperand define_version(Renamer *r, int v, bool keep_original) {
+    Liveness *lv = r->ssa->lv;
+    IROperand version;
+    if (keep_original || (!r->original_used[v] && !BITSET_TEST(lv->blocks[0].in, v))) {
+        version = lv->values[v];
+        r->original_used[v] = true;
+    } else {
+        version = new_version(r->ssa);
+    }
+    push_version(r, v, version);
+    return version;
+}
+
+static void rename_block(Renamer *r, int b) {
+    SSAForm *ssa = r->ssa;
+    CFG *cfg = ssa->cfg;
+    BasicBlock *block = &cfg->blocks[b];
+    IROperand uses[2];
+
+    for (int k = 0; k < ssa->blocks[b].nphis; k++) {
+        PhiNode *phi = &ssa->blocks[b].phis[k];
+        phi->result = define_version(r, liveness_id(ssa->lv, phi->var), false);
+    }
+
+    for (int i = block->first; i <= block->last; i++) {
+        IRCode *code = &cfg->list->codes[i];
+        // ir_uses devuelve arg1 y después arg2: alcanza con la cantidad
+        int n = ir_uses(code, uses);
+        if (n >= 1) code->arg1 = current_version(r, code->arg1);
+        if (n >= 2) code->arg2 = current_version(r, code->arg2);
+
+        int d = liveness_id(ssa->lv, ir_def(code));
+        if (d < 0) continue;
+        if (code->op == IR_SAVE_PARAM) code->arg1 = define_version(r, d, true);
+        else code->result = define_version(r, d, false);
+    }
+
+    for (int s = 0; s < 2; s++) {
+        int succ = block->succ[s];
+        if (succ < 0) continue;
+        int j = pred_index(cfg, succ, b);
+        for (int k = 0; k < ssa->blocks[succ].nphis; k++) {
+            PhiNode *phi = &ssa->blocks[succ].phis[k];
+            phi->args[j] = current_version(r, phi->var);
+        }
+    }
+}
+
+/* Renombrado en preorden del árbol de dominadores, con una pila explícita */
+static void rename_values(SSAForm *ssa) {
+    CFG *cfg = ssa->cfg;
+    int n = ssa->lv->nvalues;
+    Renamer r = { ssa, calloc(n > 0 ? n : 1, sizeof(VersionStack)), NULL, 0, 0,
+                  calloc(n > 0 ? n : 1, sizeof(bool)) };
+
+    int *stack = malloc(cfg->nblocks * sizeof(int));
+    int *mark = malloc(cfg->nblocks * sizeof(int));
+    int *child = malloc(cfg->nblocks * sizeof(int));
+    int top = 0;
+
+    mark[0] = r.nlog;
+    rename_block(&r, 0);
+    child[0] = cfg->blocks[0].dom_child;
+    stack[top++] = 0;
+    while (top > 0) {
+        int b = stack[top - 1];
+        int c = child[b];
+        if (c >= 0) {
+            child[b] = cfg->blocks[c].dom_sibling;
+            mark[c] = r.nlog;
+            rename_block(&r, c);
+            child[c] = cfg->blocks[c].dom_child;
+            stack[top++] = c;
+        } else {
+            while (r.nlog > mark[b]) r.stacks[r.log[--r.nlog]].top--;
+            top--;
+        }
+    }
+
+    // Argumentos desde predecesores inalcanzables: nunca se usan
+    for (int b = 0; b < cfg->nblocks; b++) {
+        for (int k = 0; k < ssa->blocks[b].nphis; k++) {
+            PhiNode *phi = &ssa->blocks[b].phis[k];
+            for (int j = 0; j < cfg->blocks[b].npreds; j++)
+                if (!ir_has(phi->args[j])) phi->args[j] = phi->var;
+        }
+    }
+
+    for (int v = 0; v < n; v++) free(r.stacks[v].items);
+    free(r.stacks);
+    free(r.log);
+    free(r.original_used);
+    free(stack);
+    free(mark);
+    free(child);
+}
+
+SSAForm *ssa_build(CompilerContext *ctx, IRList *list, int start, int end) {
+    SSAForm *ssa = calloc(1, sizeof(SSAForm));
+    ssa->ctx = ctx;
+    ssa->lv = liveness_compute(ctx, list, start, end);
+    ssa->cfg = ssa->lv->cfg;
+    ssa->blocks = calloc(ssa->cfg->nblocks, sizeof(SSABlock));
+
+    Bitset *df = dominance_frontiers(ssa->cfg);
+    insert_phis(ssa, df);
+    for (int b = 0; b < ssa->cfg->nblocks; b++) free(df[b]);
+    free(df);
+
+    rename_values(ssa);
+    return ssa;
+}
+
+void ssa_free(SSAForm *ssa) {
+    if (!ssa) return;
+    for (int b = 0; b < ssa->cfg->nblocks; b++) {
+        for (int k = 0; k < ssa->blocks[b].nphis; k++) free(ssa->blocks[b].phis[k].args);
+        free(ssa->blocks[b].phis);
+    }
+    free(ssa->blocks);
+    liveness_free(ssa->lv);
+    free(ssa);
+}
+
+// =============================
+// Verificación
+// =============================
+
+static bool ssa_error(SSAForm *ssa, const char *what, IROperand v) {
+    char buf[32];
+    fprintf(stderr, "Error interno (SSA) en '%s': %s '%s'\n",
+            ir_symbol(ssa->ctx, ssa->cfg->list->codes[ssa->cfg->start].result)->name, what,
+            ir_has(v) ? ir_name(ssa->ctx, v, buf, sizeof buf) : "?");
+    return false;
+}
+
+/* true si la definición (bloque db, posición dp) está disponible en la instrucción i del bloque b */
+static bool def_reaches(CFG *cfg, int db, int dp, int b, int i) {
+    return db == b ? dp < i : cfg_dominates(cfg, db, b);
+}
+
+bool ssa_verify(SSAForm *ssa) {
+    CFG *cfg = ssa->cfg;
+    int n = value_slots(ssa);
+    // Por valor: bloque (+ 1, 0 si no tiene definición) y posición de su definición
+    int *def_block = calloc(n > 0 ? n : 1, sizeof(int));
+    int *def_pos = malloc((n > 0 ? n : 1) * sizeof(int));
+    bool ok = true;
+    int k;
+
+    // Definiciones: las phi quedan antes de la primera instrucción del bloque
+    for (int b = 0; b < cfg->nblocks && ok; b++) {
+        if (!CFG_REACHABLE(cfg, b)) continue;
+        for (int p = 0; p < ssa->blocks[b].nphis && ok; p++) {
+            PhiNode *phi = &ssa->blocks[b].phis[p];
+            if (phi->removed || (k = value_slot(ssa, phi->result)) < 0) continue;
+            if (def_block[k])
+                ok = ssa_error(ssa, "más de una definición de", phi->result);
+            def_block[k] = b + 1;
+            def_pos[k] = cfg->blocks[b].first - 1;
+        }
+        for (int i = cfg->blocks[b].first; i <= cfg->blocks[b].last && ok; i++) {
+            IROperand d = ir_def(&cfg->list->codes[i]);
+            if ((k = value_slot(ssa, d)) < 0) continue;
+            if (def_block[k])
+                ok = ssa_error(ssa, "más de una definición de", d);
+            def_block[k] = b + 1;
+            def_pos[k] = i;
+        }
+    }
+
+    // Usos: cada uno dominado por su definición (los que no tienen son valores de entrada)
+    IROperand uses[2];
+    for (int b = 0; b < cfg->nblocks && ok; b++) {
+        if (!CFG_REACHABLE(cfg, b)) continue;
+        BasicBlock *block = &cfg->blocks[b];
+
+        for (int p = 0; p < ssa->blocks[b].nphis && ok; p++) {
+            PhiNode *phi = &ssa->blocks[b].phis[p];
+            if (phi->removed) continue;
+            for (int j = 0; j < block->npreds && ok; j++) {
+                int pred = block->preds[j];
+                if (!CFG_REACHABLE(cfg, pred)) continue;
+                if (!ir_has(phi->args[j]))
+                    ok = ssa_error(ssa, "phi sin argumento para", phi->result);
+                else if ((k = value_slot(ssa, phi->args[j])) >= 0 && def_block[k] &&
+                         !def_reaches(cfg, def_block[k] - 1, def_pos[k], pred, cfg->blocks[pred].last + 1))
+                    ok = ssa_error(ssa, "argumento de phi no dominado por su definición:", phi->args[j]);
+            }
+        }
+
+        for (int i = block->first; i <= block->last && ok; i++) {
+            int nuses = ir_uses(&cfg->list->codes[i], uses);
+            for (int u = 0; u < nuses && ok; u++) {
+                if ((k = value_slot(ssa, uses[u])) < 0 || !def_block[k]) continue;
+                if (!def_reaches(cfg, def_block[k] - 1, def_pos[k], b, i))
+                    ok = ssa_error(ssa, "uso no dominado por su definición:", uses[u]);
+            }
+        }
+    }
+
+    free(def_block);
+    free(def_pos);
+    return ok;
+}
+
+// =============================
+// Propagación de copias
+// =============================
+
+/* Por valor (value_slot): el valor que lo reemplaza, o IRO_NONE */
+typedef struct {
+    IROperand *to;
+    int count;
+} Substitution;
+
+static void substitute(SSAForm *ssa, Substitution *s, IROperand from, IROperand to) {
+    s->to[value_slot(ssa, from)] = to;
+    s->count++;
+}
+
+static IROperand resolve(SSAForm *ssa, Substitution *s, IROperand v) {
+    int k;
+    while ((k = value_slot(ssa, v)) >= 0 && ir_has(s->to[k])) v = s->to[k];
+    return v;
+}
+
+bool ssa_copy_propagate(SSAForm *ssa) {
+    CFG *cfg = ssa->cfg;
+    int n = value_slots(ssa);
+    Substitution subst = { calloc(n > 0 ? n : 1, sizeof(IROperand)), 0 };
+
+    // Copias explícitas: en SSA la fuente no cambia mientras la copia esté viva
+    for (int b = 0; b < cfg->nblocks; b++) {
+        if (!CFG_REACHABLE(cfg, b)) continue;
+        for (int i = cfg->blocks[b].first; i <= cfg->blocks[b].last; i++) {
+            IRCode *code = &cfg->list->codes[i];
+            if ((code->op != IR_LOAD && code->op != IR_STORE) ||
+                value_slot(ssa, code->result) < 0 || !ir_is_value(code->arg1)) continue;
+            substitute(ssa, &subst, code->result, code->arg1);
+            code->op = IR_NOP;
+        }
+    }
+
+    // Phi triviales: todos los argumentos son la misma versión (o la propia phi)
+    bool again = true;
+    while (again) {
+        again = false;
+        for (int b = 0; b < cfg->nblocks; b++) {
+            if (!CFG_REACHABLE(cfg, b)) continue;
+            for (int k = 0; k < ssa->blocks[b].nphis; k++) {
+                PhiNode *phi = &ssa->blocks[b].phis[k];
+                if (phi->removed) continue;
+                IROperand same = ir_none();
+                bool trivial = true;
+                for (int j = 0; j < cfg->blocks[b].npreds && trivial; j++) {
+                    if (!CFG_REACHABLE(cfg, cfg->blocks[b].preds[j])) continue;
+                    IROperand arg = resolve(ssa, &subst, phi->args[j]);
+                    if (ir_same(arg, phi->result) || ir_same(arg, same)) continue;
+                    if (ir_has(same)) trivial = false;
+                    same = arg;
+                }
+                if (!trivial || !ir_has(same)) continue;
+                substitute(ssa, &subst, phi->result, same);
+                phi->removed = true;
+                again = true;
+            }
+        }
+    }
+
+    bool changed = subst.count > 0;
+    if (changed) {
+        IROperand uses[2];
+        for (int b = 0; b < cfg->nblocks; b++) {
+            if (!CFG_REACHABLE(cfg, b)) continue;
+            for (int i = cfg->blocks[b].first; i <= cfg->blocks[b].last; i++) {
+                IRCode *code = &cfg->list->codes[i];
+                int nuses = ir_uses(code, uses);
+                if (nuses >= 1) code->arg1 = resolve(ssa, &subst, code->arg1);
+                if (nuses >= 2) code->arg2 = resolve(ssa, &subst, code->arg2);
+            }
+            for (int k = 0; k < ssa->blocks[b].nphis; k++) {
+                PhiNode *phi = &ssa->blocks[b].phis[k];
+                for (int j = 0; j < cfg->blocks[b].npreds; j++)
+                    phi->args[j] = resolve(ssa, &subst, phi->args[j]);
+            }
+        }
+    }
+
+    free(subst.to);
+    return changed;
+}
+
+// =============================
+// Destrucción
+// =============================
+
+/* true si alguna phi de s necesita una copia en la arista p -> s */
+static bool edge_has_copies(SSAForm *ssa, int s, int p) {
+    int j = pred_index(ssa->cfg, s, p);
+    for (int k = 0; k < ssa->blocks[s].nphis; k++) {
+        PhiNode *phi = &ssa->blocks[s].phis[k];
+        if (!phi->removed && !ir_same(phi->args[j], phi->result)) return true;
+    }
+    return false;
+}
+
+/*
+ * Emite las copias de la arista p -> s. Son paralelas (todas leen antes de
+ * que se escriba ninguna): se ordenan para no pisar una fuente pendiente y
+ * los ciclos se rompen con un temporal.
+ */
+static void emit_edge_copies(SSAForm *ssa, int s, int p, IRList *out) {
+    int j = pred_index(ssa->cfg, s, p);
+    int n = 0;
+    IROperand *dst = malloc((ssa->blocks[s].nphis + 1) * sizeof(IROperand));
+    IROperand *src = malloc((ssa->blocks[s].nphis + 1) * sizeof(IROperand));
+
+    for (int k = 0; k < ssa->blocks[s].nphis; k++) {
+        PhiNode *phi = &ssa->blocks[s].phis[k];
+        if (phi->removed || ir_same(phi->args[j], phi->result)) continue;
+        dst[n] = phi->result;
+        src[n] = phi->args[j];
+        n++;
+    }
+
+    while (n > 0) {
+        int ready = -1;
+        for (int k = 0; k < n && ready < 0; k++) {
+            bool read_later = false;
+            for (int m = 0; m < n && !read_later; m++)
+                read_later = m != k && ir_same(src[m], dst[k]);
+            if (!read_later) ready = k;
+        }
+        if (ready < 0) {
+            IROperand tmp = newTemp(ssa->ctx);
+            ir_emit(out, IR_STORE, dst[0], ir_none(), tmp);
+            for (int m = 0; m < n; m++)
+                if (ir_same(src[m], dst[0])) src[m] = tmp;
+            continue;
+        }
+        ir_emit(out, IR_STORE, src[ready], ir_none(), dst[ready]);
+        n--;
+        dst[ready] = dst[n];
+        src[ready] = src[n];
+    }
+    free(dst);
+    free(src);
+}
+
+static bool falls_through(IRList *out) {
+    if (out->size == 0) return false;
+    IRCode *last = &out->codes[out->size - 1];
+    return !(last->op == IR_RETURN || (ir_is_jump(last->op) && !ir_is_conditional(last)));
+}
+
+static void emit_code(IRList *out, IRCode *code) {
+    ir_append(out, code);
+}
+
+/*
+ * Bloques nuevos para las aristas críticas que saltan a b: se ubican justo
+ * antes de su etiqueta y el último cae directamente en b.
+ */
+static void emit_split_blocks(SSAForm *ssa, int b, IROperand *split, IRList *out) {
+    CFG *cfg = ssa->cfg;
+    BasicBlock *block = &cfg->blocks[b];
+    IROperand label = cfg->list->codes[block->first].result;
+    int count = 0, emitted = 0;
+
+    for (int j = 0; j < block->npreds; j++)
+        if (ir_has(split[block->preds[j]]) && cfg->blocks[block->preds[j]].succ[0] == b) count++;
+    if (count == 0) return;
+
+    if (falls_through(out)) ir_emit(out, IR_GOTO, ir_none(), ir_none(), label);
+    for (int j = 0; j < block->npreds; j++) {
+        int p = block->preds[j];
+        if (!ir_has(split[p]) || cfg->blocks[p].succ[0] != b) continue;
+        ir_emit(out, IR_LABEL, ir_none(), ir_none(), split[p]);
+        emit_edge_copies(ssa, b, p, out);
+        if (++emitted < count) ir_emit(out, IR_GOTO, ir_none(), ir_none(), label);
+    }
+}
+
+void ssa_destruct(SSAForm *ssa, IRList *out) {
+    CFG *cfg = ssa->cfg;
+    IRList *list = cfg->list;
+
+    // Aristas críticas: el salto de un salto condicional hacia un bloque con phi
+    IROperand *split = calloc(cfg->nblocks, sizeof(IROperand));
+    for (int b = 0; b < cfg->nblocks; b++) {
+        BasicBlock *block = &cfg->blocks[b];
+        if (CFG_REACHABLE(cfg, b) && block->succ[1] >= 0 && edge_has_copies(ssa, block->succ[0], b))
+            split[b] = newLabel(ssa->ctx);
+    }
+
+    for (int b = 0; b < cfg->nblocks; b++) {
+        BasicBlock *block = &cfg->blocks[b];
+        if (!CFG_REACHABLE(cfg, b)) {
+            // El cierre del método se conserva aunque no se llegue a él
+            if (list->codes[block->last].op == IR_FMETHOD) emit_code(out, &list->codes[block->last]);
+            continue;
+        }
+
+        emit_split_blocks(ssa, b, split, out);
+
+        IRCode *last = &list->codes[block->last];
+        bool jump = ir_is_jump(last->op);
+        for (int i = block->first; i < block->last; i++)
+            if (list->codes[i].op != IR_NOP) emit_code(out, &list->codes[i]);
+
+        if (jump && !ir_is_conditional(last)) {
+            // Salto incondicional: las copias van antes
+            if (edge_has_copies(ssa, block->succ[0], b)) emit_edge_copies(ssa, block->succ[0], b, out);
+            emit_code(out, last);
+        } else if (jump && block->succ[1] >= 0) {
+            // Salto condicional: el salto va al bloque de partición, la caída lleva sus copias
+            ir_emit(out, last->op, last->arg1, last->arg2, ir_has(split[b]) ? split[b] : last->result);
+            if (edge_has_copies(ssa, block->succ[1], b)) emit_edge_copies(ssa, block->succ[1], b, out);
+        } else if (jump) {
+            // Salto condicional a la instrucción siguiente: no hace nada
+            if (edge_has_copies(ssa, block->succ[0], b)) emit_edge_copies(ssa, block->succ[0], b, out);
+            else emit_code(out, last);
+        } else {
+            if (last->op != IR_NOP) emit_code(out, last);
+            if (block->succ[0] >= 0 && edge_has_copies(ssa, block->succ[0], b))
+                emit_edge_copies(ssa, block->succ[0], b, out);
+        }
+    }
+    free(split);
+}
+
+// =============================
+// Pase 'ssa'
+// =============================
+
+/*
+ * Lleva cada método a SSA, propaga las copias y vuelve a salir de SSA.
+ * Las variables quedan partidas en versiones con rangos de vida más cortos,
+ * que después aprovechan regalloc y slots.
+ */
+bool opt_ssa(CompilerContext *ctx, IRList *list) {
+    IRList out;
+    ir_init(&out);
+    bool changed = false;
+
+    for (int i = 0; i < list->size; i++) {
+        if (list->codes[i].op != IR_METHOD) {
+            emit_code(&out, &list->codes[i]);
+            continue;
+        }
+        int end = ir_method_end(list, i);
+        SSAForm *ssa = ssa_build(ctx, list, i, end);
+        if (!ssa_verify(ssa)) exit(EXIT_FAILURE);
+        if (ssa_copy_propagate(ssa)) {
+            changed = true;
+            if (!ssa_verify(ssa)) exit(EXIT_FAILURE);
+        }
+        ssa_destruct(ssa, &out);
+        ssa_free(ssa);
+        i = end;
+    }
+
+    ir_free(list);
+    *list = out;
+    return changed;
+}
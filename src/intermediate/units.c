@@ -0,0 +1,146 @@
+#include <stdlib.h>
+#include <string.h>
+#include "Units.h"
+#include "CFG.h"
+
+typedef struct {
+    IRUnit *unit;
+    UnitFn fn;
+    void *arg;
+} UnitTask;
+
+/* La copia comparte el AST, los nombres, el pool y los diagnósticos del archivo */
+static void unit_init(CompilerContext *ctx, IRUnit *unit, int number) {
+    unit->ctx = *ctx;
+    unit->ctx.unit = number;
+    unit->ctx.scanner = NULL;
+    unit->ctx.arena = arena_create();
+    unit->ctx.decl_vars = NULL;
+    asm_init(&unit->ctx.asm_out);
+    x86_init(&unit->ctx.mc_out);
+    unit->ctx.pending_params = NULL;
+    unit->ctx.pending_count = unit->ctx.pending_capacity = 0;
+    unit->ctx.div_label_count = 0;
+    memset(&unit->ctx.temps, 0, sizeof(IRValueTable));
+    memset(&unit->ctx.locals, 0, sizeof(IRValueTable));
+    // Cada unidad mide en su propio reporte; units_run los suma al del archivo
+    unit->ctx.report = ctx->report ? calloc(1, sizeof(TimeReport)) : NULL;
+    ir_init(&unit->list);
+}
+
+/*
+ * Los temporales y etiquetas que creen los pases de la unidad siguen desde
+ * los últimos de su código: así sus tablas quedan chicas y los ids de cada
+ * método, casi contiguos. Las etiquetas nuevas llevan además el número de
+ * unidad, así que no chocan con las de otra.
+ */
+static void number_from_last(IRUnit *unit) {
+    int temps = 0, labels = 0;
+    for (int k = 0; k < unit->list.size; k++) {
+        IRCode *code = &unit->list.codes[k];
+        IROperand ops[3] = { code->arg1, code->arg2, code->result };
+        for (int j = 0; j < 3; j++) {
+            if (ops[j].kind == IRO_TEMP && ops[j].id >= temps) temps = ops[j].id + 1;
+            else if (ops[j].kind == IRO_LABEL && ops[j].id >= labels) labels = ops[j].id + 1;
+        }
+    }
+    unit->ctx.temp_count = temps;
+    unit->ctx.label_count = labels;
+}
+
+static IRUnit *add_unit(CompilerContext *ctx, IRUnits *units) {
+    units->units = realloc(units->units, (units->count + 1) * sizeof(IRUnit));
+    IRUnit *unit = &units->units[units->count++];
+    unit_init(ctx, unit, units->count);
+    return unit;
+}
+
+void units_split(CompilerContext *ctx, IRList *list, IRUnits *units) {
+    units->units = NULL;
+    units->count = 0;
+    units->methods = 0;
+
+    int i = 0;
+    while (i < list->size) {
+        int end;
+        if (list->codes[i].op == IR_METHOD) {
+            end = ir_method_end(list, i);
+            if (end >= list->size) end = list->size - 1;
+            units->methods++;
+        } else {
+            // Código fuera de los métodos (globales, externos) hasta el próximo método
+            end = i;
+            while (end + 1 < list->size && list->codes[end + 1].op != IR_METHOD) end++;
+        }
+
+        IRUnit *unit = add_unit(ctx, units);
+        for (int k = i; k <= end; k++) ir_append(&unit->list, &list->codes[k]);
+        number_from_last(unit);
+        i = end + 1;
+    }
+}
+
+static void run_unit(void *arg) {
+    UnitTask *task = arg;
+    CompilerContext *prev = context_bind(&task->unit->ctx);
+    task->fn(task->unit, task->arg);
+    context_bind(prev);
+}
+
+/*
+ * Crear los hilos cuesta más que traducir unos pocos métodos: el pool se
+ * crea con un hilo cada UNITS_PER_THREAD unidades, y solo si salen dos o más.
+ */
+#define UNITS_PER_THREAD 8
+
+static void ensure_pool(CompilerContext *ctx, int count) {
+    if (ctx->pool || ctx->pool_threads < 2) return;
+    int threads = count / UNITS_PER_THREAD;
+    if (threads > ctx->pool_threads) threads = ctx->pool_threads;
+    if (threads >= 2) ctx->pool = pool_create(threads);
+}
+
+void units_run(CompilerContext *ctx, IRUnits *units, UnitFn fn, void *arg) {
+    ensure_pool(ctx, units->count);
+    UnitTask *tasks = malloc((units->count > 0 ? units->count : 1) * sizeof(UnitTask));
+    for (int i = 0; i < units->count; i++)
+        tasks[i] = (UnitTask){ &units->units[i], fn, arg };
+
+    if (!ctx->pool || units->count < 2) {
+        for (int i = 0; i < units->count; i++) run_unit(&tasks[i]);
+    } else {
+        PoolGroup group = { 0 };
+        for (int i = 0; i < units->count; i++) pool_submit(ctx->pool, &group, run_unit, &tasks[i]);
+        pool_wait(ctx->pool, &group);
+    }
+    free(tasks);
+
+    for (int i = 0; ctx->report && i < units->count; i++) {
+        report_merge(ctx->report, units->units[i].ctx.report);
+        memset(units->units[i].ctx.report, 0, sizeof(TimeReport));
+    }
+}
+
+void units_join(IRUnits *units, IRList *list) {
+    for (int i = 0; i < units->count; i++) {
+        IRList *part = &units->units[i].list;
+        for (int k = 0; k < part->size; k++) ir_append(list, &part->codes[k]);
+    }
+}
+
+void units_free(IRUnits *units) {
+    for (int i = 0; i < units->count; i++) {
+        IRUnit *unit = &units->units[i];
+        ir_free(&unit->list);
+        asm_free(&unit->ctx.asm_out);
+        x86_free(&unit->ctx.mc_out);
+        free(unit->ctx.pending_params);
+        free(unit->ctx.temps.items);
+        free(unit->ctx.locals.items);
+        free(unit->ctx.report);
+        arena_destroy(unit->ctx.arena);
+    }
+    free(units->units);
+    units->units = NULL;
+    units->count = 0;
+}
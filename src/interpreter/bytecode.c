@@ -0,0 +1,681 @@
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "Bytecode.h"
+#include "Bytecode.h"
+
+#define BC_MAGIC        "TDSB"
+#define BC_VERSION      1
+
+typedef struct {
+    int instr;          // salto a completar cuando se conozcan todas las etiquetas
+    IROperand label;
+} Fixup;
+
+typedef struct {
+    IROperand value;
+    int index;
+} PendingArg;
+
+typedef struct {
+    CompilerContext *ctx;
+    BcProgram *prog;
+    int code_capacity;
+
+    // Por id de operando (ctx->ir_methods / ir_globals), o -1
+    int *functions;             // método -> índice en prog->functions
+    int *externs;               // método externo -> índice en prog->externs
+    int *globals;               // global -> índice en prog->globals
+
+    // Del método que se está traduciendo
+    IRValueRange range;
+    int *slots;                 // parámetro, local o temporal (ir_value_index) -> slot del marco
+    int *labels;                // etiqueta (id - label_base) -> instrucción
+    int label_base;
+    int slot_count;
+    int scratch_used;           // slots de paso usados por la instrucción actual
+    int scratch_max;
+    Fixup *fixups;
+    int fixup_count, fixup_capacity;
+    PendingArg *pending;        // IR_PARAM que esperan su IR_CALL
+    int pending_count, pending_capacity;
+} BcCompiler;
+
+// =============================
+// Tablas del programa
+// =============================
+
+static int emit(BcCompiler *c, BcOp op, int a, int b, int cc) {
+    BcProgram *p = c->prog;
+    if (p->code_size == c->code_capacity) {
+        c->code_capacity = c->code_capacity ? c->code_capacity * 2 : 256;
+        p->code = realloc(p->code, c->code_capacity * sizeof(BcInstr));
+    }
+    p->code[p->code_size] = (BcInstr){ op, a, b, cc };
+    return p->code_size++;
+}
+
+static int add_global(BcCompiler *c, IROperand sym, long value) {
+    BcProgram *p = c->prog;
+    p->globals = realloc(p->globals, (p->global_count + 1) * sizeof(long));
+    p->globals[p->global_count] = value;
+    c->globals[sym.id] = p->global_count;
+    return p->global_count++;
+}
+
+static int global_index(BcCompiler *c, IROperand sym) {
+    if (c->globals[sym.id] >= 0) return c->globals[sym.id];
+    return add_global(c, sym, 0);
+}
+
+static int extern_index(BcCompiler *c, IROperand method) {
+    if (c->externs[method.id] >= 0) return c->externs[method.id];
+    BcProgram *p = c->prog;
+    p->externs = realloc(p->externs, (p->extern_count + 1) * sizeof(char *));
+    p->externs[p->extern_count] = strdup(ir_symbol(c->ctx, method)->name);
+    c->externs[method.id] = p->extern_count;
+    return p->extern_count++;
+}
+
+static void add_function(BcCompiler *c, IROperand operand) {
+    BcProgram *p = c->prog;
+    Symbol *method = ir_symbol(c->ctx, operand);
+    p->functions = realloc(p->functions, (p->function_count + 1) * sizeof(BcFunction));
+    p->functions[p->function_count] = (BcFunction){ strdup(method->name), 0, 0, method->param_count };
+    if (strcmp(method->name, "main") == 0) p->main_function = p->function_count;
+    c->functions[operand.id] = p->function_count++;
+}
+
+/* Un arreglo de n enteros en -1 */
+static int *index_table(int n) {
+    int *table = malloc((n > 0 ? n : 1) * sizeof(int));
+    for (int k = 0; k < n; k++) table[k] = -1;
+    return table;
+}
+
+// =============================
+// Slots
+// =============================
+
+/* Los parámetros ocupan los primeros slots, en orden; lo demás va después */
+static void assign_slot(BcCompiler *c, IROperand v) {
+    int k = ir_value_index(&c->range, v);
+    if (k < 0 || c->slots[k] >= 0) return;
+    Symbol *sym = ir_symbol(c->ctx, v);
+    if (sym && sym->is_param) c->slots[k] = sym->param_index;
+    else c->slots[k] = c->slot_count++;
+}
+
+static void assign_slots(BcCompiler *c, IRList *list, int start, int end) {
+    IROperand uses[2];
+    for (int i = start; i < end; i++) {
+        IRCode *code = &list->codes[i];
+        int n = ir_uses(code, uses);
+        for (int k = 0; k < n; k++) assign_slot(c, uses[k]);
+        assign_slot(c, ir_def(code));
+        if (code->op == IR_DECL) assign_slot(c, code->result);
+    }
+}
+
+static int slot_of(BcCompiler *c, IROperand v) {
+    return c->slots[ir_value_index(&c->range, v)];
+}
+
+static int scratch(BcCompiler *c) {
+    int slot = c->slot_count + c->scratch_used++;
+    if (c->scratch_used > c->scratch_max) c->scratch_max = c->scratch_used;
+    return slot;
+}
+
+/* Slot con el valor de v: las globales se copian antes a uno de paso */
+static int src(BcCompiler *c, IROperand v) {
+    if (v.kind == IRO_GLOBAL) {
+        int slot = scratch(c);
+        emit(c, BC_LOADG, slot, global_index(c, v), 0);
+        return slot;
+    }
+    return slot_of(c, v);
+}
+
+/* Slot donde escribir v; si es global, store() lo copia después a su lugar */
+static int dst(BcCompiler *c, IROperand v) {
+    if (v.kind == IRO_GLOBAL) return scratch(c);
+    return slot_of(c, v);
+}
+
+static void store(BcCompiler *c, IROperand v, int slot) {
+    if (v.kind == IRO_GLOBAL) emit(c, BC_STOREG, global_index(c, v), slot, 0);
+}
+
+// =============================
+// Instrucciones
+// =============================
+
+static void emit_jump(BcCompiler *c, BcOp op, int a, int b, IROperand label) {
+    if (c->fixup_count == c->fixup_capacity) {
+        c->fixup_capacity = c->fixup_capacity ? c->fixup_capacity * 2 : 64;
+        c->fixups = realloc(c->fixups, c->fixup_capacity * sizeof(Fixup));
+    }
+    c->fixups[c->fixup_count++] = (Fixup){ emit(c, op, a, b, 0), label };
+}
+
+static void emit_move(BcCompiler *c, IROperand from, IROperand to) {
+    if (to.kind == IRO_GLOBAL) {
+        emit(c, BC_STOREG, global_index(c, to), src(c, from), 0);
+    } else if (from.kind == IRO_GLOBAL) {
+        emit(c, BC_LOADG, dst(c, to), global_index(c, from), 0);
+    } else {
+        int a = dst(c, to), b = src(c, from);
+        if (a != b) emit(c, BC_MOV, a, b, 0);
+    }
+}
+
+static void emit_binary(BcCompiler *c, BcOp op, IRCode *code) {
+    int b = src(c, code->arg1);
+    int cc = src(c, code->arg2);
+    int a = dst(c, code->result);
+    emit(c, op, a, b, cc);
+    store(c, code->result, a);
+}
+
+static void emit_unary(BcCompiler *c, BcOp op, IRCode *code) {
+    int b = src(c, code->arg1);
+    int a = dst(c, code->result);
+    emit(c, op, a, b, 0);
+    store(c, code->result, a);
+}
+
+/* Como generateCall: los argumentos son los últimos param_count IR_PARAM pendientes */
+static void emit_call(BcCompiler *c, IRCode *code) {
+    int n = ir_symbol(c->ctx, code->arg1)->param_count;
+    PendingArg *args = &c->pending[c->pending_count - n];
+    c->pending_count -= n;
+
+    int small[12];
+    int *ordered = n <= 12 ? small : malloc(n * sizeof(int));
+    for (int k = 0; k < n; k++) ordered[args[k].index] = src(c, args[k].value);
+
+    BcOp op = BC_CALL;
+    int callee = c->functions[code->arg1.id];
+    if (callee < 0) {
+        op = BC_CALLX;
+        callee = extern_index(c, code->arg1);
+    }
+    int a = ir_has(code->result) ? dst(c, code->result) : -1;
+    emit(c, op, a, callee, n);
+    for (int k = 0; k < n; k += 3)
+        emit(c, BC_ARGS, ordered[k], k + 1 < n ? ordered[k + 1] : -1, k + 2 < n ? ordered[k + 2] : -1);
+    if (ir_has(code->result)) store(c, code->result, a);
+    if (ordered != small) free(ordered);
+}
+
+static void compile_instruction(BcCompiler *c, IRCode *code) {
+    c->scratch_used = 0;
+    switch (code->op) {
+        case IR_LOAD:
+        case IR_STORE:
+            emit_move(c, code->arg1, code->result);
+            break;
+        case IR_STORAGE: {
+            int a = dst(c, code->result);
+            emit(c, BC_LOADI, a, code->arg1.id, 0);
+            store(c, code->result, a);
+            break;
+        }
+
+        case IR_ADD: emit_binary(c, BC_ADD, code); break;
+        case IR_SUB: emit_binary(c, BC_SUB, code); break;
+        case IR_MUL: emit_binary(c, BC_MUL, code); break;
+        case IR_DIV: emit_binary(c, BC_DIV, code); break;
+        case IR_MOD: emit_binary(c, BC_MOD, code); break;
+        case IR_AND: emit_binary(c, BC_AND, code); break;
+        case IR_OR:  emit_binary(c, BC_OR, code); break;
+        case IR_EQ:  emit_binary(c, BC_EQ, code); break;
+        case IR_NEQ: emit_binary(c, BC_NEQ, code); break;
+        case IR_LT:  emit_binary(c, BC_LT, code); break;
+        case IR_LE:  emit_binary(c, BC_LE, code); break;
+        case IR_GT:  emit_binary(c, BC_GT, code); break;
+        case IR_GE:  emit_binary(c, BC_GE, code); break;
+        case IR_UMINUS: emit_unary(c, BC_NEG, code); break;
+        case IR_NOT:    emit_unary(c, BC_NOT, code); break;
+
+        case IR_LABEL:
+            c->labels[code->result.id - c->label_base] = c->prog->code_size;
+            break;
+        case IR_GOTO:
+            if (ir_has(code->arg1)) emit_jump(c, BC_JNOT, src(c, code->arg1), 0, code->result);
+            else emit_jump(c, BC_JMP, 0, 0, code->result);
+            break;
+        case IR_JEQ: case IR_JNE: case IR_JLT: case IR_JLE: case IR_JGT: case IR_JGE: {
+            int a = src(c, code->arg1);
+            int b = src(c, code->arg2);
+            emit_jump(c, BC_JEQ + (code->op - IR_JEQ), a, b, code->result);
+            break;
+        }
+
+        case IR_PARAM:
+            if (c->pending_count == c->pending_capacity) {
+                c->pending_capacity = c->pending_capacity ? c->pending_capacity * 2 : 16;
+                c->pending = realloc(c->pending, c->pending_capacity * sizeof(PendingArg));
+            }
+            c->pending[c->pending_count++] = (PendingArg){ code->arg1, code->arg2.id };
+            break;
+        case IR_CALL:
+            emit_call(c, code);
+            break;
+
+        case IR_RETURN:
+            emit(c, BC_RET, ir_has(code->arg1) ? src(c, code->arg1) : -1, 0, 0);
+            break;
+        case IR_FMETHOD:
+            // Fin del método: un void que llega hasta acá devuelve 0
+            emit(c, BC_RET, -1, 0, 0);
+            break;
+
+        default:
+            // IR_DECL de locales, IR_SAVE_PARAM (los argumentos ya llegan a
+            // su slot), IR_NOP y lo que no es del método
+            break;
+    }
+}
+
+/* Los saltos apuntan al índice de la instrucción de la etiqueta */
+static void resolve_jumps(BcCompiler *c) {
+    for (int i = 0; i < c->fixup_count; i++) {
+        BcInstr *instr = &c->prog->code[c->fixups[i].instr];
+        int target = c->labels[c->fixups[i].label.id - c->label_base];
+        if (target < 0) target = 0;
+        if (instr->op == BC_JMP) instr->a = target;
+        else if (instr->op == BC_JNOT) instr->b = target;
+        else instr->c = target;
+    }
+    c->fixup_count = 0;
+}
+
+/* Las etiquetas de un método tienen ids distintos y casi contiguos (Units.h) */
+static int *label_table(IRList *list, int start, int end, int *base) {
+    int lo = 0, hi = -1;
+    for (int i = start; i < end; i++) {
+        IROperand l = list->codes[i].result;
+        if (l.kind != IRO_LABEL) continue;
+        if (hi < lo) lo = hi = l.id;
+        else if (l.id < lo) lo = l.id;
+        else if (l.id > hi) hi = l.id;
+    }
+    *base = lo;
+    return index_table(hi - lo + 1);
+}
+
+static void compile_method(BcCompiler *c, IRList *list, int start, int end) {
+    Symbol *method = ir_symbol(c->ctx, list->codes[start].result);
+    int index = c->functions[list->codes[start].result.id];
+
+    ir_value_range(list, start, end - 1, &c->range);
+    c->slots = index_table(ir_value_count(&c->range));
+    c->labels = label_table(list, start, end, &c->label_base);
+    c->slot_count = method->param_count;
+    c->scratch_max = 0;
+    c->pending_count = 0;
+    assign_slots(c, list, start, end);
+
+    int entry = c->prog->code_size;
+    for (int i = start + 1; i < end; i++) compile_instruction(c, &list->codes[i]);
+    resolve_jumps(c);
+    free(c->slots);
+    free(c->labels);
+
+    BcFunction *f = &c->prog->functions[index];
+    f->entry = entry;
+    f->frame_size = c->slot_count + c->scratch_max;
+}
+
+void bc_compile(CompilerContext *ctx, IRList *list, BcProgram *prog) {
+    memset(prog, 0, sizeof(*prog));
+    prog->main_function = -1;
+
+    BcCompiler c = { .ctx = ctx, .prog = prog };
+    c.functions = index_table(ctx->ir_methods.count);
+    c.externs = index_table(ctx->ir_methods.count);
+    c.globals = index_table(ctx->ir_globals.count);
+
+    // Primero las tablas: una llamada puede ir a un método que está más abajo
+    for (int i = 0; i < list->size; i++) {
+        IRCode *code = &list->codes[i];
+        if (code->op == IR_DECL && code->result.kind == IRO_GLOBAL && c.globals[code->result.id] < 0)
+            add_global(&c, code->result, ir_has(code->arg1) ? code->arg1.id : 0);
+        else if (code->op == IR_METH_EXT)
+            extern_index(&c, code->result);
+        else if (code->op == IR_METHOD)
+            add_function(&c, code->result);
+    }
+
+    // Cada método va desde su IR_METHOD hasta el siguiente
+    int start = -1;
+    for (int i = 0; i <= list->size; i++) {
+        if (i < list->size && list->codes[i].op != IR_METHOD) continue;
+        if (start >= 0) compile_method(&c, list, start, i);
+        start = i;
+    }
+
+    free(c.functions);
+    free(c.externs);
+    free(c.globals);
+    free(c.fixups);
+    free(c.pending);
+}
+
+void bc_free(BcProgram *prog) {
+    for (int i = 0; i < prog->function_count; i++) free(prog->functions[i].name);
+    for (int i = 0; i < prog->extern_count; i++) free(prog->externs[i]);
+    free(prog->functions);
+    free(prog->externs);
+    free(prog->globals);
+    free(prog->code);
+    memset(prog, 0, sizeof(*prog));
+    prog->main_function = -1;
+}
+
+// =============================
+// Operandos
+// =============================
+
+typedef enum {
+    OPND_NONE,
+    OPND_SLOT,
+    OPND_SLOT_OPT,      // slot o -1
+    OPND_IMM,
+    OPND_GLOBAL,
+    OPND_TARGET,
+    OPND_FUNCTION,
+    OPND_EXTERN,
+    OPND_COUNT          // cantidad de argumentos
+} Operand;
+
+static const struct {
+    const char *name;
+    unsigned char operands[3];
+} op_info[BC_OP_COUNT] = {
+    [BC_NOP]    = { "nop",    { OPND_NONE, OPND_NONE, OPND_NONE } },
+    [BC_MOV]    = { "mov",    { OPND_SLOT, OPND_SLOT, OPND_NONE } },
+    [BC_LOADI]  = { "loadi",  { OPND_SLOT, OPND_IMM, OPND_NONE } },
+    [BC_LOADG]  = { "loadg",  { OPND_SLOT, OPND_GLOBAL, OPND_NONE } },
+    [BC_STOREG] = { "storeg", { OPND_GLOBAL, OPND_SLOT, OPND_NONE } },
+    [BC_ADD]    = { "add",    { OPND_SLOT, OPND_SLOT, OPND_SLOT } },
+    [BC_SUB]    = { "sub",    { OPND_SLOT, OPND_SLOT, OPND_SLOT } },
+    [BC_MUL]    = { "mul",    { OPND_SLOT, OPND_SLOT, OPND_SLOT } },
+    [BC_DIV]    = { "div",    { OPND_SLOT, OPND_SLOT, OPND_SLOT } },
+    [BC_MOD]    = { "mod",    { OPND_SLOT, OPND_SLOT, OPND_SLOT } },
+    [BC_NEG]    = { "neg",    { OPND_SLOT, OPND_SLOT, OPND_NONE } },
+    [BC_NOT]    = { "not",    { OPND_SLOT, OPND_SLOT, OPND_NONE } },
+    [BC_AND]    = { "and",    { OPND_SLOT, OPND_SLOT, OPND_SLOT } },
+    [BC_OR]     = { "or",     { OPND_SLOT, OPND_SLOT, OPND_SLOT } },
+    [BC_EQ]     = { "eq",     { OPND_SLOT, OPND_SLOT, OPND_SLOT } },
+    [BC_NEQ]    = { "neq",    { OPND_SLOT, OPND_SLOT, OPND_SLOT } },
+    [BC_LT]     = { "lt",     { OPND_SLOT, OPND_SLOT, OPND_SLOT } },
+    [BC_LE]     = { "le",     { OPND_SLOT, OPND_SLOT, OPND_SLOT } },
+    [BC_GT]     = { "gt",     { OPND_SLOT, OPND_SLOT, OPND_SLOT } },
+    [BC_GE]     = { "ge",     { OPND_SLOT, OPND_SLOT, OPND_SLOT } },
+    [BC_JMP]    = { "jmp",    { OPND_TARGET, OPND_NONE, OPND_NONE } },
+    [BC_JNOT]   = { "jnot",   { OPND_SLOT, OPND_TARGET, OPND_NONE } },
+    [BC_JEQ]    = { "jeq",    { OPND_SLOT, OPND_SLOT, OPND_TARGET } },
+    [BC_JNE]    = { "jne",    { OPND_SLOT, OPND_SLOT, OPND_TARGET } },
+    [BC_JLT]    = { "jlt",    { OPND_SLOT, OPND_SLOT, OPND_TARGET } },
+    [BC_JLE]    = { "jle",    { OPND_SLOT, OPND_SLOT, OPND_TARGET } },
+    [BC_JGT]    = { "jgt",    { OPND_SLOT, OPND_SLOT, OPND_TARGET } },
+    [BC_JGE]    = { "jge",    { OPND_SLOT, OPND_SLOT, OPND_TARGET } },
+    [BC_CALL]   = { "call",   { OPND_SLOT_OPT, OPND_FUNCTION, OPND_COUNT } },
+    [BC_CALLX]  = { "callx",  { OPND_SLOT_OPT, OPND_EXTERN, OPND_COUNT } },
+    [BC_ARGS]   = { "args",   { OPND_SLOT_OPT, OPND_SLOT_OPT, OPND_SLOT_OPT } },
+    [BC_RET]    = { "ret",    { OPND_SLOT_OPT, OPND_NONE, OPND_NONE } },
+};
+
+static void print_operand(const BcProgram *prog, Operand kind, int value, FILE *out) {
+    switch (kind) {
+        case OPND_SLOT:
+        case OPND_SLOT_OPT:
+            if (value < 0) fprintf(out, " -");
+            else fprintf(out, " r%d", value);
+            break;
+        case OPND_IMM:      fprintf(out, " #%d", value); break;
+        case OPND_GLOBAL:   fprintf(out, " g%d", value); break;
+        case OPND_TARGET:   fprintf(out, " @%d", value); break;
+        case OPND_FUNCTION: fprintf(out, " %s", prog->functions[value].name); break;
+        case OPND_EXTERN:   fprintf(out, " %s", prog->externs[value]); break;
+        case OPND_COUNT:    fprintf(out, " (%d)", value); break;
+        default: break;
+    }
+}
+
+void bc_print(const BcProgram *prog, FILE *out) {
+    fprintf(out, "Bytecode: %d instrucciones, %d métodos, %d globales, %d externos\n",
+            prog->code_size, prog->function_count, prog->global_count, prog->extern_count);
+    for (int g = 0; g < prog->global_count; g++)
+        fprintf(out, "  g%d = %ld\n", g, prog->globals[g]);
+
+    int next = 0;
+    for (int pc = 0; pc < prog->code_size; pc++) {
+        for (; next < prog->function_count && prog->functions[next].entry == pc; next++) {
+            const BcFunction *f = &prog->functions[next];
+            fprintf(out, "%s: (%d parámetros, %d slots)\n", f->name, f->param_count, f->frame_size);
+        }
+        const BcInstr *instr = &prog->code[pc];
+        fprintf(out, "  %5d  %-7s", pc, op_info[instr->op].name);
+        int fields[3] = { instr->a, instr->b, instr->c };
+        for (int k = 0; k < 3; k++) print_operand(prog, op_info[instr->op].operands[k], fields[k], out);
+        fputc('\n', out);
+    }
+}
+
+// =============================
+// Caché en disco
+// =============================
+
+/* FNV-1a de 64 bits */
+static uint64_t fnv1a(uint64_t hash, const void *data, size_t size) {
+    const unsigned char *bytes = data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+uint64_t bc_source_hash(const char *source, size_t size, const char *optimization) {
+    uint64_t hash = 14695981039346656037ULL;
+    int version = BC_VERSION;
+    hash = fnv1a(hash, source, size);
+    hash = fnv1a(hash, "", 1);
+    if (optimization) hash = fnv1a(hash, optimization, strlen(optimization));
+    return fnv1a(hash, &version, sizeof(version));
+}
+
+static bool write_string(FILE *f, const char *s) {
+    int32_t len = (int32_t)strlen(s);
+    return fwrite(&len, sizeof(len), 1, f) == 1 && fwrite(s, 1, len, f) == (size_t)len;
+}
+
+static char *read_string(FILE *f) {
+    int32_t len;
+    if (fread(&len, sizeof(len), 1, f) != 1 || len < 0 || len > 4096) return NULL;
+    char *s = malloc(len + 1);
+    if (!s) return NULL;
+    if (fread(s, 1, len, f) != (size_t)len) {
+        free(s);
+        return NULL;
+    }
+    s[len] = '\0';
+    return s;
+}
+
+/*
+ * Formato (enteros en el orden de bytes de la máquina: es un caché local):
+ *   "TDSB", versión, hash, code_size, function_count, main_function,
+ *   global_count, extern_count; por método entry, frame_size, param_count y
+ *   nombre; los valores de las globales; los nombres de los externos; el código.
+ * Los strings van como largo (int32) y bytes.
+ */
+bool bc_save(const BcProgram *prog, uint64_t hash, const char *path) {
+    char tmp[4096];
+    snprintf(tmp, sizeof(tmp), "%s.%ld.tmp", path, (long)getpid());
+    FILE *f = fopen(tmp, "wb");
+    if (!f) return false;
+
+    int32_t header[6] = { BC_VERSION, prog->code_size, prog->function_count, prog->main_function,
+                          prog->global_count, prog->extern_count };
+    bool ok = fwrite(BC_MAGIC, 1, 4, f) == 4
+           && fwrite(header, sizeof(int32_t), 1, f) == 1
+           && fwrite(&hash, sizeof(hash), 1, f) == 1
+           && fwrite(&header[1], sizeof(int32_t), 5, f) == 5;
+    for (int i = 0; ok && i < prog->function_count; i++) {
+        const BcFunction *fn = &prog->functions[i];
+        int32_t fields[3] = { fn->entry, fn->frame_size, fn->param_count };
+        ok = fwrite(fields, sizeof(int32_t), 3, f) == 3 && write_string(f, fn->name);
+    }
+    for (int i = 0; ok && i < prog->global_count; i++) {
+        int64_t value = prog->globals[i];
+        ok = fwrite(&value, sizeof(value), 1, f) == 1;
+    }
+    for (int i = 0; ok && i < prog->extern_count; i++) ok = write_string(f, prog->externs[i]);
+    if (ok) ok = fwrite(prog->code, sizeof(BcInstr), prog->code_size, f) == (size_t)prog->code_size;
+
+    if (fclose(f) != 0) ok = false;
+    if (ok && rename(tmp, path) != 0) ok = false;
+    if (!ok) remove(tmp);
+    return ok;
+}
+
+static bool valid_operand(const BcProgram *prog, Operand kind, int value, int frame_size) {
+    switch (kind) {
+        case OPND_SLOT:     return value >= 0 && value < frame_size;
+        case OPND_SLOT_OPT: return value >= -1 && value < frame_size;
+        case OPND_GLOBAL:   return value >= 0 && value < prog->global_count;
+        case OPND_TARGET:   return value >= 0 && value < prog->code_size;
+        case OPND_FUNCTION: return value >= 0 && value < prog->function_count;
+        case OPND_EXTERN:   return value >= 0 && value < prog->extern_count;
+        case OPND_COUNT:    return value >= 0;
+        default:            return true;
+    }
+}
+
+/*
+ * La VM no revisa los operandos al ejecutar: un archivo del caché se usa solo
+ * si cada método está entero en su rango, termina en un salto o un return y
+ * todos sus operandos están dentro de su marco y de las tablas.
+ */
+static bool verify(const BcProgram *prog) {
+    if (prog->main_function < -1 || prog->main_function >= prog->function_count) return false;
+    for (int i = 0; i < prog->function_count; i++) {
+        const BcFunction *fn = &prog->functions[i];
+        int end = i + 1 < prog->function_count ? prog->functions[i + 1].entry : prog->code_size;
+        if (fn->entry < 0 || fn->entry >= end || end > prog->code_size) return false;
+        if (fn->param_count < 0 || fn->frame_size < fn->param_count) return false;
+
+        for (int pc = fn->entry; pc < end; pc++) {
+            const BcInstr *instr = &prog->code[pc];
+            if (instr->op < 0 || instr->op >= BC_OP_COUNT || instr->op == BC_ARGS) return false;
+            int fields[3] = { instr->a, instr->b, instr->c };
+            for (int k = 0; k < 3; k++)
+                if (!valid_operand(prog, op_info[instr->op].operands[k], fields[k], fn->frame_size)) return false;
+            if (instr->op != BC_CALL && instr->op != BC_CALLX) continue;
+
+            int words = (instr->c + 2) / 3;
+            if (pc + words >= end) return false;
+            if (instr->op == BC_CALL && prog->functions[instr->b].param_count != instr->c) return false;
+            for (int w = 1; w <= words; w++) {
+                const BcInstr *args = &instr[w];
+                int last = instr->c - 3 * (w - 1);      // argumentos en esta palabra, hasta 3
+                if (args->op != BC_ARGS
+                    || !valid_operand(prog, OPND_SLOT, args->a, fn->frame_size)
+                    || !valid_operand(prog, last > 1 ? OPND_SLOT : OPND_SLOT_OPT, args->b, fn->frame_size)
+                    || !valid_operand(prog, last > 2 ? OPND_SLOT : OPND_SLOT_OPT, args->c, fn->frame_size))
+                    return false;
+            }
+            pc += words;
+        }
+        BcOp last = prog->code[end - 1].op;
+        if (last != BC_RET && last != BC_JMP) return false;
+    }
+    return true;
+}
+
+/* Bytes que quedan en 'f' desde la posición actual, o -1 si no se puede saber */
+static long remaining_bytes(FILE *f) {
+    long here = ftell(f);
+    if (here < 0 || fseek(f, 0, SEEK_END) != 0) return -1;
+    long end = ftell(f);
+    if (fseek(f, here, SEEK_SET) != 0) return -1;
+    return end - here;
+}
+
+/*
+ * Lo mínimo que ocupa lo que anuncia el encabezado (los strings vacíos). Los
+ * tamaños de las tablas salen del archivo: si no entran en lo que queda de
+ * él, está truncado o roto y no se reserva nada.
+ */
+static bool counts_fit(const int32_t counts[5], long remaining) {
+    int64_t needed = (int64_t)counts[1] * (4 * sizeof(int32_t))
+                   + (int64_t)counts[3] * sizeof(int64_t)
+                   + (int64_t)counts[4] * sizeof(int32_t)
+                   + (int64_t)counts[0] * sizeof(BcInstr);
+    return remaining >= 0 && needed <= remaining;
+}
+
+bool bc_load(BcProgram *prog, uint64_t hash, const char *path) {
+    memset(prog, 0, sizeof(*prog));
+    prog->main_function = -1;
+    FILE *f = fopen(path, "rb");
+    if (!f) return false;
+
+    char magic[4];
+    int32_t version, counts[5];
+    uint64_t stored;
+    bool ok = fread(magic, 1, 4, f) == 4 && memcmp(magic, BC_MAGIC, 4) == 0
+           && fread(&version, sizeof(version), 1, f) == 1 && version == BC_VERSION
+           && fread(&stored, sizeof(stored), 1, f) == 1 && stored == hash
+           && fread(counts, sizeof(int32_t), 5, f) == 5
+           && counts[0] >= 0 && counts[1] >= 0 && counts[3] >= 0 && counts[4] >= 0
+           && counts_fit(counts, remaining_bytes(f));
+    if (!ok) {
+        fclose(f);
+        return false;
+    }
+
+    prog->main_function = counts[2];
+    prog->functions = calloc(counts[1] ? counts[1] : 1, sizeof(BcFunction));
+    prog->globals = calloc(counts[3] ? counts[3] : 1, sizeof(long));
+    prog->externs = calloc(counts[4] ? counts[4] : 1, sizeof(char *));
+    prog->code = malloc((counts[0] ? counts[0] : 1) * sizeof(BcInstr));
+    ok = prog->functions && prog->globals && prog->externs && prog->code;
+
+    // Los contadores avanzan solo con lo que se leyó entero: bc_free libera eso
+    while (ok && prog->function_count < counts[1]) {
+        BcFunction *fn = &prog->functions[prog->function_count];
+        int32_t fields[3];
+        ok = fread(fields, sizeof(int32_t), 3, f) == 3 && (fn->name = read_string(f)) != NULL;
+        if (!ok) break;
+        fn->entry = fields[0];
+        fn->frame_size = fields[1];
+        fn->param_count = fields[2];
+        prog->function_count++;
+    }
+    while (ok && prog->global_count < counts[3]) {
+        int64_t value;
+        ok = fread(&value, sizeof(value), 1, f) == 1;
+        if (ok) prog->globals[prog->global_count++] = value;
+    }
+    while (ok && prog->extern_count < counts[4]) {
+        ok = (prog->externs[prog->extern_count] = read_string(f)) != NULL;
+        if (ok) prog->extern_count++;
+    }
+    if (ok) {
+        prog->code_size = counts[0];
+        ok = fread(prog->code, sizeof(BcInstr), counts[0], f) == (size_t)counts[0] && fgetc(f) == EOF;
+    }
+    fclose(f);
+
+    if (!ok || !verify(prog)) {
+        bc_free(prog);
+        return false;
+    }
+    return true;
+}
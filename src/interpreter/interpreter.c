@@ -0,0 +1,335 @@
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <string.h>
+#include <pthread.h>
+#include "Interpreter.h"
+#include "SymbolMap.h"
+#include "Runtime.h"
+
+// Cada llamada del programa anida varias del intérprete: corre en un hilo con pila grande
+#define INTERP_STACK_BYTES  (256L << 20)
+#define MAX_CALL_DEPTH      100000
+
+typedef enum {
+    EXEC_NEXT,          // sigue con la próxima sentencia
+    EXEC_RETURN,        // return: el valor queda en Interpreter.ret
+    EXEC_ABORT          // error de ejecución: se desarma todo hasta interpret
+} ExecResult;
+
+typedef struct {
+    CompilerContext *ctx;
+
+    SymbolMap globals;          // global -> índice en global_values
+    long *global_values;
+    int global_count;
+
+    // Marcos de las llamadas, uno arriba del otro. Se accede por índice
+    // porque el arreglo puede moverse al crecer.
+    long *stack;
+    int stack_top;
+    int stack_capacity;
+    int frame;                  // base del marco actual
+    int frame_regs;             // slots de parámetros por registro + locales del método actual
+    int depth;
+
+    long ret;
+    bool aborted;
+    int status;
+} Interpreter;
+
+static ExecResult exec(Interpreter *in, Tree *node);
+static long eval(Interpreter *in, Tree *node);
+
+/* Informa el error y corta la ejecución con 'status' */
+static void abort_run(Interpreter *in, int status, int line, const char *fmt, ...) {
+    if (in->aborted) return;
+    va_list ap;
+    va_start(ap, fmt);
+    runtime_verror(in->ctx->err, line, fmt, ap);
+    va_end(ap);
+    in->aborted = true;
+    in->status = status;
+}
+
+// =============================
+// Variables
+// =============================
+
+/*
+ * calculate_offsets deja los 6 primeros parámetros y las locales en -8, -16,
+ * ... y los parámetros 7 en adelante en 16, 24, ...: en el marco van primero
+ * los negativos, en orden, y después los positivos.
+ */
+static int slot_of(Symbol *var, int frame_regs) {
+    if (var->offset < 0) return -var->offset / 8 - 1;
+    return frame_regs + (var->offset - 16) / 8;
+}
+
+static long *var_ref(Interpreter *in, Symbol *var) {
+    if (var->is_global) {
+        int index = 0;
+        symmap_get(&in->globals, var, &index);
+        return &in->global_values[index];
+    }
+    return &in->stack[in->frame + slot_of(var, in->frame_regs)];
+}
+
+static int push_frame(Interpreter *in, int size) {
+    if (in->stack_top + size > in->stack_capacity) {
+        while (in->stack_top + size > in->stack_capacity)
+            in->stack_capacity = in->stack_capacity ? in->stack_capacity * 2 : 1024;
+        in->stack = realloc(in->stack, in->stack_capacity * sizeof(long));
+    }
+    int base = in->stack_top;
+    memset(&in->stack[base], 0, size * sizeof(long));
+    in->stack_top += size;
+    return base;
+}
+
+// =============================
+// Llamadas
+// =============================
+
+/* Los argumentos se evalúan de derecha a izquierda, como en el código generado */
+static void eval_args(Interpreter *in, Tree *list, long *values, int index) {
+    if (!list) return;
+    eval_args(in, list->right, values, index + 1);
+    values[index] = eval(in, list->left);
+}
+
+static int count_args(Tree *list) {
+    int n = 0;
+    for (; list; list = list->right) n++;
+    return n;
+}
+
+static long call_extern(Interpreter *in, Symbol *method, Tree *args, int line) {
+    int argc = count_args(args);
+    if (argc > EXTERN_MAX_ARGS) {
+        abort_run(in, 1, line, "el método externo '%s' tiene más de %d argumentos", method->name, EXTERN_MAX_ARGS);
+        return 0;
+    }
+    ExternFn fn = runtime_resolve(method->name);
+    if (!fn) {
+        abort_run(in, 1, line, "el método externo '%s' no está disponible", method->name);
+        return 0;
+    }
+    long values[EXTERN_MAX_ARGS] = { 0 };
+    eval_args(in, args, values, 0);
+    if (in->aborted) return 0;
+    return fn(values[0], values[1], values[2], values[3], values[4], values[5]);
+}
+
+static long call_method(Interpreter *in, Tree *call) {
+    Symbol *method = call->sym;
+    Tree *decl = method->node;
+    Tree *args = call->right ? call->right->left : NULL;
+    if (!decl->right) return call_extern(in, method, args, call->lineno);
+
+    if (in->depth >= MAX_CALL_DEPTH) {
+        abort_run(in, 1, call->lineno, "más de %d llamadas anidadas", MAX_CALL_DEPTH);
+        return 0;
+    }
+
+    int regs = method->total_stack_space / 8;
+    int stack_params = method->param_count > 6 ? method->param_count - 6 : 0;
+    int argc = count_args(args);
+    long small[8];
+    long *values = argc <= 8 ? small : malloc(argc * sizeof(long));
+    eval_args(in, args, values, 0);
+    if (in->aborted) {
+        if (values != small) free(values);
+        return 0;
+    }
+
+    // Los argumentos se evaluaron en el marco del que llama; recién ahora se apila el nuevo
+    int base = push_frame(in, regs + stack_params);
+    for (int i = 0; i < argc && i < method->param_count; i++)
+        in->stack[base + (i < 6 ? i : regs + i - 6)] = values[i];
+    if (values != small) free(values);
+
+    int saved_frame = in->frame, saved_regs = in->frame_regs;
+    in->frame = base;
+    in->frame_regs = regs;
+    in->depth++;
+    ExecResult result = exec(in, decl->right);
+    in->depth--;
+    in->frame = saved_frame;
+    in->frame_regs = saved_regs;
+    in->stack_top = base;
+
+    return result == EXEC_RETURN ? in->ret : 0;
+}
+
+// =============================
+// Expresiones
+// =============================
+
+static long eval(Interpreter *in, Tree *node) {
+    if (!node) return 0;
+    switch (node->tipo) {
+        case NODE_INT:    return node->sym->valor.value;
+        case NODE_TRUE:   return 1;
+        case NODE_FALSE:  return 0;
+        case NODE_ID:     return *var_ref(in, node->sym);
+        case NODE_PARENS: return eval(in, node->left);
+
+        case NODE_SUM: { long l = eval(in, node->left); return WRAP(+, l, eval(in, node->right)); }
+        case NODE_RES: { long l = eval(in, node->left); return WRAP(-, l, eval(in, node->right)); }
+        case NODE_MUL: { long l = eval(in, node->left); return WRAP(*, l, eval(in, node->right)); }
+        case NODE_UMINUS: return WRAP(-, 0, eval(in, node->left));
+
+        case NODE_DIV:
+        case NODE_MOD: {
+            long l = eval(in, node->left);
+            long r = eval(in, node->right);
+            if (r == 0) {
+                abort_run(in, EXIT_DIV_ZERO, node->lineno, "%s por cero",
+                              node->tipo == NODE_DIV ? "división" : "módulo");
+                return 0;
+            }
+            return node->tipo == NODE_DIV ? l / r : l % r;
+        }
+
+        case NODE_NOT: return !eval(in, node->left);
+        case NODE_AND: return eval(in, node->left) && eval(in, node->right);
+        case NODE_OR:  return eval(in, node->left) || eval(in, node->right);
+
+        case NODE_EQ:  { long l = eval(in, node->left); return l == eval(in, node->right); }
+        case NODE_NEQ: { long l = eval(in, node->left); return l != eval(in, node->right); }
+        case NODE_LT:  { long l = eval(in, node->left); return l <  eval(in, node->right); }
+        case NODE_GT:  { long l = eval(in, node->left); return l >  eval(in, node->right); }
+        case NODE_LE:  { long l = eval(in, node->left); return l <= eval(in, node->right); }
+        case NODE_GE:  { long l = eval(in, node->left); return l >= eval(in, node->right); }
+
+        case NODE_METHOD_CALL: return call_method(in, node);
+
+        default:
+            abort_run(in, 1, node->lineno, "expresión no soportada: %s", tipoToStr(node->tipo));
+            return 0;
+    }
+}
+
+// =============================
+// Sentencias
+// =============================
+
+static ExecResult exec(Interpreter *in, Tree *node) {
+    if (!node) return EXEC_NEXT;
+    switch (node->tipo) {
+        case NODE_BLOCK:
+        case NODE_LIST: {
+            ExecResult result = exec(in, node->left);
+            if (result != EXEC_NEXT) return result;
+            return exec(in, node->right);
+        }
+
+        case NODE_DECLARATION: {
+            // Una local se vuelve a inicializar cada vez que se ejecuta su declaración
+            long value = eval(in, node->right);
+            if (in->aborted) return EXEC_ABORT;
+            *var_ref(in, node->sym) = value;
+            return EXEC_NEXT;
+        }
+
+        case NODE_ASSIGN: {
+            long value = eval(in, node->left);
+            if (in->aborted) return EXEC_ABORT;
+            *var_ref(in, node->sym) = value;
+            return EXEC_NEXT;
+        }
+
+        case NODE_METHOD_CALL:
+            call_method(in, node);
+            return in->aborted ? EXEC_ABORT : EXEC_NEXT;
+
+        case NODE_IF: {
+            long cond = eval(in, node->left);
+            if (in->aborted) return EXEC_ABORT;
+            return cond ? exec(in, node->right) : EXEC_NEXT;
+        }
+
+        case NODE_IF_ELSE: {
+            long cond = eval(in, node->left);
+            if (in->aborted) return EXEC_ABORT;
+            return exec(in, cond ? node->right->left : node->right->right);
+        }
+
+        case NODE_WHILE:
+            for (;;) {
+                long cond = eval(in, node->left);
+                if (in->aborted) return EXEC_ABORT;
+                if (!cond) return EXEC_NEXT;
+                ExecResult result = exec(in, node->right);
+                if (result != EXEC_NEXT) return result;
+            }
+
+        case NODE_RETURN:
+            in->ret = eval(in, node->left);
+            return in->aborted ? EXEC_ABORT : EXEC_RETURN;
+
+        default:
+            abort_run(in, 1, node->lineno, "sentencia no soportada: %s", tipoToStr(node->tipo));
+            return EXEC_ABORT;
+    }
+}
+
+// =============================
+// Programa
+// =============================
+
+/* Las globales toman su valor inicial (un literal); devuelve la declaración de main */
+static Tree *load_program(Interpreter *in, Tree *code) {
+    Tree *main_decl = NULL;
+    for (; code; code = code->right) {
+        Tree *item = code->left;
+        if (!item || !item->sym) continue;
+        if (item->tipo == NODE_DECLARATION) {
+            in->global_values = realloc(in->global_values, (in->global_count + 1) * sizeof(long));
+            in->global_values[in->global_count] = item->right ? eval(in, item->right) : 0;
+            symmap_set(&in->globals, item->sym, in->global_count++);
+        } else if (item->tipo == NODE_METHOD && strcmp(item->sym->name, "main") == 0) {
+            main_decl = item;
+        }
+    }
+    return main_decl;
+}
+
+static void *run_main(void *arg) {
+    Interpreter *in = arg;
+    CompilerContext *prev = context_bind(in->ctx);
+
+    Tree *main_decl = load_program(in, in->ctx->ast_root);
+    if (main_decl) {
+        // main se ejecuta como cualquier llamada sin argumentos
+        Tree call = { NODE_METHOD_CALL, main_decl->sym, NULL, NULL, main_decl->lineno };
+        long value = call_method(in, &call);
+        if (!in->aborted) in->status = main_decl->sym->type == TYPE_VOID ? 0 : (int)value;
+    }
+    fflush(stdout);
+
+    context_bind(prev);
+    return NULL;
+}
+
+int interpret(CompilerContext *ctx) {
+    Interpreter in = { .ctx = ctx };
+    symmap_init(&in.globals);
+
+    pthread_t thread;
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, INTERP_STACK_BYTES);
+    if (pthread_create(&thread, &attr, run_main, &in) == 0) {
+        pthread_join(thread, NULL);
+    } else {
+        run_main(&in);      // sin hilo nuevo: la recursión queda limitada por la pila actual
+    }
+    pthread_attr_destroy(&attr);
+
+    symmap_free(&in.globals);
+    free(in.global_values);
+    free(in.stack);
+    return in.status;
+}
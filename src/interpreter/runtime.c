@@ -0,0 +1,44 @@
+#define _GNU_SOURCE         // RTLD_DEFAULT
+#include <stdio.h>
+#include <string.h>
+#include <dlfcn.h>
+#include "Runtime.h"
+
+// Los internos tienen la misma firma que cualquier externo para llamarlos igual
+
+static long builtin_print_int(long x, long b, long c, long d, long e, long f) {
+    (void)b; (void)c; (void)d; (void)e; (void)f;
+    printf("%d\n", (int)x);
+    return 0;
+}
+
+static long builtin_get_int(long a, long b, long c, long d, long e, long f) {
+    (void)a; (void)b; (void)c; (void)d; (void)e; (void)f;
+    int read;
+    return scanf("%d", &read) == 1 ? read : 0;
+}
+
+ExternFn runtime_resolve(const char *name) {
+    if (strcmp(name, "print_int") == 0) return builtin_print_int;
+    if (strcmp(name, "get_int") == 0) return builtin_get_int;
+
+    void *fn = dlsym(RTLD_DEFAULT, name);
+    ExternFn result;
+    memcpy(&result, &fn, sizeof(result));   // de void * a puntero a función sin warning de ISO C
+    return result;
+}
+
+void runtime_verror(FILE *err, int line, const char *fmt, va_list ap) {
+    fflush(stdout);
+    if (line > 0) fprintf(err, "Error de ejecución en la línea %d: ", line);
+    else fprintf(err, "Error de ejecución: ");
+    vfprintf(err, fmt, ap);
+    fputc('\n', err);
+}
+
+void runtime_error(FILE *err, int line, const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    runtime_verror(err, line, fmt, ap);
+    va_end(ap);
+}
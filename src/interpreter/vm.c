@@ -0,0 +1,216 @@
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Bytecode.h"
+#include "Runtime.h"
+
+#define VM_MAX_CALL_DEPTH   1000000
+
+#if !defined(__GNUC__)
+#error "vm.c usa computed goto (&&etiqueta), una extensión de GCC y clang"
+#endif
+
+typedef struct {
+    const BcInstr *ret;         // instrucción siguiente a la llamada
+    int fp;                     // marco del que llama (índice en la pila)
+    int frame_size;
+    int dst;                    // slot que recibe el resultado, o -1
+} CallRecord;
+
+/* Slot del argumento k de una llamada: van de a tres en las BC_ARGS que la siguen */
+static inline int arg_slot(const BcInstr *call, int k) {
+    const BcInstr *word = &call[1 + k / 3];
+    return k % 3 == 0 ? word->a : k % 3 == 1 ? word->b : word->c;
+}
+
+int vm_run(const BcProgram *prog, FILE *err) {
+    if (prog->main_function < 0) return 0;
+
+    // Cada instrucción salta directo a la siguiente por esta tabla, sin volver
+    // a un switch: un salto indirecto por instrucción que el predictor
+    // distingue según desde qué instrucción se hace
+    static void *const dispatch[BC_OP_COUNT] = {
+        [BC_NOP] = &&op_nop,     [BC_MOV] = &&op_mov,     [BC_LOADI] = &&op_loadi,
+        [BC_LOADG] = &&op_loadg, [BC_STOREG] = &&op_storeg,
+        [BC_ADD] = &&op_add,     [BC_SUB] = &&op_sub,     [BC_MUL] = &&op_mul,
+        [BC_DIV] = &&op_div,     [BC_MOD] = &&op_mod,     [BC_NEG] = &&op_neg,
+        [BC_NOT] = &&op_not,     [BC_AND] = &&op_and,     [BC_OR] = &&op_or,
+        [BC_EQ] = &&op_eq,       [BC_NEQ] = &&op_neq,     [BC_LT] = &&op_lt,
+        [BC_LE] = &&op_le,       [BC_GT] = &&op_gt,       [BC_GE] = &&op_ge,
+        [BC_JMP] = &&op_jmp,     [BC_JNOT] = &&op_jnot,
+        [BC_JEQ] = &&op_jeq,     [BC_JNE] = &&op_jne,     [BC_JLT] = &&op_jlt,
+        [BC_JLE] = &&op_jle,     [BC_JGT] = &&op_jgt,     [BC_JGE] = &&op_jge,
+        [BC_CALL] = &&op_call,   [BC_CALLX] = &&op_callx, [BC_ARGS] = &&op_nop,
+        [BC_RET] = &&op_ret,
+    };
+
+    const BcInstr *code = prog->code;
+    long *globals = malloc((prog->global_count ? prog->global_count : 1) * sizeof(long));
+    ExternFn *externs = calloc(prog->extern_count ? prog->extern_count : 1, sizeof(ExternFn));
+
+    // Los marcos van uno arriba del otro; al crecer la pila se mueve y fp se recalcula
+    const BcFunction *main_fn = &prog->functions[prog->main_function];
+    int stack_capacity = 4096;
+    while (stack_capacity < main_fn->frame_size) stack_capacity *= 2;
+    long *stack = calloc(stack_capacity, sizeof(long));
+    long *fp = stack;
+    int frame_size = main_fn->frame_size;
+    CallRecord *calls = NULL;
+    int depth = 0, calls_capacity = 0;
+    int status = 0;
+    if (!globals || !externs || !stack) {
+        free(stack);
+        free(externs);
+        free(globals);
+        runtime_error(err, 0, "no hay memoria para el programa");
+        return 1;
+    }
+    memcpy(globals, prog->globals, prog->global_count * sizeof(long));
+    for (int i = 0; i < prog->extern_count; i++) externs[i] = runtime_resolve(prog->externs[i]);
+
+    const BcInstr *pc = &code[main_fn->entry];
+
+#define NEXT()      goto *dispatch[(++pc)->op]
+#define JUMP(t)     do { pc = &code[t]; goto *dispatch[pc->op]; } while (0)
+#define A           fp[pc->a]
+#define B           fp[pc->b]
+#define C           fp[pc->c]
+
+    goto *dispatch[pc->op];
+
+op_nop:     NEXT();
+op_mov:     A = B; NEXT();
+op_loadi:   A = pc->b; NEXT();
+op_loadg:   A = globals[pc->b]; NEXT();
+op_storeg:  globals[pc->a] = B; NEXT();
+
+op_add:     A = WRAP(+, B, C); NEXT();
+op_sub:     A = WRAP(-, B, C); NEXT();
+op_mul:     A = WRAP(*, B, C); NEXT();
+op_div:     if (C == 0) goto div_zero;
+            A = B / C; NEXT();
+op_mod:     if (C == 0) goto div_zero;
+            A = B % C; NEXT();
+op_neg:     A = WRAP(-, 0, B); NEXT();
+op_not:     A = B ^ 1; NEXT();
+op_and:     A = B & C; NEXT();
+op_or:      A = B | C; NEXT();
+
+op_eq:      A = B == C; NEXT();
+op_neq:     A = B != C; NEXT();
+op_lt:      A = B <  C; NEXT();
+op_le:      A = B <= C; NEXT();
+op_gt:      A = B >  C; NEXT();
+op_ge:      A = B >= C; NEXT();
+
+op_jmp:     JUMP(pc->a);
+op_jnot:    if (A != 1) JUMP(pc->b);
+            NEXT();
+op_jeq:     if (A == B) JUMP(pc->c);
+            NEXT();
+op_jne:     if (A != B) JUMP(pc->c);
+            NEXT();
+op_jlt:     if (A <  B) JUMP(pc->c);
+            NEXT();
+op_jle:     if (A <= B) JUMP(pc->c);
+            NEXT();
+op_jgt:     if (A >  B) JUMP(pc->c);
+            NEXT();
+op_jge:     if (A >= B) JUMP(pc->c);
+            NEXT();
+
+op_call: {
+    const BcFunction *fn = &prog->functions[pc->b];
+    if (depth >= VM_MAX_CALL_DEPTH) {
+        runtime_error(err, 0, "más de %d llamadas anidadas", VM_MAX_CALL_DEPTH);
+        status = 1;
+        goto done;
+    }
+    if (depth == calls_capacity) {
+        int capacity = calls_capacity ? calls_capacity * 2 : 256;
+        CallRecord *grown = realloc(calls, capacity * sizeof(CallRecord));
+        if (!grown) goto out_of_memory;
+        calls = grown;
+        calls_capacity = capacity;
+    }
+    size_t fp_offset = fp - stack;      // después del realloc 'stack' ya no vale
+    int base = (int)fp_offset + frame_size;
+    if (base + fn->frame_size > stack_capacity) {
+        int capacity = stack_capacity;
+        while (base + fn->frame_size > capacity) {
+            if (capacity > INT_MAX / 2) goto out_of_memory;
+            capacity *= 2;
+        }
+        long *moved = realloc(stack, capacity * sizeof(long));
+        if (!moved) goto out_of_memory;
+        stack = moved;
+        stack_capacity = capacity;
+        fp = stack + fp_offset;
+    }
+
+    long *callee = stack + base;
+    memset(callee, 0, fn->frame_size * sizeof(long));
+    for (int k = 0; k < pc->c; k++) callee[k] = fp[arg_slot(pc, k)];
+
+    calls[depth++] = (CallRecord){ pc + 1 + (pc->c + 2) / 3, (int)(fp - stack), frame_size, pc->a };
+    fp = callee;
+    frame_size = fn->frame_size;
+    JUMP(fn->entry);
+}
+
+op_callx: {
+    ExternFn fn = externs[pc->b];
+    if (!fn) {
+        runtime_error(err, 0, "el método externo '%s' no está disponible", prog->externs[pc->b]);
+        status = 1;
+        goto done;
+    }
+    if (pc->c > EXTERN_MAX_ARGS) {
+        runtime_error(err, 0, "el método externo '%s' tiene demasiados argumentos", prog->externs[pc->b]);
+        status = 1;
+        goto done;
+    }
+    long args[EXTERN_MAX_ARGS] = { 0 };
+    for (int k = 0; k < pc->c; k++) args[k] = fp[arg_slot(pc, k)];
+    long value = fn(args[0], args[1], args[2], args[3], args[4], args[5]);
+    if (pc->a >= 0) A = value;
+    pc += (pc->c + 2) / 3;
+    NEXT();
+}
+
+op_ret: {
+    long value = pc->a >= 0 ? A : 0;
+    if (depth == 0) {
+        status = (int)value;        // main: void devuelve 0
+        goto done;
+    }
+    CallRecord *call = &calls[--depth];
+    fp = stack + call->fp;
+    frame_size = call->frame_size;
+    if (call->dst >= 0) fp[call->dst] = value;
+    pc = call->ret;
+    goto *dispatch[pc->op];
+}
+
+div_zero:
+    runtime_error(err, 0, "%s por cero", pc->op == BC_DIV ? "división" : "módulo");
+    status = EXIT_DIV_ZERO;
+    goto done;
+
+out_of_memory:
+    runtime_error(err, 0, "no hay memoria para la pila de llamadas");
+    status = 1;
+
+done:
+#undef NEXT
+#undef JUMP
+#undef A
+#undef B
+#undef C
+    fflush(stdout);
+    free(stack);
+    free(calls);
+    free(externs);
+    free(globals);
+    return status;
+}
@@ -1,15 +1,29 @@
 #include "Stages.h"
+#include "Batch.h"
+#include "Arena.h"
+#include "ThreadPool.h"
 
 int main(int argc, char **argv) {
     Config cfg;
     if (!parse_args(argc, argv, &cfg)) return 1;
+    if (cfg.time_report) alloc_counting_enable();
 
-    yyin = open_input(cfg.input_file);
-    if (!yyin) return 1;
+    if (is_batch(&cfg)) {
+        if (!optimizer_configure(cfg.optimization)) return 1;
+        return run_batch(&cfg);
+    }
+
+    FILE *in = open_input(cfg.input_file);
+    if (!in) return 1;
+
+    if (!optimizer_configure(cfg.optimization)) {
+        fclose(in);
+        return 1;
+    }
 
     FILE *f = open_output(cfg.output_file);
     if (!f) {
-        fclose(yyin);
+        fclose(in);
         return 1;
     }
 
@@ -20,28 +34,72 @@ int main(int argc, char **argv) {
         if (cfg.optimization) printf("[DEBUG] Optimizacion: %s\n", cfg.optimization);
     }
 
-    initScopeStack(&scope_Stack);
-    pushScope(&scope_Stack, createTable());
+    CompilerContext ctx;
+    if (context_init(&ctx, cfg.input_file, in, stderr) != 0) {
+        context_free(&ctx);
+        close_output(f);
+        fclose(in);
+        return 1;
+    }
 
+    // Los métodos del archivo se optimizan y traducen en paralelo (Units.h),
+    // en un pool que units_run crea solo si el archivo tiene métodos de sobra.
+    // Con -debug van en orden para que no se mezclen los mensajes de cada uno.
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (!cfg.debug && cpus > 1) ctx.pool_threads = (int)cpus;
+
+    TimeReport report = { 0 };
+    PhaseTimer total;
+    if (cfg.time_report) {
+        report.input_file = cfg.input_file;
+        ctx.report = &report;
+    }
+    report_start(ctx.report, &total);
+
+    CompilerContext *prev = context_bind(&ctx);
     int result = 0;
 
     if (strcasecmp(cfg.target, "scan") == 0)
-        result = run_scan_stage(f, cfg.debug);
+        result = run_scan_stage(&ctx, f, cfg.debug);
     else if (strcasecmp(cfg.target, "parse") == 0)
-        result = run_parse_stage(&cfg);
+        result = run_parse_stage(&ctx, &cfg);
     else if (strcasecmp(cfg.target, "codinter") == 0) {
-        if ((result = run_parse_stage(&cfg)) == 0)
-            result = run_codinter_stage();
+        if ((result = run_parse_stage(&ctx, &cfg)) == 0)
+            result = run_codinter_stage(&ctx, &cfg);
     } else if (strcasecmp(cfg.target, "assembly") == 0) {
-        if ((result = run_parse_stage(&cfg)) == 0)
-            result = run_assembly_stage(f, cfg.debug);
+        if ((result = run_parse_stage(&ctx, &cfg)) == 0)
+            result = run_assembly_stage(&ctx, f, &cfg);
+    } else if (strcasecmp(cfg.target, "run") == 0) {
+        if ((result = run_parse_stage(&ctx, &cfg)) == 0)
+            result = run_interpret_stage(&ctx);
+    } else if (strcasecmp(cfg.target, "vm") == 0) {
+        result = run_vm_stage(&ctx, &cfg, in);
+    } else if (strcasecmp(cfg.target, "jit") == 0) {
+        if ((result = run_parse_stage(&ctx, &cfg)) == 0)
+            result = run_jit_stage(&ctx, &cfg);
+    } else if (strcasecmp(cfg.target, "object") == 0) {
+        if ((result = run_parse_stage(&ctx, &cfg)) == 0)
+            result = run_object_stage(&ctx, f, &cfg);
     } else {
         fprintf(stderr, "Target desconocido: %s\n", cfg.target);
         result = 1;
     }
 
-    fclose(f);
-    fclose(yyin);
+    close_output(f);
+    fclose(in);
+    if (ctx.pool) pool_destroy(ctx.pool);
+
+    report_finish(ctx.report, &total);
+    if (ctx.report && strcasecmp(cfg.time_report, "json") == 0) {
+        report_print_json(&report, stderr);
+        fputc('\n', stderr);
+    } else if (ctx.report) {
+        report_print(&report, stderr);
+    }
+
+    if (cfg.debug) arena_print_stats(stdout);
+    context_bind(prev);
+    context_free(&ctx);
 
     if (cfg.debug) printf("[DEBUG] Finalizado con código %d\n", result);
     return result;
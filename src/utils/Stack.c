@@ -1,15 +1,15 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include "Stack.h"
 
-TypeStack typeStack;
-
-void initTypeStack(TypeStack *s) {
+void initTypeStack(TypeStack *s, FILE *err) {
     s->top = -1;
+    s->err = err;
 }
 
 void pushType(TypeStack *s, SymbolType t) {
     if (s->top == 99) {
-        printf("Pila de tipos llena\n");
+        fprintf(s->err, "Pila de tipos llena\n");
         return;
     }
     s->arr[++s->top] = t;
@@ -17,7 +17,7 @@ void pushType(TypeStack *s, SymbolType t) {
 
 SymbolType popType(TypeStack *s) {
     if (s->top == -1) {
-        printf("Pila de tipos vacía\n");
+        fprintf(s->err, "Pila de tipos vacía\n");
         return TYPE_VOID;
     }
     return s->arr[s->top--];
@@ -32,39 +32,62 @@ int isEmptyTypeStack(TypeStack *s) {
     return s->top == -1;
 }
 
-void initScopeStack(ScopeStack *s) {
+void initScopeStack(ScopeStack *s, FILE *err) {
+    s->frames = NULL;
     s->top = -1;
+    s->capacity = 0;
+    s->visible = createTable();
+    s->undo = NULL;
+    s->undo_size = 0;
+    s->undo_capacity = 0;
+    s->err = err;
 }
 
 void pushScope(ScopeStack *s, SymbolTable *t) {
-    if (s->top == 99) {
-        printf("Pila de scopes llena\n");
-        return;
+    if (s->top + 1 == s->capacity) {
+        s->capacity = s->capacity ? s->capacity * 2 : 16;
+        s->frames = realloc(s->frames, sizeof(ScopeFrame) * s->capacity);
     }
-    s->arr[++s->top] = t;
+    ScopeFrame *f = &s->frames[++s->top];
+    f->table = t;
+    f->mark = s->undo_size;
 }
 
 void popScope(ScopeStack *s) {
     if (s->top == -1) {
-        printf("Pila de scopes vacía\n");
+        fprintf(s->err, "Pila de scopes vacía\n");
         return;
     }
+    // Vuelven a verse las declaraciones que tapaba este scope
+    while (s->undo_size > s->frames[s->top].mark) {
+        ScopeUndo *u = &s->undo[--s->undo_size];
+        bindSymbol(s->visible, u->name, u->shadowed);
+    }
     s->top--;
 }
 
 SymbolTable* peekScope(ScopeStack *s) {
     if (s->top == -1) return NULL;
-    return s->arr[s->top];
+    return s->frames[s->top].table;
 }
 
-Symbol* lookupInScopes(ScopeStack *s, const char *name) {
-    if (s == NULL) return NULL;
+Symbol* declareInScope(ScopeStack *s, char *name, SymbolType type, Valores value) {
+    Symbol *sym = insertSymbol(peekScope(s), name, type, value);
+    if (!sym) return NULL;
 
-    for (int i = s->top; i >= 0; i--) {
-        Symbol *sym = lookupSymbol(s->arr[i], name);
-        if (sym != NULL) return sym;
+    if (s->undo_size == s->undo_capacity) {
+        s->undo_capacity = s->undo_capacity ? s->undo_capacity * 2 : 64;
+        s->undo = realloc(s->undo, sizeof(ScopeUndo) * s->undo_capacity);
     }
-    return NULL;
+    ScopeUndo *u = &s->undo[s->undo_size++];
+    u->name = sym->name;
+    u->shadowed = bindSymbol(s->visible, sym->name, sym);
+    return sym;
+}
+
+Symbol* lookupInScopes(ScopeStack *s, const char *name) {
+    if (s == NULL || s->visible == NULL) return NULL;
+    return lookupSymbol(s->visible, name);
 }
 
 
@@ -96,7 +119,7 @@ void printScopeStack(ScopeStack *s) {
     for (int i = s->top; i >= 0; i--) {
         printf("Scope #%d:\n", i);
 
-        SymbolTable *table = s->arr[i];
+        SymbolTable *table = s->frames[i].table;
         if (!table || table->size == 0) {
             printf("  (sin símbolos)\n");
             continue;
@@ -0,0 +1,75 @@
+#include <stdlib.h>
+#include "SymbolMap.h"
+
+void symmap_init(SymbolMap *m) {
+    m->capacity = 64;
+    m->used = 0;
+    m->gen = 1;
+    m->entries = calloc(m->capacity, sizeof(SymbolMapEntry));
+}
+
+void symmap_free(SymbolMap *m) {
+    free(m->entries);
+    m->entries = NULL;
+    m->capacity = 0;
+    m->used = 0;
+}
+
+void symmap_clear(SymbolMap *m) {
+    m->gen++;
+}
+
+/* Slot de 'sym', o el primero libre/viejo donde insertarlo */
+static SymbolMapEntry *find_slot(SymbolMap *m, Symbol *sym) {
+    unsigned mask = m->capacity - 1;
+    unsigned i = hash_ptr(sym) & mask;
+    SymbolMapEntry *free_slot = NULL;
+    while (m->entries[i].sym) {
+        SymbolMapEntry *e = &m->entries[i];
+        if (e->sym == sym) return e;
+        if (e->gen != m->gen && !free_slot) free_slot = e;
+        i = (i + 1) & mask;
+    }
+    return free_slot ? free_slot : &m->entries[i];
+}
+
+bool symmap_get(SymbolMap *m, Symbol *sym, int *value) {
+    SymbolMapEntry *e = find_slot(m, sym);
+    if (e->sym != sym || e->gen != m->gen) return false;
+    if (value) *value = e->value;
+    return true;
+}
+
+void symmap_remove(SymbolMap *m, Symbol *sym) {
+    SymbolMapEntry *e = find_slot(m, sym);
+    if (e->sym == sym) e->gen = 0;
+}
+
+/* Reconstruye la tabla descartando las entradas viejas; duplica si sigue muy llena */
+static void rehash(SymbolMap *m) {
+    SymbolMapEntry *old = m->entries;
+    int old_capacity = m->capacity;
+    unsigned gen = m->gen;
+    int live = 0;
+
+    for (int i = 0; i < old_capacity; i++)
+        if (old[i].sym && old[i].gen == gen) live++;
+    if (live * 4 > m->capacity) m->capacity *= 2;
+
+    m->entries = calloc(m->capacity, sizeof(SymbolMapEntry));
+    m->used = 0;
+    for (int i = 0; i < old_capacity; i++) {
+        if (old[i].sym && old[i].gen == gen)
+            symmap_set(m, old[i].sym, old[i].value);
+    }
+    free(old);
+}
+
+void symmap_set(SymbolMap *m, Symbol *sym, int value) {
+    if ((m->used + 1) * 2 > m->capacity) rehash(m);
+    SymbolMapEntry *e = find_slot(m, sym);
+    if (!e->sym) m->used++;
+    e->sym = sym;
+    e->value = value;
+    e->gen = m->gen;
+}
@@ -0,0 +1,55 @@
+#include <stdlib.h>
+#include <stdbool.h>
+#include "TimeReport.h"
+
+/*
+ * Contadores de pedidos de memoria por hilo, para --time-report.
+ * En glibc malloc, calloc y realloc se reemplazan por versiones que suman
+ * al contador del hilo y llaman a las de la biblioteca (__libc_*); free no
+ * cambia. Con los sanitizers (que reemplazan malloc ellos mismos) o fuera
+ * de glibc los contadores quedan en cero.
+ *
+ * Sin --time-report no se cuenta: cada pedido solo lee 'counting', un
+ * global que se escribe una vez antes de crear hilos, y sigue de largo.
+ */
+static bool counting;
+static _Thread_local long thread_allocs;
+static _Thread_local long thread_bytes;
+
+void alloc_counting_enable(void) {
+    counting = true;
+}
+
+void alloc_counters(long *allocs, long *bytes) {
+    *allocs = thread_allocs;
+    *bytes = thread_bytes;
+}
+
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__) && !defined(__SANITIZE_THREAD__)
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t n, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+static inline void count(size_t size) {
+    if (__builtin_expect(!counting, 1)) return;
+    thread_allocs++;
+    thread_bytes += size;
+}
+
+void *malloc(size_t size) {
+    count(size);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t n, size_t size) {
+    count(n * size);
+    return __libc_calloc(n, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    count(size);
+    return __libc_realloc(ptr, size);
+}
+
+#endif
@@ -0,0 +1,115 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "Arena.h"
+
+#define ARENA_BLOCK (64 * 1024)
+#define ARENA_ALIGN (sizeof(max_align_t))
+
+typedef struct ArenaBlock {
+    struct ArenaBlock *next;
+    size_t used;
+    size_t size;
+    max_align_t data[];
+} ArenaBlock;
+
+typedef struct {
+    ArenaBlock *blocks;
+    size_t objects;
+    size_t bytes;       // pedidos (sin contar el relleno de alineación)
+    size_t reserved;    // tamaño total de los bloques
+    int nblocks;
+} SubArena;
+
+struct Arena {
+    SubArena sub[ARENA_KINDS];
+};
+
+static const char *const kind_names[ARENA_KINDS] = {
+    [ARENA_AST]     = "ast",
+    [ARENA_SYMBOLS] = "symbols",
+};
+
+static Arena process_arena;
+static _Thread_local Arena *current = &process_arena;
+
+Arena *arena_create(void) {
+    return calloc(1, sizeof(Arena));
+}
+
+static void release_all(Arena *arena) {
+    for (int k = 0; k < ARENA_KINDS; k++) {
+        SubArena *a = &arena->sub[k];
+        while (a->blocks) {
+            ArenaBlock *next = a->blocks->next;
+            free(a->blocks);
+            a->blocks = next;
+        }
+        a->objects = a->bytes = a->reserved = 0;
+        a->nblocks = 0;
+    }
+}
+
+void arena_destroy(Arena *arena) {
+    if (!arena) return;
+    release_all(arena);
+    if (arena != &process_arena) free(arena);
+}
+
+Arena *arena_bind(Arena *arena) {
+    Arena *prev = current == &process_arena ? NULL : current;
+    current = arena ? arena : &process_arena;
+    return prev;
+}
+
+static ArenaBlock *new_block(SubArena *a, ArenaKind kind, size_t min_size) {
+    size_t size = min_size > ARENA_BLOCK ? min_size : ARENA_BLOCK;
+    ArenaBlock *b = malloc(sizeof(ArenaBlock) + size);
+    if (!b) {
+        fprintf(stderr, "Error: sin memoria para la arena '%s'\n", kind_names[kind]);
+        exit(EXIT_FAILURE);
+    }
+    b->used = 0;
+    b->size = size;
+    b->next = a->blocks;
+    a->blocks = b;
+    a->reserved += size;
+    a->nblocks++;
+    return b;
+}
+
+void *arena_alloc(ArenaKind kind, size_t size) {
+    SubArena *a = &current->sub[kind];
+    size_t rounded = (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+    ArenaBlock *b = a->blocks;
+    if (!b || b->size - b->used < rounded) b = new_block(a, kind, rounded);
+
+    void *p = (char *)b->data + b->used;
+    b->used += rounded;
+    a->objects++;
+    a->bytes += size;
+    memset(p, 0, size);
+    return p;
+}
+
+char *arena_strdup(ArenaKind kind, const char *s) {
+    size_t len = strlen(s);
+    char *copy = arena_alloc(kind, len + 1);
+    memcpy(copy, s, len + 1);
+    return copy;
+}
+
+size_t arena_objects(ArenaKind kind) {
+    return current->sub[kind].objects;
+}
+
+void arena_print_stats(FILE *out) {
+    size_t total = 0;
+    for (int k = 0; k < ARENA_KINDS; k++) {
+        SubArena *a = &current->sub[k];
+        fprintf(out, "[DEBUG] Arena %-8s %8zu objetos %10zu bytes en %d bloque(s) (%zu KiB reservados)\n",
+                kind_names[k], a->objects, a->bytes, a->nblocks, a->reserved / 1024);
+        total += a->reserved;
+    }
+    fprintf(out, "[DEBUG] Arena total: %zu KiB\n", total / 1024);
+}
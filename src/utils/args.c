@@ -1,65 +1,132 @@
-#include "Args.h"
-
-void print_usage() {
-    printf("Uso: c-tds [opcion] archivo.ctds\n");
-    printf("Opciones:\n");
-    printf("  -o <salida>       Renombra el archivo de salida\n");
-    printf("  -target <etapa>   Etapa: scan | parse | codinter | assembly\n");
-    printf("  -opt [opt]        Realiza optimizaciones (all para todas)\n");
-    printf("  -debug            Activa modo debug\n");
-}
-
-bool parse_args(int argc, char **argv, Config *cfg) {
-    int opt;
-    cfg->output_file = NULL;
-    cfg->target = "parse";
-    cfg->optimization = NULL;
-    cfg->debug = false;
-
-    static struct option long_options[] = {
-        {"debug",   no_argument,       0, 'd'},
-        {"target",  required_argument, 0, 't'},
-        {"opt",     required_argument, 0, 'p'},
-        {"o",       required_argument, 0, 'o'},
-        {0, 0, 0, 0}
-    };
-
-    while ((opt = getopt_long(argc, argv, "do:o:t:p:", long_options, NULL)) != -1) {
-        switch (opt) {
-            case 'd': cfg->debug = true; break;
-            case 'o': cfg->output_file = optarg; break;
-            case 't': cfg->target = optarg; break;
-            case 'p': cfg->optimization = optarg; break;
-            default: print_usage(); return false;
-        }
-    }
-
-    if (optind >= argc) {
-        fprintf(stderr, "Error: falta el archivo de entrada\n");
-        print_usage();
-        return false;
-    }
-
-    cfg->input_file = argv[optind];
-
-    char *ext = strrchr(cfg->input_file, '.');
-    if (!ext || strcasecmp(ext, ".ctds") != 0) {
-        fprintf(stderr, "Error: el archivo debe tener extensión .ctds\n");
-        return false;
-    }
-
-    if (!cfg->output_file) cfg->output_file = "a.out";
-    return true;
-}
-
-FILE *open_input(const char *path) {
-    FILE *file = fopen(path, "r");
-    if (!file) perror("Error al abrir el archivo de entrada");
-    return file;
-}
-
-FILE *open_output(const char *path) {
-    FILE *file = fopen(path, "w");
-    if (!file) perror("Error al crear archivo de salida");
-    return file;
-}
+#include "Args.h"
+
+void print_usage() {
+    printf("Uso: c-tds [opcion] archivo.ctds [archivo.ctds ...]\n");
+    printf("Opciones:\n");
+    printf("  -o <salida>       Renombra el archivo de salida ('-' para stdout)\n");
+    printf("  -target <etapa>   Etapa: scan | parse | codinter | assembly | object | run | vm | jit\n");
+    printf("  -opt [opt]        Realiza optimizaciones (all para todas, o lista: jumps,...)\n");
+    printf("  -debug            Activa modo debug\n");
+    printf("  -j <N>            Compila varios archivos en paralelo con N hilos (cada uno a su .s)\n");
+    printf("  --time-report[=json] Tiempo, CPU y memoria de cada fase y pase (por stderr)\n");
+}
+
+bool parse_args(int argc, char **argv, Config *cfg) {
+    int opt;
+    cfg->output_file = NULL;
+    cfg->target = NULL;
+    cfg->optimization = NULL;
+    cfg->debug = false;
+    cfg->jobs = 0;
+    cfg->time_report = NULL;
+
+    static struct option long_options[] = {
+        {"debug",   no_argument,       0, 'd'},
+        {"target",  required_argument, 0, 't'},
+        {"opt",     required_argument, 0, 'p'},
+        {"o",       required_argument, 0, 'o'},
+        {"j",       required_argument, 0, 'j'},
+        {"time-report", optional_argument, 0, 'r'},
+        {0, 0, 0, 0}
+    };
+
+    // getopt_long_only para aceptar las formas de un guión (-opt, -target, -debug)
+    while ((opt = getopt_long_only(argc, argv, "do:t:p:j:", long_options, NULL)) != -1) {
+        switch (opt) {
+            case 'd': cfg->debug = true; break;
+            case 'o': cfg->output_file = optarg; break;
+            case 't': cfg->target = optarg; break;
+            case 'p': cfg->optimization = optarg; break;
+            case 'j':
+                cfg->jobs = atoi(optarg);
+                if (cfg->jobs < 1) {
+                    fprintf(stderr, "Error: -j espera una cantidad de hilos mayor a 0\n");
+                    return false;
+                }
+                break;
+            case 'r':
+                cfg->time_report = optarg ? optarg : "text";
+                if (strcasecmp(cfg->time_report, "text") != 0 && strcasecmp(cfg->time_report, "json") != 0) {
+                    fprintf(stderr, "Error: --time-report acepta 'text' o 'json'\n");
+                    return false;
+                }
+                break;
+            default: print_usage(); return false;
+        }
+    }
+
+    if (optind >= argc) {
+        fprintf(stderr, "Error: falta el archivo de entrada\n");
+        print_usage();
+        return false;
+    }
+
+    cfg->input_files = &argv[optind];
+    cfg->input_count = argc - optind;
+    cfg->input_file = cfg->input_files[0];
+
+    for (int i = 0; i < cfg->input_count; i++) {
+        char *ext = strrchr(cfg->input_files[i], '.');
+        if (!ext || strcasecmp(ext, ".ctds") != 0) {
+            fprintf(stderr, "Error: el archivo debe tener extensión .ctds: %s\n", cfg->input_files[i]);
+            return false;
+        }
+    }
+
+    if (is_batch(cfg)) {
+        // Cada archivo se escribe en su propio .s
+        if (!cfg->target) cfg->target = "assembly";
+        if (strcasecmp(cfg->target, "assembly") != 0) {
+            fprintf(stderr, "Error: con varios archivos o -j solo se admite -t assembly\n");
+            return false;
+        }
+        if (cfg->output_file) {
+            fprintf(stderr, "Error: -o no se puede usar con varios archivos (cada uno va a su .s)\n");
+            return false;
+        }
+        return true;
+    }
+
+    if (!cfg->target) cfg->target = "parse";
+    // -t run, -t vm y -t jit no producen un archivo: lo que imprime el programa va a stdout
+    bool runs = strcasecmp(cfg->target, "run") == 0 || strcasecmp(cfg->target, "vm") == 0
+             || strcasecmp(cfg->target, "jit") == 0;
+    if (!cfg->output_file) {
+        // assembly y object, junto al fuente como en el modo batch (a.ctds -> a.s, a.o)
+        if (strcasecmp(cfg->target, "assembly") == 0) cfg->output_file = replace_extension(cfg->input_file, ".s");
+        else if (strcasecmp(cfg->target, "object") == 0) cfg->output_file = replace_extension(cfg->input_file, ".o");
+        else cfg->output_file = runs ? "-" : "a.out";
+    }
+    return true;
+}
+
+char *replace_extension(const char *path, const char *ext) {
+    const char *dot = strrchr(path, '.');
+    size_t len = dot ? (size_t)(dot - path) : strlen(path);
+    char *result = malloc(len + strlen(ext) + 1);
+    memcpy(result, path, len);
+    strcpy(result + len, ext);
+    return result;
+}
+
+bool is_batch(const Config *cfg) {
+    return cfg->jobs > 0 || cfg->input_count > 1;
+}
+
+FILE *open_input(const char *path) {
+    FILE *file = fopen(path, "r");
+    if (!file) perror("Error al abrir el archivo de entrada");
+    return file;
+}
+
+FILE *open_output(const char *path) {
+    if (strcmp(path, "-") == 0) return stdout;
+    FILE *file = fopen(path, "w");
+    if (!file) perror("Error al crear archivo de salida");
+    return file;
+}
+
+void close_output(FILE *file) {
+    if (file == stdout) fflush(stdout);
+    else fclose(file);
+}
@@ -0,0 +1,125 @@
+#include <stdlib.h>
+#include <string.h>
+#include "Intern.h"
+
+/*
+ * Direccionamiento abierto con sondeo lineal. Cada entrada guarda el hash
+ * para descartar casi todas las colisiones sin comparar los textos. Los
+ * strings se copian en bloques grandes en lugar de un malloc por nombre.
+ */
+
+#define POOL_BLOCK 4096
+
+typedef struct {
+    char *str;
+    unsigned hash;
+} InternEntry;
+
+typedef struct PoolBlock {
+    struct PoolBlock *next;
+    size_t used;
+    size_t size;
+    char data[];
+} PoolBlock;
+
+struct InternTable {
+    InternEntry *entries;
+    int capacity;           // potencia de 2
+    int count;
+    PoolBlock *blocks;
+};
+
+static InternTable process_table;
+static _Thread_local InternTable *current = &process_table;
+
+InternTable *intern_create(void) {
+    return calloc(1, sizeof(InternTable));
+}
+
+void intern_destroy(InternTable *table) {
+    if (!table) return;
+    while (table->blocks) {
+        PoolBlock *next = table->blocks->next;
+        free(table->blocks);
+        table->blocks = next;
+    }
+    free(table->entries);
+    if (table == &process_table) *table = (InternTable){0};
+    else free(table);
+}
+
+InternTable *intern_bind(InternTable *table) {
+    InternTable *prev = current == &process_table ? NULL : current;
+    current = table ? table : &process_table;
+    return prev;
+}
+
+/* FNV-1a */
+static unsigned hash_text(const char *s, size_t len) {
+    unsigned h = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (unsigned char)s[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static char *pool_copy(InternTable *t, const char *s, size_t len) {
+    PoolBlock *blocks = t->blocks;
+    if (!blocks || blocks->size - blocks->used < len + 1) {
+        size_t size = len + 1 > POOL_BLOCK ? len + 1 : POOL_BLOCK;
+        PoolBlock *b = malloc(sizeof(PoolBlock) + size);
+        b->next = blocks;
+        b->used = 0;
+        b->size = size;
+        blocks = t->blocks = b;
+    }
+    char *copy = blocks->data + blocks->used;
+    memcpy(copy, s, len);
+    copy[len] = '\0';
+    blocks->used += len + 1;
+    return copy;
+}
+
+static InternEntry *find_slot(InternTable *t, const char *s, size_t len, unsigned hash) {
+    unsigned mask = t->capacity - 1;
+    unsigned i = hash & mask;
+    while (t->entries[i].str) {
+        InternEntry *e = &t->entries[i];
+        if (e->hash == hash && strncmp(e->str, s, len) == 0 && e->str[len] == '\0') return e;
+        i = (i + 1) & mask;
+    }
+    return &t->entries[i];
+}
+
+static void grow(InternTable *t) {
+    InternEntry *old = t->entries;
+    int old_capacity = t->capacity;
+
+    t->capacity = t->capacity ? t->capacity * 2 : 256;
+    t->entries = calloc(t->capacity, sizeof(InternEntry));
+    for (int i = 0; i < old_capacity; i++) {
+        if (!old[i].str) continue;
+        unsigned j = old[i].hash & (t->capacity - 1);
+        while (t->entries[j].str) j = (j + 1) & (t->capacity - 1);
+        t->entries[j] = old[i];
+    }
+    free(old);
+}
+
+char *intern_n(const char *s, size_t len) {
+    InternTable *t = current;
+    if ((t->count + 1) * 4 > t->capacity * 3) grow(t);
+    unsigned hash = hash_text(s, len);
+    InternEntry *e = find_slot(t, s, len, hash);
+    if (!e->str) {
+        e->str = pool_copy(t, s, len);
+        e->hash = hash;
+        t->count++;
+    }
+    return e->str;
+}
+
+char *intern(const char *s) {
+    return intern_n(s, strlen(s));
+}
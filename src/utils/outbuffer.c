@@ -0,0 +1,62 @@
+#include <stdlib.h>
+#include <string.h>
+#include "OutBuffer.h"
+
+void out_init(OutBuffer *out) {
+    out->data = NULL;
+    out->size = 0;
+    out->capacity = 0;
+}
+
+void out_free(OutBuffer *out) {
+    free(out->data);
+    out_init(out);
+}
+
+static void reserve(OutBuffer *out, size_t extra) {
+    if (out->size + extra <= out->capacity) return;
+    size_t capacity = out->capacity ? out->capacity : 64 * 1024;
+    while (capacity < out->size + extra) capacity *= 2;
+    out->data = realloc(out->data, capacity);
+    if (!out->data) {
+        fprintf(stderr, "Error: sin memoria para el buffer de salida\n");
+        exit(EXIT_FAILURE);
+    }
+    out->capacity = capacity;
+}
+
+void out_write(OutBuffer *out, const char *s, size_t len) {
+    reserve(out, len);
+    memcpy(out->data + out->size, s, len);
+    out->size += len;
+}
+
+void out_puts(OutBuffer *out, const char *s) {
+    out_write(out, s, strlen(s));
+}
+
+void out_putc(OutBuffer *out, char c) {
+    reserve(out, 1);
+    out->data[out->size++] = c;
+}
+
+void out_int(OutBuffer *out, long value) {
+    char digits[24];
+    int n = sizeof(digits);
+    unsigned long v = value < 0 ? -(unsigned long)value : (unsigned long)value;
+    do {
+        digits[--n] = '0' + v % 10;
+        v /= 10;
+    } while (v);
+    if (value < 0) digits[--n] = '-';
+    out_write(out, digits + n, sizeof(digits) - n);
+}
+
+int out_flush(OutBuffer *out, FILE *file) {
+    if (out->size > 0 && fwrite(out->data, 1, out->size, file) != out->size) {
+        perror("Error al escribir la salida");
+        return 1;
+    }
+    out->size = 0;
+    return fflush(file) == 0 ? 0 : 1;
+}
@@ -0,0 +1,210 @@
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "ThreadPool.h"
+
+typedef struct {
+    PoolTaskFn fn;
+    void *arg;
+    PoolGroup *group;
+} PoolTask;
+
+/*
+ * Cola de un hilo: las tareas viven en [head, tail). El dueño agrega y saca
+ * por 'tail'; los demás roban por 'head'. Un mutex por cola alcanza: las
+ * tareas son archivos o métodos enteros, no operaciones chicas.
+ */
+typedef struct {
+    pthread_mutex_t lock;
+    PoolTask *tasks;
+    int head;
+    int tail;
+    int capacity;
+    // Estadísticas (solo las escribe el hilo dueño)
+    long executed;
+    long stolen;
+} WorkDeque;
+
+struct ThreadPool {
+    int nworkers;
+    pthread_t *threads;
+    WorkDeque *deques;
+
+    atomic_int queued;          // tareas en alguna cola
+    atomic_int next;            // cola para las tareas que llegan de afuera del pool
+    atomic_long outside_executed;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;        // hay tareas nuevas (o hay que terminar)
+    pthread_cond_t done;        // terminó la última tarea de algún grupo
+    bool stop;
+};
+
+static _Thread_local int worker_index = -1;
+
+static void deque_push(WorkDeque *d, PoolTask task) {
+    pthread_mutex_lock(&d->lock);
+    if (d->tail == d->capacity) {
+        if (d->head > 0) {
+            // Reusar el espacio que dejaron los robos antes de crecer
+            for (int i = d->head; i < d->tail; i++) d->tasks[i - d->head] = d->tasks[i];
+            d->tail -= d->head;
+            d->head = 0;
+        }
+        if (d->tail == d->capacity) {
+            d->capacity = d->capacity ? d->capacity * 2 : 64;
+            d->tasks = realloc(d->tasks, d->capacity * sizeof(PoolTask));
+        }
+    }
+    d->tasks[d->tail++] = task;
+    pthread_mutex_unlock(&d->lock);
+}
+
+static bool deque_pop(WorkDeque *d, PoolTask *task, bool steal) {
+    pthread_mutex_lock(&d->lock);
+    bool found = d->head < d->tail;
+    if (found) {
+        *task = steal ? d->tasks[d->head++] : d->tasks[--d->tail];
+        if (d->head == d->tail) d->head = d->tail = 0;
+    }
+    pthread_mutex_unlock(&d->lock);
+    return found;
+}
+
+/* Primero la cola propia; después se roba empezando por la del hilo siguiente */
+static bool take_task(ThreadPool *pool, PoolTask *task) {
+    int self = worker_index;
+    if (self >= 0 && deque_pop(&pool->deques[self], task, false)) return true;
+
+    int start = self >= 0 ? self + 1 : 0;
+    for (int k = 0; k < pool->nworkers; k++) {
+        int victim = (start + k) % pool->nworkers;
+        if (victim == self) continue;
+        if (deque_pop(&pool->deques[victim], task, true)) {
+            if (self >= 0) pool->deques[self].stolen++;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void run_task(ThreadPool *pool, PoolTask *task) {
+    atomic_fetch_sub(&pool->queued, 1);
+    task->fn(task->arg);
+
+    if (worker_index >= 0) pool->deques[worker_index].executed++;
+    else atomic_fetch_add(&pool->outside_executed, 1);
+
+    if (atomic_fetch_sub(&task->group->pending, 1) == 1) {
+        pthread_mutex_lock(&pool->lock);
+        pthread_cond_broadcast(&pool->done);
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+typedef struct {
+    ThreadPool *pool;
+    int index;
+} WorkerStart;
+
+static void *worker_main(void *arg) {
+    WorkerStart start = *(WorkerStart *)arg;
+    free(arg);
+    ThreadPool *pool = start.pool;
+    worker_index = start.index;
+
+    for (;;) {
+        PoolTask task;
+        if (take_task(pool, &task)) {
+            run_task(pool, &task);
+            continue;
+        }
+        pthread_mutex_lock(&pool->lock);
+        while (!pool->stop && atomic_load(&pool->queued) <= 0)
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        bool finished = pool->stop && atomic_load(&pool->queued) <= 0;
+        pthread_mutex_unlock(&pool->lock);
+        if (finished) break;
+    }
+    return NULL;
+}
+
+ThreadPool *pool_create(int nthreads) {
+    if (nthreads < 1) nthreads = 1;
+    ThreadPool *pool = calloc(1, sizeof(ThreadPool));
+    pool->nworkers = nthreads;
+    pool->deques = calloc(nthreads, sizeof(WorkDeque));
+    pool->threads = calloc(nthreads, sizeof(pthread_t));
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    for (int i = 0; i < nthreads; i++) pthread_mutex_init(&pool->deques[i].lock, NULL);
+    for (int i = 0; i < nthreads; i++) {
+        WorkerStart *start = malloc(sizeof(WorkerStart));
+        *start = (WorkerStart){ pool, i };
+        pthread_create(&pool->threads[i], NULL, worker_main, start);
+    }
+    return pool;
+}
+
+void pool_destroy(ThreadPool *pool) {
+    if (!pool) return;
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 0; i < pool->nworkers; i++) pthread_join(pool->threads[i], NULL);
+    for (int i = 0; i < pool->nworkers; i++) {
+        pthread_mutex_destroy(&pool->deques[i].lock);
+        free(pool->deques[i].tasks);
+    }
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->wake);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->threads);
+    free(pool->deques);
+    free(pool);
+}
+
+void pool_submit(ThreadPool *pool, PoolGroup *group, PoolTaskFn fn, void *arg) {
+    atomic_fetch_add(&group->pending, 1);
+    atomic_fetch_add(&pool->queued, 1);
+
+    // Desde adentro del pool la tarea queda en la cola propia; desde afuera se reparten
+    int target = worker_index >= 0 ? worker_index
+                                   : atomic_fetch_add(&pool->next, 1) % pool->nworkers;
+    deque_push(&pool->deques[target], (PoolTask){ fn, arg, group });
+
+    pthread_mutex_lock(&pool->lock);
+    pthread_cond_signal(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void pool_wait(ThreadPool *pool, PoolGroup *group) {
+    while (atomic_load(&group->pending) > 0) {
+        PoolTask task;
+        if (take_task(pool, &task)) {
+            run_task(pool, &task);
+            continue;
+        }
+        // Lo que falta ya lo están ejecutando otros hilos
+        pthread_mutex_lock(&pool->lock);
+        while (atomic_load(&group->pending) > 0 && atomic_load(&pool->queued) <= 0)
+            pthread_cond_wait(&pool->done, &pool->lock);
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+int pool_worker_index(void) {
+    return worker_index;
+}
+
+void pool_print_stats(ThreadPool *pool, FILE *out) {
+    for (int i = 0; i < pool->nworkers; i++) {
+        fprintf(out, "[DEBUG] Hilo %d: %ld tarea(s), %ld robada(s)\n",
+                i, pool->deques[i].executed, pool->deques[i].stolen);
+    }
+    long outside = atomic_load(&pool->outside_executed);
+    if (outside) fprintf(out, "[DEBUG] Fuera del pool: %ld tarea(s)\n", outside);
+}
@@ -0,0 +1,175 @@
+#include <string.h>
+#include <stdbool.h>
+#include <sys/resource.h>
+#include "TimeReport.h"
+
+static const char *const phase_names[PHASE_COUNT] = {
+    [PHASE_LEX]          = "yylex",
+    [PHASE_PARSE]        = "yyparse",
+    [PHASE_SEMANTIC]     = "check_scopes",
+    [PHASE_OFFSETS]      = "calculate_offsets",
+    [PHASE_GEN_CODE]     = "gen_code",
+    [PHASE_OPTIMIZE]     = "optimizaciones",
+    [PHASE_REGALLOC]     = "regalloc",
+    [PHASE_OFFSET_TEMPS] = "offset_temps",
+    [PHASE_ASSEMBLY]     = "generateAssembly",
+    [PHASE_MACHINE_CODE] = "generateMachineCode",
+    [PHASE_OUTPUT]       = "salida",
+    [PHASE_BYTECODE]     = "bc_compile",
+    [PHASE_RUN]          = "interpret",
+};
+
+static double diff_ms(const struct timespec *start, const struct timespec *end) {
+    return (end->tv_sec - start->tv_sec) * 1e3 + (end->tv_nsec - start->tv_nsec) / 1e6;
+}
+
+double elapsed_ms(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return diff_ms(start, &now);
+}
+
+void report_start(TimeReport *report, PhaseTimer *timer) {
+    if (!report) return;
+    clock_gettime(CLOCK_MONOTONIC, &timer->wall);
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &timer->cpu);
+    alloc_counters(&timer->allocs, &timer->bytes);
+}
+
+static void add_elapsed(PhaseStats *stats, PhaseTimer *timer) {
+    struct timespec wall, cpu;
+    long allocs, bytes;
+    clock_gettime(CLOCK_MONOTONIC, &wall);
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu);
+    alloc_counters(&allocs, &bytes);
+
+    stats->wall_ms += diff_ms(&timer->wall, &wall);
+    stats->cpu_ms += diff_ms(&timer->cpu, &cpu);
+    stats->allocs += allocs - timer->allocs;
+    stats->bytes += bytes - timer->bytes;
+    stats->runs++;
+}
+
+void report_stop(TimeReport *report, Phase phase, PhaseTimer *timer) {
+    if (report) add_elapsed(&report->phases[phase], timer);
+}
+
+void report_stop_pass(TimeReport *report, int pass, const char *name, PhaseTimer *timer) {
+    if (!report || pass >= REPORT_MAX_PASSES) return;
+    report->pass_names[pass] = name;
+    add_elapsed(&report->passes[pass], timer);
+}
+
+void report_finish(TimeReport *report, PhaseTimer *timer) {
+    if (!report) return;
+    add_elapsed(&report->total, timer);
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) report->max_rss_kb = usage.ru_maxrss;
+}
+
+static void merge_stats(PhaseStats *into, const PhaseStats *from) {
+    into->wall_ms += from->wall_ms;
+    into->cpu_ms += from->cpu_ms;
+    into->allocs += from->allocs;
+    into->bytes += from->bytes;
+    into->runs += from->runs;
+}
+
+void report_merge(TimeReport *into, const TimeReport *from) {
+    for (int p = 0; p < PHASE_COUNT; p++) merge_stats(&into->phases[p], &from->phases[p]);
+    for (int k = 0; k < REPORT_MAX_PASSES; k++) {
+        if (from->pass_names[k]) into->pass_names[k] = from->pass_names[k];
+        merge_stats(&into->passes[k], &from->passes[k]);
+    }
+    into->tokens += from->tokens;
+    into->ast_nodes += from->ast_nodes;
+    into->symbols += from->symbols;
+    into->ir_instructions += from->ir_instructions;
+    into->ir_optimized += from->ir_optimized;
+    into->asm_lines += from->asm_lines;
+}
+
+// =============================
+// Texto
+// =============================
+
+static void print_row(FILE *out, const char *name, const PhaseStats *s) {
+    fprintf(out, "  %-20s %10.3f %10.3f %10ld %12ld\n", name, s->wall_ms, s->cpu_ms, s->allocs, s->bytes);
+}
+
+void report_print(const TimeReport *report, FILE *out) {
+    fprintf(out, "Reporte de tiempos: %s\n", report->input_file ? report->input_file : "-");
+    fprintf(out, "  %-20s %10s %10s %10s %12s\n", "fase", "pared ms", "cpu ms", "pedidos", "bytes");
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        if (report->phases[p].runs) print_row(out, phase_names[p], &report->phases[p]);
+    }
+    print_row(out, "total", &report->total);
+
+    bool any_pass = false;
+    for (int k = 0; k < REPORT_MAX_PASSES; k++) {
+        if (!report->pass_names[k]) continue;
+        if (!any_pass) fprintf(out, "  pases de optimización:\n");
+        any_pass = true;
+        char name[32];
+        snprintf(name, sizeof(name), "  %s", report->pass_names[k]);
+        print_row(out, name, &report->passes[k]);
+    }
+    if (report->units_wall_ms > 0)
+        fprintf(out, "  métodos (optimización a assembly): %.3f ms de pared\n", report->units_wall_ms);
+
+    fprintf(out, "  %ld tokens, %ld nodos del AST, %ld símbolos, %ld instrucciones IR (%ld después de optimizar), "
+            "%ld líneas de assembly\n", report->tokens, report->ast_nodes, report->symbols,
+            report->ir_instructions, report->ir_optimized, report->asm_lines);
+    fprintf(out, "  pico de memoria residente: %ld KiB\n", report->max_rss_kb);
+}
+
+// =============================
+// JSON
+// =============================
+
+static void print_json_string(FILE *out, const char *s) {
+    fputc('"', out);
+    for (; s && *s; s++) {
+        if (*s == '"' || *s == '\\') fputc('\\', out);
+        if ((unsigned char)*s < 0x20) fprintf(out, "\\u%04x", *s);
+        else fputc(*s, out);
+    }
+    fputc('"', out);
+}
+
+static void print_json_stats(FILE *out, const PhaseStats *s) {
+    fprintf(out, "{\"wall_ms\": %.3f, \"cpu_ms\": %.3f, \"allocs\": %ld, \"bytes\": %ld, \"runs\": %ld}",
+            s->wall_ms, s->cpu_ms, s->allocs, s->bytes, s->runs);
+}
+
+void report_print_json(const TimeReport *report, FILE *out) {
+    fprintf(out, "{\"file\": ");
+    print_json_string(out, report->input_file);
+
+    fprintf(out, ", \"phases\": {");
+    const char *sep = "";
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        if (!report->phases[p].runs) continue;
+        fprintf(out, "%s\"%s\": ", sep, phase_names[p]);
+        print_json_stats(out, &report->phases[p]);
+        sep = ", ";
+    }
+
+    fprintf(out, "}, \"passes\": {");
+    sep = "";
+    for (int k = 0; k < REPORT_MAX_PASSES; k++) {
+        if (!report->pass_names[k]) continue;
+        fprintf(out, "%s\"%s\": ", sep, report->pass_names[k]);
+        print_json_stats(out, &report->passes[k]);
+        sep = ", ";
+    }
+
+    fprintf(out, "}, \"total\": ");
+    print_json_stats(out, &report->total);
+    fprintf(out, ", \"units_wall_ms\": %.3f", report->units_wall_ms);
+    fprintf(out, ", \"counts\": {\"tokens\": %ld, \"ast_nodes\": %ld, \"symbols\": %ld, "
+            "\"ir_instructions\": %ld, \"ir_optimized\": %ld, \"asm_lines\": %ld}",
+            report->tokens, report->ast_nodes, report->symbols,
+            report->ir_instructions, report->ir_optimized, report->asm_lines);
+    fprintf(out, ", \"max_rss_kb\": %ld}", report->max_rss_kb);
+}